@@ -8,7 +8,7 @@ struct BEField {
 public:
     T val = 0;
 
-    operator T() {
+    operator T() const {
         return Helpers::bswap<T>(val);
     }
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHONKYSTATION3_X64
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// x86-64 builds only assume SSE2. Code using newer instructions is compiled with these attributes
+// and only called after checking the host CPU with the functions below
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define TARGET_SSSE3
+#define TARGET_SSE41
+#endif
+
+namespace CPUFeatures {
+
+// ECX of CPUID leaf 1
+inline unsigned int getFeatureBits() {
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 1);
+    return (unsigned int)regs[2];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return 0;
+    return ecx;
+#endif
+}
+
+inline bool hasSSSE3() { return getFeatureBits() & (1 << 9); }
+inline bool hasSSE41() { return getFeatureBits() & (1 << 19); }
+
+}   // End namespace CPUFeatures
+
+#endif
@@ -119,6 +119,7 @@ u64 Filesystem::read(u32 file_id, u32 buf_ptr, u64 size) {
         size_remaining -= to_read;
         cur_ptr += to_read;
     }
+    ps3->mem.markWritten(buf_ptr, bytes_read);
     
     return bytes_read;
 }
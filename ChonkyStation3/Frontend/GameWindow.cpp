@@ -95,7 +95,15 @@ void GameWindow::run(PlayStation3* ps3, bool is_rsx_replay) {
     controller = findController();
 
     ps3->setFlipHandler(std::bind(&GameWindow::flipHandler, this));
-    ps3->rsx.initGL();
+#ifdef CHONKYSTATION3_QT_BUILD
+    ps3->scheduler.setHandler(Scheduler::EventType::Breakpoint, [this](u64) { breakpoint(); });
+#endif
+    if (ps3->settings.gpu.rsx_thread && !is_rsx_replay) {
+        // The RSX thread owns the GL context from now on
+        SDL_GL_MakeCurrent(window, nullptr);
+        ps3->rsx.startThread([this]() { SDL_GL_MakeCurrent(window, context); }, std::bind(&GameWindow::present, this));
+    }
+    else ps3->rsx.initGL();
 
     if (!is_rsx_replay) {
         while (!quit) {
@@ -117,6 +125,9 @@ void GameWindow::run(PlayStation3* ps3, bool is_rsx_replay) {
         while (!quit) flipHandler();
     }
     
+    // Release the GL context before we destroy it
+    ps3->rsx.stopThread();
+    
 #if defined(CHONKYSTATION3_QT_BUILD) && defined(__APPLE__)
     QMetaObject::invokeMethod(main_window, "destroyGameWindow", Qt::AutoConnection);
 #else
@@ -136,7 +147,8 @@ void GameWindow::flipHandler() {
     }
     
     if (paused) {
-        pause(true);
+        // Flips from the RSX thread are delivered between PPU blocks, not in the middle of the store to put
+        pause(!ps3->rsx.threaded);
     }
 #endif
     
@@ -148,6 +160,18 @@ void GameWindow::flipHandler() {
     pollInput();
 #endif
 
+    // The RSX thread presents by itself
+    if (!ps3->rsx.threaded) SDL_GL_SwapWindow(window);
+}
+
+// Called from the RSX thread on every flip
+void GameWindow::present() {
+    const int swap_interval = vsync_enabled ? 1 : 0;
+    if (swap_interval != curr_swap_interval) {
+        SDL_GL_SetSwapInterval(swap_interval);
+        curr_swap_interval = swap_interval;
+    }
+
     SDL_GL_SwapWindow(window);
 }
 
@@ -169,8 +193,7 @@ void GameWindow::pause(bool handle_pc) {
     // word with update, the "update" part will happen *after* we unpause. Meaning that any instructions we step through while paused
     // won't have the correct state.
     // In 99% of cases it's going to be a plain STW so it's fine, but keep that in mind.
-    // This whole thing + the PC incrementing/decrementing won't be an issue when I put the RSX on its own thread
-    // (but, I'll have to rethink the way I handle pausing entirely...).
+    // None of this applies when the RSX runs on its own thread, the flip handler is then called between PPU blocks.
     if (handle_pc) ps3->ppu->state.pc += 4;
     
     while (true) {
@@ -198,7 +221,7 @@ void GameWindow::breakpoint() {
 }
 
 void GameWindow::breakOnNextInstr(u64 addr) {
-    ps3->scheduler.push(std::bind(&GameWindow::breakpoint, this), 0, "breakpoint");
+    ps3->scheduler.push(Scheduler::EventType::Breakpoint, 0);
     ps3->ppu->should_break = true;
 }
 
@@ -245,7 +268,8 @@ void GameWindow::updateWindow() {
             }
             else if (e.button.button == SDL_BUTTON_RIGHT) {
                 vsync_enabled = !vsync_enabled;
-                SDL_GL_SetSwapInterval(vsync_enabled ? 1 : 0);
+                // The RSX thread owns the context if it's running, it will pick this up on the next present
+                if (!ps3->rsx.threaded) SDL_GL_SetSwapInterval(vsync_enabled ? 1 : 0);
             }
             break;
         }
@@ -4,11 +4,11 @@
 
 #include <string>
 #include <format>
+#include <atomic>
 
 #ifdef CHONKYSTATION3_QT_BUILD
 #include <QtWidgets>
-#include <semaphore>    // semaphore and atomic are for pausing
-#include <atomic>
+#include <semaphore>    // semaphore is for pausing
 #endif
 
 #include <SDL.h>
@@ -24,6 +24,7 @@ public:
     void init();
     void run(PlayStation3* ps3, bool is_rsx_replay = false);
     void flipHandler();
+    void present();
     
     void createWindow();
     void updateWindow();
@@ -50,7 +51,8 @@ public:
 
     bool quit = false;
     bool fullscreen = false;
-    bool vsync_enabled = false;
+    std::atomic<bool> vsync_enabled = false;
+    int curr_swap_interval = 0;     // Only touched by whoever owns the GL context
     int frame_count = 0;
     double last_time = 0;
     double curr_time = 0;
@@ -2,6 +2,7 @@
 #include "PlayStation3.hpp"
 
 #include <memory>
+#include <xxhash.h>
 
 
 #ifdef _WIN32
@@ -18,6 +19,8 @@ static void strToBytes(std::string str, u8* out) {
     }
 }
 
+SELFToELF::SELFToELF(PlayStation3* ps3) : SELFToELF(ps3->fs, ps3->getCurrentUserHomeDir(), ps3->getCacheDir() / "ELF") {}
+
 int SELFToELF::makeELF(const fs::path& path, const fs::path& out_path) {
     auto path_str = path.generic_string();
     log("Loading SELF %s\n", path_str.c_str());
@@ -45,21 +48,7 @@ int SELFToELF::makeELF(const fs::path& path, const fs::path& out_path) {
     
     // Find NPDRM packet
     SupplementalHeader sup_header;
-    u64 cur_offs = ext_header.supplemental_hdr_offset;
-    bool found_npd_packet = false;
-    do {
-        seek(file, cur_offs, SEEK_SET);
-        std::fread(&sup_header, sizeof(SupplementalHeader), 1, file);
-        log("Supplemental header: type %d\n", (u64)sup_header.type);
-        // Check if supplemental header is of type NPDRM (3)
-        if (sup_header.type == 3) {
-            found_npd_packet = true;
-            break;
-        }
-        cur_offs += sup_header.size;
-    } while (sup_header.next);
-    
-    if (!found_npd_packet) {
+    if (!findNPD(file, ext_header, sup_header)) {
         Helpers::panic("SELFToELF: SELF %s does not have NPDRM (todo)\n", path_str.c_str());
     }
     
@@ -107,16 +96,15 @@ int SELFToELF::makeELF(const fs::path& path, const fs::path& out_path) {
     log("Content ID: %s\n", content_id);
     
     // Get RAP file path
-    const std::string rap_name = std::string((char*)content_id) + ".rap";
-    const fs::path rap_path = ps3->getCurrentUserHomeDir() / "exdata" / rap_name;
-    if (!ps3->fs.exists(rap_path)) {
+    const fs::path rap_path = getRAPPath(content_id);
+    if (!filesystem.exists(rap_path)) {
         log("Could not find license file for content %s\n", content_id);
         return -1;
     }
     log("Found license: %s\n", rap_path.generic_string().c_str());
     
     // Get NPDRM Key License from the RAP file
-    fs::path host_rap_path = ps3->fs.guestPathToHost(rap_path);
+    fs::path host_rap_path = filesystem.guestPathToHost(rap_path);
     FILE* rap_file = std::fopen(host_rap_path.generic_string().c_str(), "rb");
     if (!rap_file) {
         Helpers::panic("SELFToELF: Could not open license file %s\n", host_rap_path.generic_string().c_str());
@@ -325,6 +313,130 @@ int SELFToELF::makeELF(const fs::path& path, const fs::path& out_path) {
     return 0;
 }
 
+int SELFToELF::makeCachedELF(const fs::path& path, fs::path& out_path) {
+    // Entries are named <hash of the SELF path>-<hash of the SELF and its license>.elf
+    const auto path_str = path.generic_string();
+    const u64 path_hash = XXH3_64bits(path_str.data(), path_str.size());
+    const u64 hash = hashSELF(path);
+    const std::string prefix = std::format("{:016x}-", path_hash);
+    const std::string name = std::format("{}{:016x}.elf", prefix, hash);
+    
+    // Without a usable cache the ELF goes to the temporary directory, where it's overwritten the next time the same SELF is decrypted
+    auto makeUncachedELF = [&]() {
+        std::error_code ec;
+        const fs::path tmp_dir = fs::temp_directory_path(ec);
+        out_path = (ec ? path.parent_path() : tmp_dir) / ("ChonkyStation3-" + name);
+        log("Decrypting %s to %s\n", path_str.c_str(), out_path.generic_string().c_str());
+        return makeELF(path, out_path);
+    };
+    
+    std::error_code ec;
+    fs::create_directories(cache_dir, ec);
+    if (ec) {
+        log("Could not create %s (%s), the ELF cache is disabled\n", cache_dir.generic_string().c_str(), ec.message().c_str());
+        return makeUncachedELF();
+    }
+    
+    out_path = cache_dir / name;
+    if (fs::exists(out_path, ec)) {
+        log("Using cached ELF %s for %s\n", out_path.generic_string().c_str(), path_str.c_str());
+        return 0;
+    }
+    
+    // The SELF or its license changed, drop the old entries for it
+    std::vector<fs::path> stale;
+    for (auto it = fs::directory_iterator(cache_dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->path().filename().generic_string().starts_with(prefix))
+            stale.push_back(it->path());
+    }
+    for (auto& stale_path : stale) {
+        log("Removing stale cached ELF %s\n", stale_path.generic_string().c_str());
+        fs::remove(stale_path, ec);
+    }
+    
+    // Decrypt to a temporary file first so that we never leave a broken entry behind.
+    // makeELF can't recover from an output it can't open, so make sure the cache is writable first
+    const fs::path tmp_path = fs::path(out_path).replace_extension(".tmp");
+    FILE* tmp_file = std::fopen(tmp_path.generic_string().c_str(), "wb");
+    if (!tmp_file) {
+        log("Could not write to %s, the ELF cache is disabled\n", cache_dir.generic_string().c_str());
+        return makeUncachedELF();
+    }
+    std::fclose(tmp_file);
+    
+    if (int e = makeELF(path, tmp_path)) {
+        fs::remove(tmp_path, ec);
+        return e;
+    }
+    fs::rename(tmp_path, out_path, ec);
+    if (ec) {
+        // The decrypted ELF is fine, it just stays under its temporary name
+        log("Could not rename %s (%s)\n", tmp_path.generic_string().c_str(), ec.message().c_str());
+        out_path = tmp_path;
+    }
+    return 0;
+}
+
+u64 SELFToELF::hashSELF(const fs::path& path) {
+    XXH3_state_t* state = XXH3_createState();
+    XXH3_64bits_reset(state);
+    
+    auto hashFile = [&](const fs::path& file_path) {
+        FILE* file = std::fopen(file_path.generic_string().c_str(), "rb");
+        if (!file) return;
+        auto buf = std::make_unique<u8[]>(1_MB);
+        size_t n;
+        while ((n = std::fread(buf.get(), 1, 1_MB, file)))
+            XXH3_64bits_update(state, buf.get(), n);
+        std::fclose(file);
+    };
+    
+    hashFile(path);
+    
+    // The decrypted image depends on the license too
+    FILE* file = std::fopen(path.generic_string().c_str(), "rb");
+    if (file) {
+        CFHeader header;
+        ExtendedHeader ext_header;
+        SupplementalHeader sup_header;
+        seek(file, 0, SEEK_SET);
+        std::fread(&header, sizeof(CFHeader), 1, file);
+        std::fread(&ext_header, sizeof(ExtendedHeader), 1, file);
+        if (!std::strncmp((char*)&header.magic, "SCE\0", 4) && header.ext_header_size && ext_header.supplemental_hdr_offset && findNPD(file, ext_header, sup_header)) {
+            u8 content_id[0x31];
+            std::memset(content_id, 0, 0x31);
+            std::memcpy(content_id, sup_header.npd.content_id, 0x30);
+            const fs::path rap_path = getRAPPath(content_id);
+            if (filesystem.exists(rap_path))
+                hashFile(filesystem.guestPathToHost(rap_path));
+        }
+        std::fclose(file);
+    }
+    
+    const u64 hash = XXH3_64bits_digest(state);
+    XXH3_freeState(state);
+    return hash;
+}
+
+bool SELFToELF::findNPD(FILE* file, const ExtendedHeader& ext_header, SupplementalHeader& sup_header) {
+    u64 cur_offs = ext_header.supplemental_hdr_offset;
+    do {
+        seek(file, cur_offs, SEEK_SET);
+        std::fread(&sup_header, sizeof(SupplementalHeader), 1, file);
+        log("Supplemental header: type %d\n", (u64)sup_header.type);
+        // Check if supplemental header is of type NPDRM (3)
+        if (sup_header.type == 3) return true;
+        cur_offs += sup_header.size;
+    } while (sup_header.next);
+    
+    return false;
+}
+
+fs::path SELFToELF::getRAPPath(const u8* content_id) {
+    const std::string rap_name = std::string((char*)content_id) + ".rap";
+    return user_home_dir / "exdata" / rap_name;
+}
+
 void SELFToELF::SELFKey::getERK(u8* out) {
     strToBytes(erk, out);
 }
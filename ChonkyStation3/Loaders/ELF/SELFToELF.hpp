@@ -4,6 +4,7 @@
 #include <logger.hpp>
 #include <BEField.hpp>
 #include <elfio/elfio.hpp>
+#include <Filesystem/Filesystem.hpp>
 
 #include <charconv>
 
@@ -24,10 +25,14 @@ static constexpr u64 SELF_TYPE_NPDRM    = 8;
 
 class SELFToELF {
 public:
-    SELFToELF(PlayStation3* ps3) : ps3(ps3) {}
-    PlayStation3* ps3;
+    SELFToELF(PlayStation3* ps3);
+    // Licenses are looked up in user_home_dir on filesystem, decrypted images are cached in cache_dir
+    SELFToELF(Filesystem& filesystem, const fs::path& user_home_dir, const fs::path& cache_dir) : filesystem(filesystem), user_home_dir(user_home_dir), cache_dir(cache_dir) {}
     
     int makeELF(const fs::path& path, const fs::path& out_path);
+    // Same as makeELF, but the ELF is decrypted to the ELF cache and reused until the SELF or its license change.
+    // out_path is set to the path of the cached ELF. If the cache can't be written to, the ELF is decrypted to a temporary file instead
+    int makeCachedELF(const fs::path& path, fs::path& out_path);
     
     struct CFHeader {
         BEField<u32> magic;
@@ -294,5 +299,13 @@ public:
     };
     
 private:
+    Filesystem& filesystem;
+    fs::path user_home_dir;
+    fs::path cache_dir;
+    
+    u64 hashSELF(const fs::path& path);     // Hash of the SELF and of its license, if it has one
+    bool findNPD(FILE* file, const ExtendedHeader& ext_header, SupplementalHeader& sup_header);
+    fs::path getRAPPath(const u8* content_id);
+    
     MAKE_LOG_FUNCTION(log, loader_self);
 };
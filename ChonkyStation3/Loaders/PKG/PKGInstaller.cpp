@@ -58,16 +58,17 @@ void PKGInstaller::load(const fs::path& path) {
     delete[] metadata;
     
     // Decrypt file list
-    file_list = new PKGItemRecord[header.item_count];
+    file_list.resize(header.item_count);
     seek(file, header.data_offset, SEEK_SET);
-    std::fread(file_list, sizeof(PKGItemRecord) * header.item_count, 1, file);
+    std::fread(file_list.data(), sizeof(PKGItemRecord) * header.item_count, 1, file);
 
     //log("AES IV: ");
     //for (int i = 0; i < 16; i++)
     //    logNoPrefix("%02x", header.pkg_data_riv[i]);
     //logNoPrefix("\n");
     
-    plusaes::crypt_ctr((unsigned char*)file_list, sizeof(PKGItemRecord) * header.item_count, npdrm_pkg_ps3_key, 16, &header.pkg_data_riv);
+    plusaes::crypt_ctr((unsigned char*)file_list.data(), sizeof(PKGItemRecord) * header.item_count, npdrm_pkg_ps3_key, 16, &header.pkg_data_riv);
+    decryptFilenames(file);
 
     // Get PARAM.SFO
     Helpers::debugAssert(getFile("PARAM.SFO", "/dev_hdd1/"), "PKGInstaller: couldn't get PARAM.SFO");
@@ -84,8 +85,9 @@ void PKGInstaller::load(const fs::path& path) {
     std::fclose(file);
 }
 
-bool PKGInstaller::getFile(const fs::path& path, const fs::path& guest_out) {
-    FILE* file = std::fopen(pkg_path.generic_string().c_str(), "rb");
+void PKGInstaller::decryptFilenames(FILE* file) {
+    filenames.clear();
+    filenames.reserve(header.item_count);
     
     for (int i = 0; i < header.item_count; i++) {
         //log("File entry:\n");
@@ -95,29 +97,28 @@ bool PKGInstaller::getFile(const fs::path& path, const fs::path& guest_out) {
         //log("Data size      : %lld\n",   (u32)file_list[i].data_size);
         //log("Flags          : 0x%08x\n", (u32)file_list[i].data_size);
         
-        // Get filename
-        char* filename = new char[file_list[i].filename_size + 1];  // Add a null terminator to be safe
-        std::memset(filename, 0, file_list[i].filename_size + 1);
+        std::string filename(file_list[i].filename_size, '\0');
         seek(file, header.data_offset + file_list[i].filename_offset, SEEK_SET);
-        std::fread(filename, file_list[i].filename_size, 1, file);
+        std::fread(filename.data(), file_list[i].filename_size, 1, file);
         
         u8 iv[16];
         fixIV(header.pkg_data_riv, file_list[i].filename_offset, iv);
-        plusaes::crypt_ctr((u8*)filename, file_list[i].filename_size, npdrm_pkg_ps3_key, 16, &iv);
-
-        const auto file_path = fs::path(filename);
-        //log("%s\n", file_path.generic_string().c_str());
-        if (file_path == path) {
-            createFile(guest_out, file_list[i]);
-            delete[] filename;
-            std::fclose(file);
+        plusaes::crypt_ctr((u8*)filename.data(), file_list[i].filename_size, npdrm_pkg_ps3_key, 16, &iv);
+        
+        // Filenames might be padded with null terminators
+        filename.resize(std::strlen(filename.c_str()));
+        filenames.push_back(filename);
+    }
+}
+
+bool PKGInstaller::getFile(const fs::path& path, const fs::path& guest_out) {
+    for (int i = 0; i < header.item_count; i++) {
+        if (fs::path(filenames[i]) == path) {
+            createFile(guest_out, i);
             return true;
         }
-        
-        delete[] filename;
     }
     
-    std::fclose(file);
     return false;
 }
 
@@ -130,34 +131,146 @@ void PKGInstaller::getFileAsync(const fs::path& path, const fs::path& guest_out,
 
 bool PKGInstaller::install(std::function<void(float)> signal_progress) {
     Helpers::debugAssert(!pkg_path.empty(), "PKGInstaller: called install() before load()");
+    cancelled = false;
     
-    // TODO: Multithread this
-    
-    FILE* file = std::fopen(pkg_path.generic_string().c_str(), "rb");
-    fs::path install_dir = fs::path("/dev_hdd0/game") / title_id;
+    const fs::path install_dir = fs::path("/dev_hdd0/game") / title_id;
     log("Installing %s to %s...\n", content_id, install_dir.generic_string().c_str());
     
-    // Create files
+    // The package is extracted to a staging directory and only moved to install_dir once all of it was written,
+    // so that a cancelled or failed installation doesn't leave a broken game behind (or break the game a patch was being installed on)
+    const fs::path host_install_dir = ps3->fs.guestPathToHost(install_dir);
+    const fs::path staging_dir = ps3->fs.guestPathToHost(fs::path("/dev_hdd0/tmp/pkg_install") / title_id);
+    std::error_code ec;
+    fs::remove_all(staging_dir, ec);    // Left over from an installation that didn't finish
+    auto removeStaging = [&]() {
+        std::error_code remove_ec;
+        fs::remove_all(staging_dir, remove_ec);
+    };
+    fs::create_directories(staging_dir, ec);
+    if (ec) {
+        Helpers::panic("Failed to create %s (%s)\n", staging_dir.generic_string().c_str(), ec.message().c_str());
+    }
+    
+    // Create the directories and the empty files, then split the file data in jobs
+    std::vector<Job> jobs;
+    std::vector<fs::path> host_paths(header.item_count);
+    u64 total_size = 0;
     for (int i = 0; i < header.item_count; i++) {
-        // Get filename
-        char* filename = new char[file_list[i].filename_size + 1];  // Add a null terminator to be safe
-        std::memset(filename, 0, file_list[i].filename_size + 1);
-        seek(file, header.data_offset + file_list[i].filename_offset, SEEK_SET);
-        std::fread(filename, file_list[i].filename_size, 1, file);
+        host_paths[i] = staging_dir / filenames[i];
+        const auto& host_path = host_paths[i];
         
-        u8 iv[16];
-        fixIV(header.pkg_data_riv, file_list[i].filename_offset, iv);
-        plusaes::crypt_ctr((u8*)filename, file_list[i].filename_size, npdrm_pkg_ps3_key, 16, &iv);
-
-        createFile(install_dir, file_list[i]);
-        log(" [%d/%d] Created file %s\n", i + 1, (u32)header.item_count, filename);
-        delete[] filename;
+        // Check if it's a directory
+        if (file_list[i].flags & 4) {
+            fs::create_directories(host_path, ec);
+            if (ec) {
+                removeStaging();
+                Helpers::panic("Failed to create directory %s (%s)\n", host_path.generic_string().c_str(), ec.message().c_str());
+            }
+            log(" [%d/%d] Created directory %s\n", i + 1, (u32)header.item_count, filenames[i].c_str());
+            continue;
+        }
         
-        if (signal_progress)
-            signal_progress((i / (float)header.item_count) * 100.0f);
+        fs::create_directories(host_path.parent_path(), ec);
+        FILE* new_file = ec ? nullptr : std::fopen(host_path.generic_string().c_str(), "wb");
+        if (new_file) {
+            std::fclose(new_file);
+            fs::resize_file(host_path, file_list[i].data_size, ec);
+        }
+        if (!new_file || ec) {
+            removeStaging();
+            Helpers::panic("Failed to create file %s\n", host_path.generic_string().c_str());
+        }
+        log(" [%d/%d] Created file %s\n", i + 1, (u32)header.item_count, filenames[i].c_str());
+        
+        for (u64 offs = 0; offs < file_list[i].data_size; offs += JOB_SIZE)
+            jobs.push_back({ (u32)i, offs, std::min<u64>(JOB_SIZE, file_list[i].data_size - offs) });
+        total_size += file_list[i].data_size;
     }
     
-    std::fclose(file);
+    // Biggest jobs first, so that we don't end up waiting on a single worker at the end
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.size > b.size; });
+    
+    BufferPool pool;
+    std::atomic<size_t> next_job = 0;
+    std::atomic<u64> bytes_done = 0;
+    std::atomic<bool> failed = false;
+    std::string error;
+    std::mutex error_mutex;
+    
+    auto worker = [&]() {
+        // Every worker has its own handle to the package so that reads don't need to be synchronized
+        FILE* pkg = std::fopen(pkg_path.generic_string().c_str(), "rb");
+        auto buf = pool.acquire();
+        size_t idx;
+        while (pkg && !cancelled && !failed && (idx = next_job++) < jobs.size()) {
+            const Job& job = jobs[idx];
+            const auto& host_path = host_paths[job.item];
+            FILE* out = std::fopen(host_path.generic_string().c_str(), "r+b");
+            if (!out || !extract(pkg, out, job.item, job.offset, job.size, buf.get())) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                error = std::format("Failed to write file {}", host_path.generic_string());
+                failed = true;
+            }
+            if (out) std::fclose(out);
+            bytes_done += job.size;
+        }
+        
+        if (!pkg) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            error = std::format("Failed to open {}", pkg_path.generic_string());
+            failed = true;
+        }
+        else std::fclose(pkg);
+        pool.release(std::move(buf));
+    };
+    
+    const size_t n_workers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(jobs.size(), 1));
+    log("Decrypting %lld bytes with %d workers\n", total_size, (int)n_workers);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < n_workers; i++)
+        workers.emplace_back(worker);
+    
+    // Report progress while the workers are running
+    while (signal_progress && bytes_done < total_size && !cancelled && !failed) {
+        signal_progress((bytes_done / (float)total_size) * 100.0f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (auto& i : workers) i.join();
+    
+    if (failed) {
+        removeStaging();
+        Helpers::panic("PKGInstaller: %s\n", error.c_str());
+    }
+    if (cancelled) {
+        log("Installation cancelled\n");
+        removeStaging();
+        return false;
+    }
+    
+    // Move everything in place. Packages for a game that is already installed (patches) add to its files or replace them
+    if (!fs::exists(host_install_dir, ec)) {
+        fs::create_directories(host_install_dir.parent_path(), ec);
+        fs::rename(staging_dir, host_install_dir, ec);
+    }
+    else {
+        for (int i = 0; i < header.item_count && !ec; i++) {
+            const fs::path dst = host_install_dir / filenames[i];
+            if (file_list[i].flags & 4) {
+                fs::create_directories(dst, ec);
+                continue;
+            }
+            fs::create_directories(dst.parent_path(), ec);
+            if (!ec) fs::rename(host_paths[i], dst, ec);
+        }
+    }
+    if (ec) {
+        removeStaging();
+        Helpers::panic("PKGInstaller: failed to move the installed files to %s (%s)\n", host_install_dir.generic_string().c_str(), ec.message().c_str());
+    }
+    removeStaging();
+    
+    if (signal_progress)
+        signal_progress(100.0f);
     log("Installed successfully\n");
     return true;
 }
@@ -170,7 +283,20 @@ void PKGInstaller::installAsync(std::function<void(bool)> on_complete, std::func
 }
 
 void PKGInstaller::cancel() {
-    
+    cancelled = true;
+}
+
+std::unique_ptr<u8[]> PKGInstaller::BufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (buffers.empty()) return std::make_unique<u8[]>(BUFFER_SIZE);
+    auto buf = std::move(buffers.back());
+    buffers.pop_back();
+    return buf;
+}
+
+void PKGInstaller::BufferPool::release(std::unique_ptr<u8[]> buf) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers.push_back(std::move(buf));
 }
 
 void PKGInstaller::fixIV(u8* iv, u64 offset, u8* out_iv) {
@@ -185,26 +311,13 @@ void PKGInstaller::fixIV(u8* iv, u64 offset, u8* out_iv) {
     }
 }
 
-void PKGInstaller::createFile(fs::path path, PKGItemRecord& record) {
-    // Get filename
-    FILE* file = std::fopen(pkg_path.generic_string().c_str(), "rb");
-    char* filename = new char[record.filename_size + 1];  // Add a null terminator to be safe
-    std::memset(filename, 0, record.filename_size + 1);
-    seek(file, header.data_offset + record.filename_offset, SEEK_SET);
-    std::fread(filename, record.filename_size, 1, file);
-
-    u8 iv[16];
-    fixIV(header.pkg_data_riv, record.filename_offset, iv);
-    plusaes::crypt_ctr((u8*)filename, record.filename_size, npdrm_pkg_ps3_key, 16, &iv);
-
-    const auto guest_path = path / std::string(filename);
+void PKGInstaller::createFile(fs::path path, u32 item) {
+    const auto guest_path = path / filenames[item];
     const auto host_path = ps3->fs.guestPathToHost(guest_path);
-    delete[] filename;
     
     // Check if it's a directory
-    if (record.flags & 4) {
+    if (file_list[item].flags & 4) {
         fs::create_directories(host_path);
-        std::fclose(file);
         return;
     }
     
@@ -214,27 +327,39 @@ void PKGInstaller::createFile(fs::path path, PKGItemRecord& record) {
         Helpers::panic("Failed to create file %s\n", host_path.generic_string().c_str());
     }
     
-    u64 remaining_size = record.data_size;
-    for (int i = 0; i < record.data_size; i += BUFFER_SIZE) {
-        const auto buf_size = std::min<u64>(BUFFER_SIZE, remaining_size);
-        const u64 data_offs = record.data_offset + i;
-        remaining_size -= buf_size;
+    FILE* file = std::fopen(pkg_path.generic_string().c_str(), "rb");
+    auto buf = std::make_unique<u8[]>(BUFFER_SIZE);
+    const bool ok = extract(file, new_file, item, 0, file_list[item].data_size, buf.get());
+    std::fclose(new_file);
+    std::fclose(file);
+    
+    if (!ok) {
+        Helpers::panic("Failed to extract file %s\n", host_path.generic_string().c_str());
+    }
+}
+
+bool PKGInstaller::extract(FILE* pkg, FILE* out, u32 item, u64 offset, u64 size, u8* buf) {
+    const PKGItemRecord& record = file_list[item];
+    seek(out, offset, SEEK_SET);
+    
+    for (u64 i = 0; i < size; i += BUFFER_SIZE) {
+        if (cancelled) return true;
+        
+        const auto buf_size = std::min<u64>(BUFFER_SIZE, size - i);
+        const u64 data_offs = record.data_offset + offset + i;
         
         // Read the buffer
-        u8* buf = new u8[buf_size];
-        seek(file, header.data_offset + data_offs, SEEK_SET);
-        std::fread(buf, buf_size, 1, file);
+        seek(pkg, header.data_offset + data_offs, SEEK_SET);
+        if (std::fread(buf, buf_size, 1, pkg) != 1) return false;
         
         // Decrypt it
         u8 iv[16];
         fixIV(header.pkg_data_riv, data_offs, iv);
-        plusaes::crypt_ctr((u8*)buf, buf_size, npdrm_pkg_ps3_key, 16, &iv);
+        plusaes::crypt_ctr(buf, buf_size, npdrm_pkg_ps3_key, 16, &iv);
   
         // Write it
-        std::fwrite(buf, buf_size, 1, new_file);
-        delete[] buf;
+        if (std::fwrite(buf, buf_size, 1, out) != 1) return false;
     }
     
-    std::fclose(new_file);
-    std::fclose(file);
+    return true;
 }
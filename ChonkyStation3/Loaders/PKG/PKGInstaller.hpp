@@ -5,12 +5,18 @@
 #include <BEField.hpp>
 
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
 
 #include <plusaes/plusaes.hpp>
 
 
-// Each file will be split in buffers of this size, and only 1 buffer will be loaded in memory at once
+// Each file will be split in buffers of this size, every worker only has 1 buffer loaded in memory at once
 static constexpr size_t BUFFER_SIZE = 1_MB;
+// Files are split in jobs of this size. Thanks to AES-CTR every job can be decrypted independently
+static constexpr size_t JOB_SIZE = 16_MB;
 
 // Circular dependency
 class PlayStation3;
@@ -30,7 +36,7 @@ public:
     bool install(std::function<void(float)> signal_progress = nullptr);
     // Same as install but async
     void installAsync(std::function<void(bool)> on_complete, std::function<void(float)> signal_progress = nullptr);
-    // Cancel installation
+    // Cancel installation. install() will return false
     void cancel();
     
     struct PKGHeader {
@@ -70,13 +76,33 @@ public:
     
 private:
     PKGHeader header;
-    PKGItemRecord* file_list;
+    std::vector<PKGItemRecord> file_list;
+    std::vector<std::string> filenames;     // Decrypted once in load()
+    std::atomic<bool> cancelled = false;
     const u8 npdrm_pkg_ps3_key[16] =    { 0x2E, 0x7B, 0x71, 0xD7, 0xC9, 0xC9, 0xA1, 0x4E,
                                           0xA3, 0x22, 0x1F, 0x18, 0x88, 0x28, 0xB8, 0xF8 };
     
     
+    // Part of a file to be decrypted by a worker
+    struct Job {
+        u32 item;
+        u64 offset;     // Relative to the start of the file data
+        u64 size;
+    };
+    
+    // Buffers are reused by the workers for the whole installation
+    struct BufferPool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<u8[]>> buffers;
+        std::unique_ptr<u8[]> acquire();
+        void release(std::unique_ptr<u8[]> buf);
+    };
+    
     void fixIV(u8* iv, u64 offset, u8* out_iv);
-    void createFile(fs::path path, PKGItemRecord& record);
+    void decryptFilenames(FILE* file);
+    void createFile(fs::path path, u32 item);
+    // Decrypts size bytes of the data of item starting at offset and writes them to out at the same offset
+    bool extract(FILE* pkg, FILE* out, u32 item, u64 offset, u64 size, u8* buf);
     
     MAKE_LOG_FUNCTION(log, loader_pkg);
 };
@@ -45,6 +45,8 @@ PRXLibraryInfo PRXLoader::load(const fs::path& path, PRXExportTable& exports) {
             std::memcpy(ptr, seg->get_data(), file_size);
             // Set the remaining memory to 0
             std::memset(ptr + file_size, 0, mem_size - file_size);
+            // The memory might have been used by previously unloaded code
+            ps3->ppu->invalidateBlocks(entry->vaddr, mem_size);
             
             lib_info.segs.push_back({ entry->vaddr, type, file_size, mem_size });
         }
@@ -130,7 +132,7 @@ PRXLibraryInfo PRXLoader::load(const fs::path& path, PRXExportTable& exports) {
             const u32 addr = ps3->mem.read<u32>(module->addrs_ptr + i * sizeof(u32));
             ps3->module_manager.registerImport(addr, nid);
             log("* Imported function: 0x%08x @ 0x%08x \t[%s]\n", nid, addr, ps3->module_manager.getImportName(nid).c_str());
-            StubPatcher::patch(addr, ps3->module_manager.isForcedHLE(nid) ? false : (lle || user), ps3);
+            StubPatcher::patch(addr, nid, ps3->module_manager.isForcedHLE(nid) ? false : (lle || user), ps3);
         }
 
         if (module->size)
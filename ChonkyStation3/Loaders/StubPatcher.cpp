@@ -1,13 +1,16 @@
 #include "StubPatcher.hpp"
 
 
-void StubPatcher::patch(u32 addr, bool lle, PlayStation3* ps3) {
+void StubPatcher::patch(u32 addr, u32 nid, bool lle, PlayStation3* ps3) {
     // Patch import stub
     // There are 2 different kinds of stubs, one uses bcctr, the other bcctrl, both are patched using syscalls.
     // We patch LLE stubs with a syscall as well. The syscall will then redirect the PPU to the appropiate function export.
     // While this isn't optimal (we could just patch the stub to directly jump to the function), it allows me to easily track LLE function calls.
+    // Stubs that aren't shared also carry the import's dense index (see ModuleManager::import_table) above the stub type.
     bool stubbed = false;
     bool addr_in_r2 = false;
+    const u32 idx = ps3->module_manager.getImportIndex(nid);
+    const u32 encoded_idx = (idx < ModuleManager::STUB_INDEX_MAX) ? ((idx + 1) << ModuleManager::STUB_INDEX_SHIFT) : 0;
     for (int i = 0; i < 128; i += 4) {
         // Find BCCTR or BCCTRL instructions, and patch the stub accordingly to whether it's HLE or LLE
         const auto instr_raw = ps3->mem.read<u32>(addr + i);
@@ -16,6 +19,7 @@ void StubPatcher::patch(u32 addr, bool lle, PlayStation3* ps3) {
             if (!lle) {
                 u32 sc = 0x10;
                 if (addr_in_r2) sc += 0x2000;
+                else sc |= encoded_idx;
                 ps3->mem.write<u32>(addr + i - 4, 0x44000000 | sc);     // sc   (we check the low 16 bits to figure out the stub type)
                 ps3->mem.write<u32>(addr + i - 0, 0x4e800020);          // blr
                 stubbed = true;
@@ -23,6 +27,7 @@ void StubPatcher::patch(u32 addr, bool lle, PlayStation3* ps3) {
             else {
                 u32 sc = 0x1010;
                 if (addr_in_r2) sc += 0x2000;
+                else sc |= encoded_idx;
                 ps3->mem.write<u32>(addr + i - 4, 0x44000000 | sc);     // sc   (we check the low 16 bits to figure out the stub type)
                 ps3->mem.write<u32>(addr + i - 0, 0x4e800020);          // blr
                 stubbed = true;
@@ -33,12 +38,14 @@ void StubPatcher::patch(u32 addr, bool lle, PlayStation3* ps3) {
             if (!lle) {
                 u32 sc = 0x10;
                 if (addr_in_r2) sc += 0x2000;
+                else sc |= encoded_idx;
                 ps3->mem.write<u32>(addr + i - 0, 0x44000000 | sc);          // sc
                 stubbed = true;
             }
             else {
                 u32 sc = 0x1010;
                 if (addr_in_r2) sc += 0x2000;
+                else sc |= encoded_idx;
                 ps3->mem.write<u32>(addr + i - 0, 0x44000000 | sc);          // sc
                 stubbed = true;
             }
@@ -66,4 +73,5 @@ void StubPatcher::patch(u32 addr, bool lle, PlayStation3* ps3) {
         }
     }
     if (!stubbed) Helpers::panic("Couldn't patch stub\n");
+    ps3->ppu->invalidateBlocks(addr, 128);
 }
\ No newline at end of file
@@ -7,6 +7,6 @@
 
 namespace StubPatcher {
 
-void patch(u32 addr, bool lle, PlayStation3* ps3);
+void patch(u32 addr, u32 nid, bool lle, PlayStation3* ps3);
 
 }   // End namespace StubPatcher
\ No newline at end of file
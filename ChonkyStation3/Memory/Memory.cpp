@@ -1,5 +1,12 @@
 #include "Memory.hpp"
 
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
 
 //#define DISABLE_FASTMEM_FOR_ALLOCATED_MEM
 
@@ -7,38 +14,22 @@
 MemoryRegion::Block* MemoryRegion::allocPhys(size_t size, bool system) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
-    // Page alignment
-    size_t aligned_size = pageAlign(size);
-    // Find the next free block of memory big enough for the given size
-    u64 addr = 0;
-    while (true) {
-        auto next_block = findNextBlock(addr);
-        if (next_block.first) {
-            if (next_block.second->start - addr >= aligned_size) {
-                // addr OK
-                break;
-            }
-            else {
-                // Keep searching
-                addr = next_block.second->start + next_block.second->size;
-                if (addr >= RAM_SIZE)
-                    Helpers::panic("Out of memory\n");
-            }
-        }
-        else {
-            // addr OK
-            break;
-        }
-    }
-
-    // Did we run out of memory?
-    if (addr + aligned_size >= RAM_SIZE)
+    // Page alignment. Empty blocks would share their start with the next block, so allocate at least a page
+    size_t aligned_size = std::max(pageAlign(size), PAGE_SIZE);
+    // Find the smallest free range big enough for the given size
+    auto it = free_by_size.lower_bound({ aligned_size, 0 });
+    if (it == free_by_size.end())
         Helpers::panic("Out of memory\n");
 
-    // Allocate block
-    blocks.push_back({ addr, aligned_size, 0, system });
+    const auto [free_size, addr] = *it;
+    free_by_size.erase(it);
+    free_by_addr.erase(addr);
+    if (free_size > aligned_size)
+        insertFree(addr + aligned_size, free_size - aligned_size);
 
-    return &blocks.back();
+    // Allocate block
+    if (!system) used_size += aligned_size;
+    return &blocks.insert({ addr, { addr, aligned_size, 0, system } }).first->second;
 }
 
 // Allocates and maps size bytes of memory. Returns virtual address of allocated memory. Marks allocated area as fastmem. Optionally specify the lowest possible virtual address to allocate.
@@ -46,7 +37,7 @@ MemoryRegion::MapEntry* MemoryRegion::alloc(size_t size, u64 start_addr, bool sy
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
     // Page alignment
-    size_t aligned_size = pageAlign(size);
+    size_t aligned_size = std::max(pageAlign(size), PAGE_SIZE);
     // Allocate block of memory
     u64 paddr = allocPhys(aligned_size, system)->start;
 
@@ -57,7 +48,7 @@ MemoryRegion::MapEntry* MemoryRegion::alloc(size_t size, u64 start_addr, bool sy
 #endif
     
     // Map area
-    u64 vaddr = findNextAllocatableVaddr(size, start_addr, alignment);
+    u64 vaddr = findNextAllocatableVaddr(aligned_size, start_addr, alignment);
     MapEntry* entry = mmap(vaddr, paddr, aligned_size, fastmem);
 
     log("Allocated 0x%08llx bytes at 0x%016llx\n", aligned_size, vaddr);
@@ -75,58 +66,74 @@ bool MemoryRegion::canAlloc(size_t size) {
 void MemoryRegion::free(MemoryRegion::MapEntry* entry) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
-    // Get the block this entry is mapped to
+    // Get the block this entry is mapped to and free it
     auto block = findBlockFromAddr(entry->paddr);
-    // Free the block
-    freePhys(block.second);
+    if (block.first)
+        freePhys(block.second);
     // Remove map entry
-    for (int i = 0; i < map.size(); i++) {
-        if (map[i].vaddr == entry->vaddr) {
-            map.erase(map.begin() + i);
-            break;
-        }
-    }
+    unmap(entry->vaddr);
 }
 
 void MemoryRegion::freePhys(MemoryRegion::Block* block) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
+    const u64 start = block->start;
+    const u64 size = block->size;
+    if (!block->system) used_size -= size;
     // Remove block
-    for (int i = 0; i < blocks.size(); i++) {
-        if (blocks[i].start == block->start) {
-            blocks.erase(blocks.begin() + i);
-            break;
+    blocks.erase(start);
+    insertFree(start, size);
+}
+
+// Adds a range to the free list, merging it with the free ranges right before and after it.
+void MemoryRegion::insertFree(u64 start, u64 size) {
+    auto next = free_by_addr.lower_bound(start);
+    if (next != free_by_addr.end() && start + size == next->first) {
+        size += next->second;
+        free_by_size.erase({ next->second, next->first });
+        next = free_by_addr.erase(next);
+    }
+    if (next != free_by_addr.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == start) {
+            start = prev->first;
+            size += prev->second;
+            free_by_size.erase({ prev->second, prev->first });
+            free_by_addr.erase(prev);
         }
     }
+
+    free_by_addr[start] = size;
+    free_by_size.insert({ size, start });
 }
 
 // Returns whether the given physical address is part of an allocated memory block and, in case it is, returns the block info.
 std::pair<bool, MemoryRegion::Block*> MemoryRegion::findBlockFromAddr(u64 paddr) {
-    for (auto& i : blocks) {
-        if (Helpers::inRange<u32>(paddr, i.start, i.start + i.size - 1)) return { true, &i };
-    }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    // The only block which can contain paddr is the last one starting at or before it
+    auto it = blocks.upper_bound(paddr);
+    if (it == blocks.begin()) return { false, nullptr };
+    it--;
+    if (paddr - it->first < it->second.size) return { true, &it->second };
 
     return { false, nullptr };
 }
 
 // Returns whether there is an allocated memory block after the given physical address and, in case there is, returns the block info.
 std::pair<bool, MemoryRegion::Block*> MemoryRegion::findNextBlock(u64 start_addr) {
-    Block* block = nullptr;
-    for (auto& i : blocks) {
-        if (i.start >= start_addr) {
-            if (block == nullptr)
-                block = &i;
-            else if (i.start < block->start)
-                block = &i;
-        }
-    }
-
-    return { block != nullptr, block };
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    auto it = blocks.lower_bound(start_addr);
+    if (it == blocks.end()) return { false, nullptr };
+    return { true, &it->second };
 }
 
 // Returns whether there is an allocated block in the physical address space with the given handle and, in case there is, returns the block info.
 std::pair<bool, MemoryRegion::Block*> MemoryRegion::findBlockWithHandle(u64 handle) {
-    for (auto& i : blocks) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    for (auto& [start, i] : blocks) {
         if (i.handle == handle)
             return { true, &i };
     }
@@ -137,34 +144,24 @@ std::pair<bool, MemoryRegion::Block*> MemoryRegion::findBlockWithHandle(u64 hand
 void MemoryRegion::freeBlockWithHandle(u64 handle) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
-    // Get the block
     auto block = findBlockWithHandle(handle);
-    // Remove the block
-    for (int i = 0; i < blocks.size(); i++) {
-        if (blocks[i].start == block.second->start) {
-            blocks.erase(blocks.begin() + i);
-            break;
-        }
-    }
+    if (block.first)
+        freePhys(block.second);
 }
 
 // Returns whether there is a mapped area in the virtual address space after the given virtual address and, in case there is, returns the map info.
 std::pair<bool, MemoryRegion::MapEntry*> MemoryRegion::findNextMappedArea(u64 start_addr) {
-    MapEntry* map_entry = nullptr;
-    for (auto& i : map) {
-        if (i.vaddr >= start_addr) {
-            if (map_entry == nullptr)
-                map_entry = &i;
-            else if (i.vaddr < map_entry->vaddr)
-                map_entry = &i;
-        }
-    }
-
-    return { map_entry != nullptr, map_entry };
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    auto it = map.lower_bound(start_addr);
+    if (it == map.end()) return { false, nullptr };
+    return { true, &it->second };
 }
 
-// Returns the first available unmapped region in the virtual address space big enough to fit size bytes, or 0 if there is none.
+// Returns the first available unmapped region in the virtual address space big enough to fit size bytes.
 u64 MemoryRegion::findNextAllocatableVaddr(size_t size, u64 start_addr, u64 alignment) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
     auto align = [](u64 val, u64 alignment) -> u64 {
         return (val + alignment - 1) & ~(alignment - 1);
     };
@@ -173,35 +170,27 @@ u64 MemoryRegion::findNextAllocatableVaddr(size_t size, u64 start_addr, u64 alig
     vaddr = align(vaddr, alignment);
     u64 aligned_size = pageAlign(size);
 
-    // Find the next free area in the address map
-    //log("Searching allocateable area...\n");
-    while (true) {
-        auto next_area = findNextMappedArea(vaddr);
-        //log("0x%016llx (next area at 0x%016llx, spacing: 0x%016llx)...", vaddr, next_area.second->vaddr, next_area.second->vaddr - vaddr);
-        if (next_area.first) {
-            if (next_area.second->vaddr - vaddr >= aligned_size) {
-                // addr OK
-                break;
-            }
-            else {
-                // Keep searching
-                vaddr = next_area.second->vaddr + next_area.second->size;
-                vaddr = align(vaddr, alignment);
-                //log(" not ok\n");
-            }
-        }
-        else {
-            // addr OK
-            break;
-        }
+    // Skip the mapped area containing vaddr, if there is one
+    auto it = map.upper_bound(vaddr);
+    if (it != map.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second.size > vaddr)
+            vaddr = align(prev->first + prev->second.size, alignment);
+    }
+
+    // Walk the gaps between the following areas until one is big enough
+    for (; it != map.end(); it++) {
+        if (it->first >= vaddr && it->first - vaddr >= aligned_size) break;
+        vaddr = std::max(vaddr, align(it->first + it->second.size, alignment));
     }
-    //log(" ok\n");
     return vaddr;
 }
 
 // Returns whether there is a mapped area in the virtual address space with the given handle and, in case there is, returns the map info.
 std::pair<bool, MemoryRegion::MapEntry*> MemoryRegion::findMapEntryWithHandle(u64 handle) {
-    for (auto& i : map) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    for (auto& [vaddr, i] : map) {
         if (i.handle == handle)
             return { true, &i };
     }
@@ -213,9 +202,11 @@ std::pair<bool, MemoryRegion::MapEntry*> MemoryRegion::findMapEntryWithHandle(u6
 std::pair<bool, MemoryRegion::MapEntry*> MemoryRegion::isMapped(u64 vaddr) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
-    for (auto& i : map) {
-        if (Helpers::inRange<u32>(vaddr, i.vaddr, i.vaddr + i.size - 1)) return { true, &i };
-    }
+    // The only area which can contain vaddr is the last one starting at or before it
+    auto it = map.upper_bound(vaddr);
+    if (it == map.begin()) return { false, nullptr };
+    it--;
+    if (vaddr - it->first < it->second.size) return { true, &it->second };
 
     return { false, nullptr };
 }
@@ -232,7 +223,10 @@ MemoryRegion::MapEntry* MemoryRegion::mmap(u64 vaddr, u64 paddr, size_t size, bo
     // Page alignment
     size_t aligned_size = pageAlign(size);
 
-    map.push_back({ vaddr, paddr, aligned_size });
+    MapEntry* entry = &map.insert({ vaddr, { vaddr, paddr, aligned_size, 0 } }).first->second;
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    mem_manager.mapToArena(vaddr, fd, paddr, aligned_size);
+#endif
     
     // Fastmem
     if (fastmem) {
@@ -244,18 +238,19 @@ MemoryRegion::MapEntry* MemoryRegion::mmap(u64 vaddr, u64 paddr, size_t size, bo
         }
     }
     
-    return &map.back();
+    return entry;
 }
 
 // Unmaps the region starting at the given virtual address.
 void MemoryRegion::unmap(u64 vaddr) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     
-    for (int i = 0; i < map.size(); i++) {
-        if (map[i].vaddr == vaddr) {
-            map.erase(map.begin() + i);
-        }
-    }
+    auto it = map.find(vaddr);
+    if (it == map.end()) return;
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    mem_manager.unmapFromArena(vaddr, it->second.size);
+#endif
+    map.erase(it);
 }
 
 // Translates a virtual address.
@@ -274,14 +269,47 @@ u8* MemoryRegion::getPtrPhys(u64 paddr) {
     return &mem[paddr];
 }
 
+// Allocates the host memory backing this region.
+void MemoryRegion::createBacking() {
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    // The memory has to be a shared memory object so that we can map views of it into the arena
+#ifdef __linux__
+    fd = memfd_create("ChonkyStation3", 0);
+#else
+    char name[64];
+    std::snprintf(name, sizeof(name), "/ChonkyStation3-%d-%p", getpid(), this);
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    shm_unlink(name);
+#endif
+    if (fd < 0 || ftruncate(fd, size))
+        Helpers::panic("Failed to create shared memory for region 0x%08llx\n", (unsigned long long)virtual_base);
+    
+    // Shared memory objects are zero initialized
+    mem = (u8*)::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED)
+        Helpers::panic("Failed to map memory for region 0x%08llx\n", (unsigned long long)virtual_base);
+#else
+    mem = new u8[size];
+    // TODO: Figure out if games actually rely on uninitialized memory being initialized to 0.
+    // RPCS3 does initialize it to 0
+    std::memset(mem, 0, size);
+#endif
+}
+
+MemoryRegion::~MemoryRegion() {
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    munmap(mem, size);
+    close(fd);
+#else
+    delete[] mem;
+#endif
+}
+
 // Returns amount of available memory.
 u64 MemoryRegion::getAvailableMem() {
-    u64 size = 0;
-    for (auto& i : blocks) {
-        if (i.system) continue;
-        size += i.size;
-    }
-    return RAM_SIZE - system_size - size;
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    
+    return RAM_SIZE - system_size - used_size;
 }
 
 
@@ -297,17 +325,95 @@ std::pair<u64, u8*> Memory::addrToOffsetInMemory(u64 vaddr) {
 }
 
 // Marks a page of memory as fastmem
+// With the arena, ptr is always arena + the page's vaddr and isn't needed
 void Memory::markAsFastMem(u64 page, u8* ptr, bool r, bool w) {
-    if (r) read_table[page] = ptr;
-    if (w) write_table[page] = ptr;
+#ifndef CHONKYSTATION3_MEMORY_ARENA
+    // Published before the flags are cleared
+    if (r) std::atomic_ref<u8*>(read_table[page]).store(ptr, std::memory_order_relaxed);
+    if (w) std::atomic_ref<u8*>(write_table[page]).store(ptr, std::memory_order_relaxed);
+#endif
+    clearPageFlags(page, (r ? SLOW_READ : 0) | (w ? SLOW_WRITE : 0));
 }
 
 // Marks a page of memory as slowmem (removes it from the fastmem page table)
 void Memory::markAsSlowMem(u64 page, bool r, bool w) {
-    if (r) read_table[page] = 0;
-    if (w) write_table[page] = 0;
+    setPageFlags(page, (r ? SLOW_READ : 0) | (w ? SLOW_WRITE : 0));
+}
+
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+
+static Memory* arena_owner = nullptr;
+static struct sigaction old_sigsegv;
+static struct sigaction old_sigbus;
+
+// Runs in signal context, so this can only use async-signal-safe functions: no printf, no exceptions, no std::exit
+static void arenaFaultHandler(int sig, siginfo_t* info, void* ctx) {
+    const u8* addr = (const u8*)info->si_addr;
+    if (arena_owner && addr >= arena_owner->arena && addr < arena_owner->arena + Memory::ARENA_SIZE) {
+        const u64 vaddr = addr - arena_owner->arena;
+        char msg[] = "FATAL: Tried to access unmapped vaddr 0x0000000000000000\n";
+        char* digits = msg + sizeof(msg) - 3;   // Last hex digit, before the newline and the terminator
+        for (int i = 0; i < 16; i++)
+            digits[-i] = "0123456789abcdef"[(vaddr >> (i * 4)) & 0xf];
+        ssize_t written = ::write(STDERR_FILENO, msg, sizeof(msg) - 1);
+        (void)written;
+        // Returning retries the access, which now gets the default action so that a debugger or a core dump catches it
+        signal(sig, SIG_DFL);
+        return;
+    }
+    
+    // Not a guest access, forward it to the previous handler
+    const struct sigaction& old = (sig == SIGSEGV) ? old_sigsegv : old_sigbus;
+    if (old.sa_flags & SA_SIGINFO)
+        old.sa_sigaction(sig, info, ctx);
+    else if (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN)
+        old.sa_handler(sig);
+    else
+        signal(sig, SIG_DFL);   // Returning retries the access, which now crashes normally
+}
+
+void Memory::reserveArena() {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    arena = (u8*)::mmap(nullptr, ARENA_SIZE, PROT_NONE, flags, -1, 0);
+    if (arena == MAP_FAILED)
+        Helpers::panic("Failed to reserve the guest address space\n");
+    
+    if (!arena_owner) {
+        struct sigaction action = {};
+        action.sa_sigaction = arenaFaultHandler;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, &old_sigsegv);
+        sigaction(SIGBUS, &action, &old_sigbus);  // MacOS
+    }
+    arena_owner = this;
+}
+
+void Memory::mapToArena(u64 vaddr, int fd, u64 offset, size_t size) {
+    if (::mmap(&arena[vaddr], size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset) == MAP_FAILED)
+        Helpers::panic("Failed to map 0x%08llx bytes at vaddr 0x%016llx\n", (unsigned long long)size, (unsigned long long)vaddr);
+}
+
+void Memory::unmapFromArena(u64 vaddr, size_t size) {
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    if (::mmap(&arena[vaddr], size, PROT_NONE, flags, -1, 0) == MAP_FAILED)
+        Helpers::panic("Failed to unmap 0x%08llx bytes at vaddr 0x%016llx\n", (unsigned long long)size, (unsigned long long)vaddr);
 }
 
+Memory::~Memory() {
+    // The fault handler stays installed, it forwards everything once there is no arena
+    if (arena_owner == this) arena_owner = nullptr;
+    munmap(arena, ARENA_SIZE);
+}
+
+#else
+
 // Returns a pointer to the data at the specified virtual address
 u8* Memory::getPtr(u64 vaddr) {
     auto [offset, mem] = addrToOffsetInMemory(vaddr);
@@ -316,6 +422,10 @@ u8* Memory::getPtr(u64 vaddr) {
     return &mem[offset];
 }
 
+Memory::~Memory() {}
+
+#endif
+
 // Creates a reservation for the given virtual address.
 void Memory::reserveAddress(u64 vaddr) {
     reserveAddress(vaddr, 1, curr_thread_id);
@@ -364,33 +474,102 @@ bool Memory::isAddressReserved(u64 vaddr) {
     return reservations.contains(vaddr);
 }
 
+// Installs handlers for accesses to the given range. Regions must not overlap.
+void Memory::addMMIORegion(u64 start, u64 size, std::function<void(u64)> read, std::function<void(u64)> write) {
+    const bool r = (bool)read;
+    const bool w = (bool)write;
+    mmio_regions[start] = { start, size, std::move(read), std::move(write) };
+    
+    for (u64 page = start >> PAGE_SHIFT; page <= (start + size - 1) >> PAGE_SHIFT; page++) {
+        markAsSlowMem(page, r, w);
+        mmio_pages[page] = true;
+    }
+}
+
+// Returns the MMIO region containing the given address, or nullptr if there is none.
+Memory::MMIORegion* Memory::findMMIORegion(u64 vaddr) {
+    auto it = mmio_regions.upper_bound(vaddr);
+    if (it == mmio_regions.begin()) return nullptr;
+    it--;
+    if (vaddr - it->first < it->second.size) return &it->second;
+    return nullptr;
+}
+
+// Marks the 128-byte line containing addr as reserved.
+void Memory::reserveLockLine(u32 addr) {
+    if (isLockLineReserved(addr)) return;
+    lock_line_bitmap[addr >> (LOCK_LINE_SHIFT + 6)] |= 1ULL << ((addr >> LOCK_LINE_SHIFT) & 63);
+    if (reserved_lines[addr >> PAGE_SHIFT]++ == 0)
+        setPageFlags(addr >> PAGE_SHIFT, RESERVED);
+}
+
+// Marks the 128-byte line containing addr as no longer reserved.
+void Memory::releaseLockLine(u32 addr) {
+    if (!isLockLineReserved(addr)) return;
+    lock_line_bitmap[addr >> (LOCK_LINE_SHIFT + 6)] &= ~(1ULL << ((addr >> LOCK_LINE_SHIFT) & 63));
+    if (--reserved_lines[addr >> PAGE_SHIFT] == 0)
+        clearPageFlags(addr >> PAGE_SHIFT, RESERVED);
+}
+
+// Calls the reservation handler if a store to the given range touched a reserved lock line.
+void Memory::checkLockLines(u64 vaddr, u64 size) {
+    const u32 first = vaddr & ~(LOCK_LINE_SIZE - 1);
+    const u32 last = (vaddr + size - 1) & ~(LOCK_LINE_SIZE - 1);
+    if (isLockLineReserved(first) || (last != first && isLockLineReserved(last)))
+        reservation_handler(vaddr, size);
+}
+
+// Starts tracking writes to the pages in the given range.
+void Memory::trackWrites(u64 vaddr, u64 size) {
+    if (!size) return;
+    for (u64 page = vaddr >> PAGE_SHIFT; page <= (vaddr + size - 1) >> PAGE_SHIFT && page < PAGE_COUNT; page++)
+        setPageFlags(page, TRACKED);
+}
+
+// Reports a write to the given range done without going through write().
+void Memory::markWritten(u64 vaddr, u64 size) {
+    if (!size) return;
+    for (u64 page = vaddr >> PAGE_SHIFT; page <= (vaddr + size - 1) >> PAGE_SHIFT && page < PAGE_COUNT; page++) {
+        if (getPageFlags(page) & TRACKED) [[unlikely]]
+            pageWritten(page);
+    }
+}
+
+void Memory::pageWritten(u64 page) {
+    // Only the thread that clears the flag reports the write
+    if (!(clearPageFlags(page, TRACKED) & TRACKED)) return;
+    if (page_write_handler) page_write_handler(page);
+}
+
 template<typename T>
 T Memory::read(u64 vaddr) {
     const u64 page = vaddr >> PAGE_SHIFT;
-    const u64 offs = vaddr & PAGE_MASK;
 
-    u8* ptr = read_table[page];
     // Fastmem
-    if (ptr) {
+    if (!(getPageFlags(page) & SLOW_READ)) [[likely]] {
+        u8* ptr = fastReadPtr(vaddr);
 #ifndef __APPLE__
-        return Helpers::bswap<T>(*(T*)(&ptr[offs]));
+        return Helpers::bswap<T>(*(T*)ptr);
 #else
         // Avoid misaligned pointers on MacOS (might break on ARM)
         T data;
-        std::memcpy(&data, &ptr[offs], sizeof(T));
+        std::memcpy(&data, ptr, sizeof(T));
         return Helpers::bswap<T>(data);
 #endif
     }
     // Slowmem
     else {
-        auto [offset, mem] = addrToOffsetInMemory(vaddr);
-        Helpers::debugAssert(mem != nullptr, "Tried to read unmapped vaddr 0x%016llx\n", vaddr);
+        u8* mem = getPtr(vaddr);
         T data;
         
+        if (mmio_pages[page]) [[unlikely]] {
+            MMIORegion* region = findMMIORegion(vaddr);
+            if (region && region->read) region->read(vaddr);
+        }
         if (watchpoints_r.contains(vaddr))
             watchpoints_r[vaddr](vaddr);
 
-        std::memcpy(&data, &mem[offset], sizeof(T));
+        std::memcpy(&data, mem, sizeof(T));
         
 #ifdef TRACK_UNWRITTEN_READS
         auto check_data = [this](u32 addr, u64 data) {
@@ -424,29 +603,85 @@ void Memory::write(u64 vaddr, T data) {
     
     const u64 page = vaddr >> PAGE_SHIFT;
     const u64 offs = vaddr & PAGE_MASK;
+    const u8 flags = getPageFlags(page);
 
-    u8* ptr = write_table[page];
     // Fastmem
-    if (ptr) {
+    if (!(flags & (SLOW_WRITE | TRACKED | RESERVED)) && offs + sizeof(T) <= PAGE_SIZE) [[likely]] {
 #ifndef __APPLE__
-        *(T*)(&ptr[offs]) = data;
+        *(T*)fastWritePtr(vaddr) = data;
 #else
         // Avoid misaligned pointers on MacOS (might break on ARM)
-        std::memcpy(&ptr[offs], &data, sizeof(T));
+        std::memcpy(fastWritePtr(vaddr), &data, sizeof(T));
+#endif
+        return;
+    }
+
+    if (!(flags & SLOW_WRITE)) {
+#ifndef __APPLE__
+        *(T*)fastWritePtr(vaddr) = data;
+#else
+        std::memcpy(fastWritePtr(vaddr), &data, sizeof(T));
 #endif
     }
     // Slowmem
     else {
-        auto [offset, mem] = addrToOffsetInMemory(vaddr);
-        Helpers::debugAssert(mem != nullptr, "Tried to write unmapped vaddr 0x%016llx\n", vaddr);
-
-        std::memcpy(&mem[offset], &data, sizeof(T));
+        std::memcpy(getPtr(vaddr), &data, sizeof(T));
 
+        if (mmio_pages[page]) [[unlikely]] {
+            MMIORegion* region = findMMIORegion(vaddr);
+            if (region && region->write) region->write(vaddr);
+        }
         if (watchpoints_w.contains(vaddr))
             watchpoints_w[vaddr](vaddr);
     }
+    if (flags & TRACKED)
+        pageWritten(page);
+
+    // Stores crossing into the next page
+    u8 next_flags = 0;
+    if (offs + sizeof(T) > PAGE_SIZE) {
+        const u64 next_page = (page + 1) & (PAGE_COUNT - 1);
+        next_flags = getPageFlags(next_page);
+        if (next_flags & TRACKED) pageWritten(next_page);
+    }
+
+    if ((flags | next_flags) & RESERVED)
+        checkLockLines(vaddr, sizeof(T));
 }
 template void Memory::write(u64 vaddr, u8  data);
 template void Memory::write(u64 vaddr, u16 data);
 template void Memory::write(u64 vaddr, u32 data);
 template void Memory::write(u64 vaddr, u64 data);
+
+template<typename T>
+T Memory::readShared(u64 vaddr) {
+    T* ptr = (T*)getPtr(vaddr);
+    T data;
+    if (vaddr & (sizeof(T) - 1)) [[unlikely]]
+        std::memcpy(&data, ptr, sizeof(T));
+    else
+        data = std::atomic_ref<T>(*ptr).load(std::memory_order_acquire);
+    return Helpers::bswap<T>(data);
+}
+template u8  Memory::readShared(u64 vaddr);
+template u16 Memory::readShared(u64 vaddr);
+template u32 Memory::readShared(u64 vaddr);
+template u64 Memory::readShared(u64 vaddr);
+
+template<typename T>
+void Memory::writeShared(u64 vaddr, T data) {
+    data = Helpers::bswap<T>(data);
+    T* ptr = (T*)getPtr(vaddr);
+    if (vaddr & (sizeof(T) - 1)) [[unlikely]]
+        std::memcpy(ptr, &data, sizeof(T));
+    else
+        std::atomic_ref<T>(*ptr).store(data, std::memory_order_release);
+    
+    markWritten(vaddr, sizeof(T));
+    if ((getPageFlags(vaddr >> PAGE_SHIFT) | getPageFlags((u32)(vaddr + sizeof(T) - 1) >> PAGE_SHIFT)) & RESERVED) [[unlikely]]
+        checkLockLines(vaddr, sizeof(T));
+}
+template void Memory::writeShared(u64 vaddr, u8  data);
+template void Memory::writeShared(u64 vaddr, u16 data);
+template void Memory::writeShared(u64 vaddr, u32 data);
+template void Memory::writeShared(u64 vaddr, u64 data);
@@ -4,16 +4,26 @@
 #include <logger.hpp>
 
 #include <queue>
+#include <map>
+#include <set>
 #include <unordered_map>
 #include <functional>
 #include <optional>
 #include <mutex>
+#include <atomic>
 
 #include <MemoryConstants.hpp>
 
 // Logs addresses which are being read without ever being written to
 //#define TRACK_UNWRITTEN_READS
 
+// The whole 32-bit guest address space is reserved as one contiguous host range (the arena).
+// Mapped areas are mapped into it at arena + vaddr as views of their region's shared memory, so getPtr is a single add.
+// Everything else is PROT_NONE, accessing it faults and the fault handler reports the unmapped vaddr.
+#ifndef _WIN32
+#define CHONKYSTATION3_MEMORY_ARENA
+#endif
+
 class Memory;
 
 class MemoryRegion {
@@ -24,16 +34,16 @@ public:
         this->virtual_base = virtual_base;
         this->size = size;
         this->system_size = system_size;
-        mem = new u8[size];
-        // TODO: Figure out if games actually rely on uninitialized memory being initialized to 0.
-        // RPCS3 does initialize it to 0
-        std::memset(mem, 0, size);
+        insertFree(0, size);
+        createBacking();
     }
+    ~MemoryRegion();
 
     MAKE_LOG_FUNCTION(log, memory);
     
     Memory& mem_manager;
     u8* mem;
+    int fd = -1;    // Shared memory object backing mem, mapped into the arena
     u64 virtual_base;   // Base address of this region in the virtual address space
     u64 size;
     u64 system_size;
@@ -44,7 +54,7 @@ public:
         u64 handle;
         bool system;    // If the block was allocated by the OS it will not be counted when the game asks for available mem
     };
-    std::vector<Block> blocks;
+    std::map<u64, Block> blocks;    // Keyed by start. Entries don't move, pointers stay valid until the block is freed
 
     struct MapEntry {
         u64 vaddr;
@@ -52,7 +62,7 @@ public:
         size_t size;
         u64 handle;
     };
-    std::vector<MapEntry> map;
+    std::map<u64, MapEntry> map;    // Keyed by vaddr. Entries don't move, pointers stay valid until the area is unmapped
 
     Block* allocPhys(size_t size, bool system = false);
     MapEntry* alloc(size_t size, u64 start_addr = 0, bool system = false, u64 alignment = PAGE_SIZE);
@@ -74,23 +84,41 @@ public:
 
     u8* getPtrPhys(u64 paddr);
     u64 getAvailableMem();
+    void createBacking();
 
     void printAddressMap() {
-        for (auto& i : map) {
+        for (auto& [vaddr, i] : map) {
             printf("0x%016llx -> 0x%016llx\n", i.vaddr, i.vaddr + i.size - 1);
         }
     }
     
 private:
     std::recursive_mutex mutex;
+
+    // Free physical memory. Both indices always hold the same ranges, neighbouring ranges are merged when freeing.
+    // allocPhys takes the smallest range that fits (lowest address on ties)
+    std::map<u64, u64> free_by_addr;                // start -> size
+    std::set<std::pair<u64, u64>> free_by_size;     // { size, start }
+    u64 used_size = 0;  // Allocated bytes, excluding system blocks
+    void insertFree(u64 start, u64 size);
 };
 
 class Memory {
 public:
     Memory() {
+        page_flags.resize(PAGE_COUNT, SLOW_READ | SLOW_WRITE);
+#ifndef CHONKYSTATION3_MEMORY_ARENA
         read_table.resize(PAGE_COUNT, 0);
         write_table.resize(PAGE_COUNT, 0);
+#endif
+        lock_line_bitmap.resize((1ULL << (32 - LOCK_LINE_SHIFT)) / 64, 0);
+        reserved_lines.resize(PAGE_COUNT, 0);
+        mmio_pages.resize(PAGE_COUNT, 0);
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+        reserveArena();
+#endif
     }
+    ~Memory();
 
     // I don't explicitly check anywhere, but it is assumed that memory regions don't overlap.
     // Just be careful when creating them
@@ -101,12 +129,41 @@ public:
     std::vector<MemoryRegion*> regions = { &ram, &rsx, &stack, &raw_spu };
 
     std::pair<u64, u8*> addrToOffsetInMemory(u64 vaddr);
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    u8* getPtr(u64 vaddr) {
+        if (vaddr >> 32) [[unlikely]]
+            Helpers::panic("Tried to access unmapped vaddr 0x%016llx\n", vaddr);
+        return &arena[vaddr];
+    }
+    
+    static constexpr u64 ARENA_SIZE = 4_GB + PAGE_SIZE;  // Extra guard page for accesses crossing the end of the address space
+    u8* arena = nullptr;
+    void reserveArena();
+    void mapToArena(u64 vaddr, int fd, u64 offset, size_t size);
+    void unmapFromArena(u64 vaddr, size_t size);
+#else
     u8* getPtr(u64 vaddr);
+#endif
 
-    std::vector<u8*> read_table;
-    std::vector<u8*> write_table;
+    // Every page has a byte of flags. Accesses to pages without flags go straight to arena + vaddr, the others take the slow path
+    // (unmapped pages, watchpoints, MMIO, tracked writes) or also check the reserved lock lines.
+    // Flags are changed from other host threads (trackWrites runs on the RSX thread), they are only accessed atomically
+    enum PageFlags : u8 {
+        SLOW_READ   = 1 << 0,
+        SLOW_WRITE  = 1 << 1,
+        TRACKED     = 1 << 2,   // Writes to the page are being tracked
+        RESERVED    = 1 << 3,   // The page contains reserved lock lines
+    };
+    std::vector<u8> page_flags;
+    u8 getPageFlags(u64 page) { return std::atomic_ref<u8>(page_flags[page]).load(std::memory_order_acquire); }
+    bool isFastRead(u64 page) { return !(getPageFlags(page) & SLOW_READ); }
     void markAsFastMem(u64 page, u8* ptr, bool r, bool w);
     void markAsSlowMem(u64 page, bool r, bool w);
+#ifndef CHONKYSTATION3_MEMORY_ARENA
+    // Without the arena, fastmem pages also need their host pointer
+    std::vector<u8*> read_table;
+    std::vector<u8*> write_table;
+#endif
 
     MemoryRegion::Block* allocPhys(size_t size) { return ram.allocPhys(size); }
     MemoryRegion::MapEntry* alloc(size_t size, u64 start_addr = 0, bool system = false, u64 alignment = PAGE_SIZE) { return ram.alloc(size, start_addr, system, alignment); }
@@ -141,8 +198,24 @@ public:
     void setCurrentThreadID(u64 id) { curr_thread_id = id; }
     std::unordered_map<u64, Reservation> reservations;  // First u64 is the vaddr
 
+    // SPU lock line reservations (GETLLAR/PUTLLC)
+    // Reserved 128-byte lines are tracked in a bitmap over the whole address space, plus a count of reserved lines per page.
+    // Writes only look at the bitmap if their page has reserved lines, and call reservation_handler once per store
+    // touching a reserved line. Pages stay in fastmem.
+    static constexpr u64 LOCK_LINE_SHIFT = 7;
+    static constexpr u64 LOCK_LINE_SIZE = 1 << LOCK_LINE_SHIFT;
+    void reserveLockLine(u32 addr);
+    void releaseLockLine(u32 addr);
+    bool isLockLineReserved(u32 addr) { return lock_line_bitmap[addr >> (LOCK_LINE_SHIFT + 6)] & (1ULL << ((addr >> LOCK_LINE_SHIFT) & 63)); }
+    std::function<void(u64, u64)> reservation_handler;  // Called with the address and size of the store
+
     template<typename T> T read(u64 vaddr);
     template<typename T> void write(u64 vaddr, T data);
+    // Accesses from host threads other than the emulator thread (the RSX thread).
+    // They use atomic loads (acquire) and stores (release) on the backing memory and don't look at watchpoints or MMIO regions,
+    // stores still report tracked pages and reserved lock lines.
+    template<typename T> T readShared(u64 vaddr);
+    template<typename T> void writeShared(u64 vaddr, T data);
 
     // Memory watchpoints
     // Call a function when an address is read or written.
@@ -153,6 +226,29 @@ public:
     // For both reads and writes, the address being read/written is passed as an argument to the handler.
     std::unordered_map<u64, std::function<void(u64)>> watchpoints_r;
     std::unordered_map<u64, std::function<void(u64)>> watchpoints_w;
+
+    // MMIO regions
+    // Like watchpoints, but one pair of handlers covers a whole address range. Either handler can be empty.
+    // The pages of the region are taken out of fastmem for the accesses that have a handler,
+    // and slowmem accesses only look the region up if their page contains one.
+    struct MMIORegion {
+        u64 start;
+        u64 size;
+        std::function<void(u64)> read;      // Called before the read
+        std::function<void(u64)> write;     // Called after the write
+    };
+    void addMMIORegion(u64 start, u64 size, std::function<void(u64)> read, std::function<void(u64)> write);
+    MMIORegion* findMMIORegion(u64 vaddr);
+    std::map<u64, MMIORegion> mmio_regions;     // Keyed by start
+
+    // Page write tracking
+    // Tracked pages have the TRACKED flag, which takes their stores off the fast path. The first store to a tracked page clears it
+    // and calls page_write_handler with the page number, so the handler is called once per trackWrites call.
+    // Host code that writes guest memory through getPtr (DMA, HLE functions) has to call markWritten.
+    // trackWrites can be called from the RSX thread, the handler is called from the thread doing the write.
+    void trackWrites(u64 vaddr, u64 size);
+    void markWritten(u64 vaddr, u64 size);
+    std::function<void(u64)> page_write_handler;
     
 #ifdef TRACK_UNWRITTEN_READS
     std::unordered_map<u32, u64> written_addresses;
@@ -160,4 +256,21 @@ public:
     
 private:
     u64 curr_thread_id = 0;
+
+    std::vector<u64> lock_line_bitmap;
+    std::vector<u16> reserved_lines;    // Number of reserved lock lines in each page
+    std::vector<u8> mmio_pages;         // Whether each page contains an MMIO region
+    void pageWritten(u64 page);
+    void checkLockLines(u64 vaddr, u64 size);
+    void setPageFlags(u64 page, u8 flags) { std::atomic_ref<u8>(page_flags[page]).fetch_or(flags, std::memory_order_release); }
+    u8 clearPageFlags(u64 page, u8 flags) { return std::atomic_ref<u8>(page_flags[page]).fetch_and(~flags, std::memory_order_acq_rel); }
+
+    // Host pointers for the fast path
+#ifdef CHONKYSTATION3_MEMORY_ARENA
+    u8* fastReadPtr(u64 vaddr) { return &arena[vaddr]; }
+    u8* fastWritePtr(u64 vaddr) { return &arena[vaddr]; }
+#else
+    u8* fastReadPtr(u64 vaddr) { return &std::atomic_ref<u8*>(read_table[vaddr >> PAGE_SHIFT]).load(std::memory_order_relaxed)[vaddr & PAGE_MASK]; }
+    u8* fastWritePtr(u64 vaddr) { return &std::atomic_ref<u8*>(write_table[vaddr >> PAGE_SHIFT]).load(std::memory_order_relaxed)[vaddr & PAGE_MASK]; }
+#endif
 };
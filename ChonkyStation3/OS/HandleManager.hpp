@@ -1,9 +1,32 @@
 #pragma once
 
+#include <common.hpp>
 
+
+// Handles are handed out sequentially and never reused.
+// Every handle has a slot in a table indexed by (handle - HANDLE_BASE), the owner of the handle can store a pointer
+// to the object it names there so that lookups don't have to search.
 class HandleManager {
 public:
-    u32 next_handle = 0x100;
+    static constexpr u32 HANDLE_BASE = 0x100;
+    u32 next_handle = HANDLE_BASE;
+
+    u32 request() {
+        slots.push_back(nullptr);
+        return next_handle++;
+    }
+
+    void set(u64 handle, void* ptr) {
+        Helpers::debugAssert(handle >= HANDLE_BASE && handle < next_handle, "HandleManager: tried to set unrequested handle %d\n", handle);
+        slots[handle - HANDLE_BASE] = ptr;
+    }
+
+    // Returns nullptr if nothing was stored for the handle
+    void* lookup(u64 handle) {
+        if (handle < HANDLE_BASE || handle >= next_handle) return nullptr;
+        return slots[handle - HANDLE_BASE];
+    }
 
-    u32 request() { return next_handle++; }
-};
\ No newline at end of file
+private:
+    std::vector<void*> slots;
+};
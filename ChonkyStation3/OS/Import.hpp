@@ -2,8 +2,6 @@
 
 #include <common.hpp>
 
-#include <functional>
-
 #include <CellTypes.hpp>
 
 
@@ -11,9 +9,22 @@ using namespace CellTypes;
 
 class Import {
 public:
+    // HLE functions are plain function pointers taking the module object, so calls don't go through std::function
+    using Handler = u64 (*)(void* module);
+    struct BoundHandler {
+        Handler func = nullptr;
+        void* module = nullptr;
+    };
+
+    // Binds a member function of a module, e.g. Import::bind<&CellFs::cellFsOpen>(&cellFs)
+    template <auto F, typename T>
+    static BoundHandler bind(T* module) {
+        return { [](void* module) -> u64 { return (static_cast<T*>(module)->*F)(); }, module };
+    }
+
     Import() {}
-    Import(std::string name, std::function<u64(void)> const& handler, bool force_hle = false) : name(name), handler(handler), force_hle(force_hle) {}
+    Import(std::string name, BoundHandler handler, bool force_hle = false) : name(name), handler(handler), force_hle(force_hle) {}
     std::string name;
-    std::function<u64(void)> handler;
+    BoundHandler handler;
     bool force_hle;
-};
\ No newline at end of file
+};
@@ -10,6 +10,7 @@ class PlayStation3;
 class Lv2Base {
 public:
     Lv2Base(Lv2Object* obj);
+    virtual ~Lv2Base() = default;
 
     Lv2Object* obj;
     PlayStation3* ps3;
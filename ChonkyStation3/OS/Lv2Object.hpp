@@ -2,6 +2,10 @@
 
 #include <common.hpp>
 
+#include <memory>
+
+#include <Lv2Base.hpp>
+
 
 class PlayStation3;
 
@@ -13,11 +17,27 @@ public:
 
     template<typename T>
     void create() {
-        data = (void*)(new T(this));
+        T* obj = new T(this);
+        owner.reset(obj);
+        data = obj;
+        type = typeID<T>();
     }
 
     template<typename T>
-    T* get() { return (T*)data; }
-    
-    void* data;
+    T* get() {
+        Helpers::debugAssert(type == typeID<T>(), "Object with handle %d is not of the requested type\n", handle);
+        return (T*)data;
+    }
+
+private:
+    std::unique_ptr<Lv2Base> owner;
+    void* data = nullptr;   // Points to the object as its own type, Lv2 types derive virtually from Lv2Base so we can't downcast
+    const void* type = nullptr;
+
+    // Unique per type, compared instead of doing a dynamic_cast
+    template<typename T>
+    static const void* typeID() {
+        static const char id = 0;
+        return &id;
+    }
 };
\ No newline at end of file
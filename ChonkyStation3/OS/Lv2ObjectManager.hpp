@@ -2,6 +2,8 @@
 
 #include <common.hpp>
 
+#include <deque>
+
 #include <Lv2Object.hpp>
 #include <Lv2Base.hpp>
 #include <HandleManager.hpp>
@@ -12,42 +14,34 @@ class PlayStation3;
 
 class Lv2ObjectManager {
 public:
-    Lv2ObjectManager(PlayStation3* ps3, HandleManager* handle_manager) : ps3(ps3), handle_manager(handle_manager) {
-        // Avoid reallocations
-        objs.reserve(10240);
-    }
+    Lv2ObjectManager(PlayStation3* ps3, HandleManager* handle_manager) : ps3(ps3), handle_manager(handle_manager) {}
     PlayStation3* ps3;
     HandleManager* handle_manager;
 
     template<typename T> requires std::is_base_of_v<Lv2Base, T>
     T* create() {
         const auto handle = handle_manager->request();
-        Lv2Object new_obj = Lv2Object(handle, ps3);
-        objs.push_back(new_obj);
-        objs.back().create<T>();
+        Lv2Object& new_obj = objs.emplace_back(handle, ps3);
+        new_obj.create<T>();
+        handle_manager->set(handle, &new_obj);
 
         log("Created obj with handle %d\n", handle);
-        return objs.back().get<T>();
+        return new_obj.get<T>();
     };
 
     template<typename T> requires std::is_base_of_v<Lv2Base, T>
     T* get(u64 handle) {
-        for (auto& i : objs) {
-            if (i.handle == handle)
-                return i.get<T>();
-        }
-        Helpers::panic("Object with handle %d does not exist\n", handle);
+        Lv2Object* obj = (Lv2Object*)handle_manager->lookup(handle);
+        if (!obj)
+            Helpers::panic("Object with handle %d does not exist\n", handle);
+        return obj->get<T>();
     }
 
     bool exists(u64 handle) {
-        for (auto& i : objs) {
-            if (i.handle == handle)
-                return true;
-        }
-        return false;
+        return handle_manager->lookup(handle) != nullptr;
     }
 
-    std::vector<Lv2Object> objs;
+    std::deque<Lv2Object> objs;     // Objects don't move, Lv2Base and the handle slots point to them
 
 private:
     MAKE_LOG_FUNCTION(log, lv2_obj);
@@ -61,9 +61,6 @@ void Lv2EventQueue::send(Event event) {
             ps3->ppu->state.gprs[6] = event.data2;
             ps3->ppu->state.gprs[7] = event.data3;
             ps3->thread_manager.contextSwitch(*ps3->thread_manager.getThreadByID(curr_thread));
-            
-            // Cancel timeout events
-            ps3->scheduler.deleteAllEventsOfName(std::format("timeout {:d}", t->id));
         }
     }
 }
@@ -3,6 +3,7 @@
 #include <common.hpp>
 
 #include <unordered_map>
+#include <vector>
 #include <format>
 
 #include <Import.hpp>
@@ -47,7 +48,21 @@ public:
                                         cellAudioOut(ps3), cellNetCtl(ps3) {}
     PlayStation3* ps3;
 
+    // Imports get a dense index when their stub is patched. The index is encoded in the stub's sc instruction
+    // so module calls go straight to the resolved import without any lookups.
+    struct ImportSlot {
+        u32 nid;
+        Import::Handler handler;    // nullptr if the function isn't implemented
+        void* module;
+    };
+    static constexpr u32 STUB_INDEX_SHIFT = 16;
+    static constexpr u32 STUB_INDEX_MAX = 0x3ff;     // Index field is 10 bits wide, the encoded value is index + 1 (0 = not encoded)
+    std::vector<ImportSlot> import_table;
+    std::unordered_map<u32, u32> import_indices;    // nid -> index into import_table
+    u32 getImportIndex(u32 nid);
+
     void call(u32 nid);
+    void call(const ImportSlot& slot);
     void lle(u32 nid);
     // Map address to import nid
     void registerImport(u32 addr, u32 nid);
@@ -61,7 +76,7 @@ public:
 
     std::string getImportName(const u32 nid);
     bool isForcedHLE(const u32 nid);
-    std::string last_call;
+    u32 last_call_nid = 0;
 
     SysPrxForUser sysPrxForUser;
     SysThread sysThread;
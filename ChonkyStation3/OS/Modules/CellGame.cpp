@@ -33,6 +33,8 @@ u64 CellGame::cellGameContentPermit() {
     const std::string path_user = content_path + "/USRDIR\0\0";
     std::memcpy(ps3->mem.getPtr(content_info_dir_ptr), path.c_str(), path.length() + 1);
     std::memcpy(ps3->mem.getPtr(user_dir_ptr), path_user.c_str(), path_user.length() + 1);
+    ps3->mem.markWritten(content_info_dir_ptr, path.length() + 1);
+    ps3->mem.markWritten(user_dir_ptr, path_user.length() + 1);
 
     return CELL_OK;
 }
@@ -161,6 +163,7 @@ u64 CellGame::cellGameBootCheck() {
     if (dir_ptr) {
         const std::string path = content_path + "\0\0";
         std::memcpy(ps3->mem.getPtr(dir_ptr), path.c_str(), path.length() + 1);
+        ps3->mem.markWritten(dir_ptr, path.length() + 1);
     }
 
     if (size_ptr) {
@@ -168,6 +171,7 @@ u64 CellGame::cellGameBootCheck() {
         size->hdd_free = 1024 * 1024 * 1024;    // 1 GB
         size->size = -1;
         size->sys_size = 1024;  // ?
+        ps3->mem.markWritten(size_ptr, sizeof(CellGameContentSize));
     }
 
     return CELL_OK;
@@ -58,6 +58,7 @@ u64 CellGcmSys::cellGcmInitBody() {
     gcm_config.coreFreq = 500000000;
 
     std::memset(ps3->mem.getPtr(gcm_config.local_addr), 0, gcm_config.local_size);
+    ps3->mem.markWritten(gcm_config.local_addr, gcm_config.local_size);
 
     default_ctx_ptr = ctx_ptr;
     ctx_addr = ps3->mem.alloc(sizeof(CellGcmContextData), 0, true)->vaddr;
@@ -83,6 +84,7 @@ u64 CellGcmSys::cellGcmInitBody() {
     
     dma_ctrl_addr = ps3->mem.rsx.alloc(3_MB)->vaddr;
     std::memset(ps3->mem.getPtr(dma_ctrl_addr), 0, 3_MB);
+    ps3->mem.markWritten(dma_ctrl_addr, 3_MB);
     ctrl_addr = dma_ctrl_addr + 0x40;
     ctrl = (CellGcmControl*)ps3->mem.getPtr(ctrl_addr);
     ctrl->put = 0;
@@ -95,9 +97,8 @@ u64 CellGcmSys::cellGcmInitBody() {
     // Empty dummy reports area
     reports_addr = buffer_info_addr + sizeof(CellGcmDisplayInfo) * 8;
 
-    // Memory watchpoint to tell the RSX to check if there are commands to run when put is written
-    ps3->mem.watchpoints_w[ctrl_addr] = std::bind(&RSX::putWritten, &ps3->rsx, std::placeholders::_1);
-    ps3->mem.markAsSlowMem(ctrl_addr >> PAGE_SHIFT, false, true);   // Only need to make writes take the slow path
+    // MMIO write handler to tell the RSX to check if there are commands to run when put is written
+    ps3->mem.addMMIORegion(ctrl_addr, sizeof(u32), {}, std::bind(&RSX::putWritten, &ps3->rsx, std::placeholders::_1));   // Only need to make writes take the slow path
 
     label_addr = dma_ctrl_addr + 2_MB;
 
@@ -108,6 +109,7 @@ u64 CellGcmSys::cellGcmInitBody() {
     io_table_ptr = offset_table_addr;
     ea_table_ptr = offset_table_addr + 3072 * sizeof(u16);
     std::memset(ps3->mem.getPtr(offset_table_addr), 0xff, table_size); // The table is initialized to all FFs
+    ps3->mem.markWritten(offset_table_addr, table_size);
 
     for (u32 i = 0; i < (gcm_config.io_size >> 20); i++)
         mapEaIo(gcm_config.io_addr + (i << 20), i << 20);
@@ -122,6 +124,7 @@ u64 CellGcmSys::cellGcmInitBody() {
     };
     u32 vblank_thread_entry = ps3->mem.alloc(1_MB, 0, true)->vaddr; 
     std::memcpy(ps3->mem.getPtr(vblank_thread_entry), code, sizeof(code));
+    ps3->mem.markWritten(vblank_thread_entry, sizeof(code));
         
     auto thread = ps3->thread_manager.createThread(vblank_thread_entry, 1, 0, 0, (const u8*)"gcm_vblank_thread", 0, 0, 0);
     thread->state.pc = vblank_thread_entry;
@@ -369,8 +372,8 @@ u64 CellGcmSys::cellGcmSetWaitFlip() {
     const u32 mode = ARG0;
     log("cellGcmSetWaitFlip(mode: 0x%08x)\n", mode);
 
-    // A NOP because we don't have a multithreaded RSX.
-    // When this function is called, the RSX will have already flipped.
+    // A NOP. The RSX runs flips in order and waits for the GPU to finish them before moving on,
+    // so any command after this will already see the flip done.
     //ps3->thread_manager.getCurrentThread()->sleepForCycles(CPU_FREQ - ps3->curr_block_cycles - ps3->cycle_count);
     return CELL_OK;
 }
@@ -652,7 +655,8 @@ u64 CellGcmSys::cellGcmCallback() {
     ctrl->put = addressToOffset(ctx->current, ok);
     Helpers::debugAssert(ok, "cellGcmCallback: addressToOffset error\n");
     log("Flushing RSX command buffer up to offs 0x%08x\n", (u32)ctrl->put);
-    ps3->rsx.runCommandList();
+    // Wait for the RSX to be done with the buffers we are about to reuse
+    ps3->rsx.flush();
 
     // Find the next cmd buffer
     u32 new_begin;
@@ -63,9 +63,11 @@ u64 CellPngDec::cellPngDecDecodeData() {
             std::memcpy(&buf[i * ctrl->output_bytes_per_line], &img[i * actual_width], actual_width);
         }
         std::memcpy(ps3->mem.getPtr(data_ptr), buf.data(), buf.size());
+        ps3->mem.markWritten(data_ptr, buf.size());
     }
     else {
         std::memcpy(ps3->mem.getPtr(data_ptr), img.data(), img.size());
+        ps3->mem.markWritten(data_ptr, img.size());
     }
 
     out_info->status = 0;   // FINISHED
@@ -159,6 +159,9 @@ u64 CellSaveData::handleSaveDataOperation(fs::path savedata_path, u32 stat_cb_pt
             std::memset(ps3->mem.getPtr(res_ptr), 0, sizeof(CellSaveDataCBResult) - sizeof(u32));   // Don't clear the userdata
             std::memset(ps3->mem.getPtr(file_get_ptr + sizeof(u32)), 0, sizeof(CellSaveDataFileGet) - sizeof(u32)); // Don't clear exc_size
             std::memset(ps3->mem.getPtr(file_set_ptr), 0, sizeof(CellSaveDataFileSet));
+            ps3->mem.markWritten(res_ptr, sizeof(CellSaveDataCBResult) - sizeof(u32));
+            ps3->mem.markWritten(file_get_ptr + sizeof(u32), sizeof(CellSaveDataFileGet) - sizeof(u32));
+            ps3->mem.markWritten(file_set_ptr, sizeof(CellSaveDataFileSet));
             ARG0 = res_ptr;
             ARG1 = file_get_ptr;
             ARG2 = file_set_ptr;
@@ -316,6 +316,7 @@ u64 CellSpurs::_cellSpursWorkloadAttributeInitialize() {
     log("_cellSpursWorkloadAttributeInitialize(attr_ptr: 0x%08x, revision: 0x%08x, sdk_ver: 0x%08x, pm_ptr: 0x%08x, size: 0x%08x, data: 0x%016llx, prio_ptr: 0x%08x, min_cnt: %d, max_cnt: ???) UNIMPLEMENTED\n", attr_ptr, revision, sdk_ver, pm_ptr, size, data, prio_ptr, min_cnt);
     
     std::memset(ps3->mem.getPtr(attr_ptr), 0, sizeof(CellSpursWorkloadAttribute));
+    ps3->mem.markWritten(attr_ptr, sizeof(CellSpursWorkloadAttribute));
     CellSpursWorkloadAttribute* attr = (CellSpursWorkloadAttribute*)ps3->mem.getPtr(attr_ptr);
     attr->revision = revision;
     attr->sdk_ver = sdk_ver;
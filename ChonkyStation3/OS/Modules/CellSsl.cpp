@@ -52,6 +52,7 @@ u64 CellSsl::cellSslCertificateLoader() {
         Helpers::debugAssert(size >= buf.length(), "cellSslCertificateLoader(): buf is not big enough to fit certificates\n");
         std::memset(ps3->mem.getPtr(buf_ptr), 0, size);
         std::memcpy(ps3->mem.getPtr(buf_ptr), buf.c_str(), buf.size());
+        ps3->mem.markWritten(buf_ptr, size);
     }
 
     return CELL_OK;
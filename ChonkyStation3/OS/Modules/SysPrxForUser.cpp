@@ -149,6 +149,7 @@ u64 SysPrxForUser::sysMemset() {
     log("_sys_memset(dst: 0x%08x, val: 0x%08x, size: 0x%08x)\n", dst, val, size);
 
     std::memset(ps3->mem.getPtr(dst), val, size);
+    ps3->mem.markWritten(dst, size);
     return CELL_OK;
 }
 
@@ -159,6 +160,7 @@ u64 SysPrxForUser::sysMemcpy() {
     log("_sys_memcpy(dst: 0x%08x, src: 0x%08x, size: 0x%08x)\n", dst, src, size);
 
     std::memcpy(ps3->mem.getPtr(dst), ps3->mem.getPtr(src), size);
+    ps3->mem.markWritten(dst, size);
     return CELL_OK;
 }
 
@@ -66,13 +66,14 @@ PRXLibraryInfo PRXManager::getLib(u32 id) {
     return { .id = 0 };
 }
 
-bool PRXManager::loadModule(const fs::path& path, u32* id) {
+bool PRXManager::loadModule(const fs::path& path, u32* id, const fs::path& host_path) {
     PRXLoader loader = PRXLoader(ps3);
     PRXExportTable exports = ps3->module_manager.getExportTable();
     
     if (!isLibLoaded(path.filename().generic_string())) {
-        const fs::path lib_path = ps3->fs.guestPathToHost(path);
+        const fs::path lib_path = host_path.empty() ? ps3->fs.guestPathToHost(path) : host_path;
         auto lib = loader.load(lib_path, exports);
+        lib.filename = path.filename().generic_string();    // lib_path might be a cached ELF
         libs.push_back(lib);
         if (id) *id = lib.id;
         // Update export table
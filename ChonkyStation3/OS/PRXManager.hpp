@@ -32,7 +32,7 @@ public:
     bool isLibLoaded(const std::string name);
     PRXLibraryInfo getLib(u32 id);
     void require(const std::string name);
-    bool loadModule(const fs::path& path, u32* id = nullptr);  // Return true if the module was loaded
+    bool loadModule(const fs::path& path, u32* id = nullptr, const fs::path& host_path = {});  // Return true if the module was loaded. host_path overrides where the module is read from
     bool loadModules(); // Returns true if at least 1 module was loaded
     void loadModulesRecursively();
     void initializeLibraries();
@@ -2,6 +2,11 @@
 #include <Lv2Objects/Lv2SPUThreadGroup.hpp>
 #include "PlayStation3.hpp"
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPU_DMA_SSE2
+#endif
+
 
 SPUThread::SPUThread(PlayStation3* ps3, std::string name, bool is_raw, int raw_idx) : ps3(ps3), is_raw(is_raw), raw_idx(raw_idx) {
     id = ps3->handle_manager.request();
@@ -22,13 +27,14 @@ void SPUThread::init() {
     if (!is_raw) {
         log("Created SPU thread %d \"%s\"\n", id, name.c_str());
         ls = new u8[256_KB];
+        ls_dirty = new std::atomic<u64>(~0ULL);
     } else {
         Helpers::debugAssert(raw_idx >= 0 && raw_idx < 5, "Invalid Raw SPU index %d\n", raw_idx);
         
         log("Created Raw SPU thread %d \"%s\"\n", id, name.c_str());
         auto block = ps3->mem.raw_spu.allocPhys(RAW_SPU_OFFSET);
         const u32 ls_addr = RAW_SPU_MEM_START + RAW_SPU_OFFSET * raw_idx;
-        ps3->mem.raw_spu.mmap(ls_addr, block->start, RAW_SPU_OFFSET, false);
+        ps3->mem.raw_spu.mmap(ls_addr, block->start, RAW_SPU_OFFSET);
         log("Mapped LS at 0x%08x\n", ls_addr);
         ls = ps3->mem.getPtr(ls_addr);
         
@@ -36,11 +42,10 @@ void SPUThread::init() {
         problem_addr = ls_addr + RAW_SPU_PROBLEM_OFFSET;
         problem = ps3->mem.getPtr(problem_addr);
         log("Mapped Problem State memory at 0x%08x\n", problem_addr);
-        // Setup watchpoints
-        for (u32 addr = problem_addr; addr <= problem_addr + 0x1c00c; addr += 4) { // 0x1c00c is the highest known problem state offset
-            ps3->mem.watchpoints_r[addr] = std::bind(&SPUThread::readProblemState, this, std::placeholders::_1);
-            ps3->mem.watchpoints_w[addr] = std::bind(&SPUThread::writeProblemState, this, std::placeholders::_1);
-        }
+        // Problem State registers are MMIO, the LS stays in fastmem
+        ps3->mem.addMMIORegion(problem_addr, 0x1c00c + 4, // 0x1c00c is the highest known problem state offset
+                               std::bind(&SPUThread::readProblemState, this, std::placeholders::_1),
+                               std::bind(&SPUThread::writeProblemState, this, std::placeholders::_1));
         
         wait();
     }
@@ -49,6 +54,7 @@ void SPUThread::init() {
 }
 
 void SPUThread::reset() {
+    epoch++;
     state.pc = 0;
     for (auto& i : state.gprs) {
         i.dw[0] = 0;
@@ -57,6 +63,7 @@ void SPUThread::reset() {
     state.gprs[1].w[3] = 0x3fff0;   // Default stack pointer
     
     std::memset(ls, 0, 256_KB);
+    markLSWritten(ls_dirty, 0, 256_KB);
     while (in_mbox.size()) in_mbox.pop();
     while (out_mbox.size()) out_mbox.pop();
     reservation.addr = 0;
@@ -68,6 +75,14 @@ void SPUThread::reset() {
     tag_mask = 0;
     atomic_stat = 0;
     decrementer = 0;
+    if (dma_event) {
+        ps3->scheduler.cancel(dma_event);
+        dma_event = 0;
+    }
+    dma_queue.clear();
+    tag_pending.fill(0);
+    tag_update = TagUpdateImmediate;
+    waiting_tag_stat = false;
     waiting_in_mbox = false;
     waiting_out_mbox = false;
     event_stat.raw = 0;
@@ -85,6 +100,7 @@ void SPUThread::loadImage(sys_spu_image* img) {
         case SYS_SPU_SEGMENT_TYPE_COPY: {
             log("*  Loading segment %d type COPY\n", i);
             std::memcpy(&ls[segs[i].ls_addr], ps3->mem.getPtr(segs[i].src.addr), segs[i].size);
+            markLSWritten(ls_dirty, segs[i].ls_addr, segs[i].size);
             log("*  Copied segment from main[0x%08x - 0x%08x] to ls[0x%08x - 0x%08x]\n", (u32)segs[i].src.addr, segs[i].src.addr + segs[i].size, (u32)segs[i].ls_addr, segs[i].ls_addr + segs[i].size);
             break;
         }
@@ -92,6 +108,7 @@ void SPUThread::loadImage(sys_spu_image* img) {
         case SYS_SPU_SEGMENT_TYPE_FILL: {
             log("*  Loading segment %d type FILL\n", i);
             std::memset(&ls[segs[i].ls_addr], segs[i].src.addr, segs[i].size);
+            markLSWritten(ls_dirty, segs[i].ls_addr, segs[i].size);
             log("*  Filled segment at ls[0x%08x - 0x%08x] with 0x%02x\n", (u32)segs[i].ls_addr, segs[i].ls_addr + segs[i].size, segs[i].src.addr);
             break;
         }
@@ -109,6 +126,7 @@ void SPUThread::loadImage(sys_spu_image* img) {
 
     log("Entry point: 0x%08x\n", (u32)img->entry);
     state.pc = img->entry;
+    epoch++;
 
     /*
     std::string filename = std::format("ls{:d}.bin", id);
@@ -127,7 +145,7 @@ void SPUThread::setGroupID(u64 id) {
 }
 
 void SPUThread::reschedule() {
-    ps3->scheduler.push(std::bind(&SPUThreadManager::reschedule, &ps3->spu_thread_manager), 0, "spu thread reschedule");
+    ps3->scheduler.push(Scheduler::EventType::SPUThreadReschedule, 0);
 }
 
 void SPUThread::halt() {
@@ -138,7 +156,7 @@ void SPUThread::halt() {
 
 void SPUThread::sleep(u64 us) {
     const u64 cycles = Scheduler::uSecondsToCycles(us);
-    ps3->scheduler.push(std::bind(&SPUThread::wakeUp, this), cycles, "spu thread wakeup");
+    ps3->scheduler.push(Scheduler::EventType::SPUThreadWakeUp, cycles, (u64)this);
     status = ThreadStatus::Sleeping;
     reschedule();
     log("Sleeping SPU thread %d for %d us\n", id, us);
@@ -239,14 +257,13 @@ std::string SPUThread::channelToString(u32 ch) {
 }
 
 u32 SPUThread::readChannel(u32 ch) {
-    log("Read %s @ 0x%08x\n", channelToString(ch).c_str(), ps3->spu->state.pc);
+    log("Read %s @ 0x%08x\n", channelToString(ch).c_str(), ps3->spu_thread_manager.getSPU()->state.pc);
 
     switch (ch) {
     
     case SPU_RdEventStat: {
         if (!hasPendingEvents()) {
             wait();
-            ps3->mem.markAsSlowMem(reservation.addr >> PAGE_SHIFT, false, true);
             return 0;
         }
 
@@ -272,7 +289,16 @@ u32 SPUThread::readChannel(u32 ch) {
         return val;
     }
     case MFC_RdTagMask:     return tag_mask;
-    case MFC_RdTagStat:     return tag_mask;  // TODO
+    case MFC_RdTagStat: {
+        if (!isTagStatReady()) {
+            // Stall until the requested tag groups complete
+            waiting_tag_stat = true;
+            wait();
+            return 0;
+        }
+        tag_update = TagUpdateImmediate;
+        return completedTags() & tag_mask;
+    }
     case MFC_RdAtomicStat:  return atomic_stat;             
 
     default:
@@ -281,7 +307,7 @@ u32 SPUThread::readChannel(u32 ch) {
 }
 
 u32 SPUThread::readChannelCount(u32 ch) {
-    //log("Read cnt %s @ 0x%08x\n", channelToString(ch).c_str(), ps3->spu->state.pc);
+    //log("Read cnt %s @ 0x%08x\n", channelToString(ch).c_str(), ps3->spu_thread_manager.getSPU()->state.pc);
 
     switch (ch) {
 
@@ -290,7 +316,7 @@ u32 SPUThread::readChannelCount(u32 ch) {
     case SPU_WrOutIntrMbox: return 1;
 
     case MFC_WrTagUpdate:   return 1;
-    case MFC_RdTagStat:     return 1;
+    case MFC_RdTagStat:     return isTagStatReady();
 
     default:
         Helpers::panic("Unimplemented MFC channel count read %d\n", ch);
@@ -392,7 +418,7 @@ void SPUThread::writeChannel(u32 ch, u32 val) {
     case MFC_TagID:         tag_id      = val;  break;
     case MFC_Cmd:           doCmd(val);         break;
     case MFC_WrTagMask:     tag_mask    = val;  break;
-    case MFC_WrTagUpdate:   /* TODO */          break;
+    case MFC_WrTagUpdate:   tag_update  = val;  break;
 
     default:
         Helpers::panic("Unimplemented MFC channel write 0x%02x\n", ch);
@@ -404,77 +430,22 @@ void SPUThread::doCmd(u32 cmd) {
      
     case PUTF:
     case PUTB:
-    case PUT: {
-        log("PUT @ 0x%08x\n", ps3->spu->state.pc);
-        std::memcpy(ps3->mem.getPtr(eal), &ls[lsa & 0x3ffff], size);
-        break;
-    }
-
-    case PUTL: {
-        log("PUTL @ 0x%08x\n", ps3->spu->state.pc);
-        if (size == 0) break;
-        
-        const auto n_elements = size / sizeof(MFCListElement);
-        u32 ls_addr = lsa & 0x3fff0;
-        
-        // TODO: Stall bit
-        
-        log("Beginning list transfer (size: %d, n_elements: %d)\n", size, n_elements);
-        log("Starting LS addr: 0x%08x\n", ls_addr);
-        for (int i = 0; i < n_elements; i++) {
-            MFCListElement* elem = (MFCListElement*)&ls[(eal & 0x3fff8) + i * sizeof(MFCListElement)]; // For list commands EAL is an offset in LS
-            if (elem->ts) {
-                const u32 src = ls_addr | (elem->ea & 0xf);
-                const u32 dst = elem->ea;
-                log("mem[0x%08x] <- ls[0x%08x] size: %d\n", src, dst, (u32)elem->ts);
-                std::memcpy(ps3->mem.getPtr(dst), &ls[src], elem->ts);
-            }
-            ls_addr += elem->ts;
-            // TODO: Do I need to align ls_addr to 16 bytes again here?
-        }
-        
-        break;
-    }
-            
+    case PUT:
+    case PUTL:
     case GETF:
     case GETB:
-    case GET: {
-        log("GET @ 0x%08x\n", ps3->spu->state.pc);
-        std::memcpy(&ls[lsa & 0x3ffff], ps3->mem.getPtr(eal), size);
-        break;
-    }
-
+    case GET:
     case GETLB:
     case GETLF:
     case GETL: {
-        log("GETL @ 0x%08x\n", ps3->spu->state.pc);
-        if (size == 0) break;
-        
-        const auto n_elements = size / sizeof(MFCListElement);
-        u32 ls_addr = lsa & 0x3fff0;
-        
-        // TODO: Stall bit
-        
-        log("Beginning list transfer (size: %d, n_elements: %d)\n", size, n_elements);
-        log("Starting LS addr: 0x%08x\n", ls_addr);
-        for (int i = 0; i < n_elements; i++) {
-            MFCListElement* elem = (MFCListElement*)&ls[(eal & 0x3fff8) + i * sizeof(MFCListElement)]; // For list commands EAL is an offset in LS
-            if (elem->ts) {
-                const u32 dst = ls_addr | (elem->ea & 0xf);
-                const u32 src = elem->ea;
-                log("ls[0x%08x] <- mem[0x%08x] size: %d\n", dst, src, (u32)elem->ts);
-                std::memcpy(&ls[dst], ps3->mem.getPtr(src), elem->ts);
-            }
-            ls_addr += elem->ts;
-            // TODO: Do I need to align ls_addr to 16 bytes again here?
-        }
-        
+        queueDMA(cmd);
         break;
     }
 
     case PUTLLUC: {
-        log("PUTLLUC @ 0x%08x ", ps3->spu->state.pc);
+        log("PUTLLUC @ 0x%08x ", ps3->spu_thread_manager.getSPU()->state.pc);
         std::memcpy(ps3->mem.getPtr(eal), &ls[lsa & 0x3ffff], 128);
+        ps3->mem.markWritten(eal, 128);
         atomic_stat = 0;
         atomic_stat |= 2;   // PUTLLUC command completed
         reservation.addr = 0;
@@ -482,13 +453,14 @@ void SPUThread::doCmd(u32 cmd) {
     }
 
     case PUTLLC: {
-        log("PUTLLC @ 0x%08x ", ps3->spu->state.pc);
+        log("PUTLLC @ 0x%08x ", ps3->spu_thread_manager.getSPU()->state.pc);
 
         const bool success = ps3->spu_thread_manager.acquireReservation(eal);
 
         // Conditionally write
         if (success) {
             std::memcpy(ps3->mem.getPtr(eal), &ls[lsa & 0x3ffff], 128);
+            ps3->mem.markWritten(eal, 128);
         }
         reservation.addr = 0;
 
@@ -502,7 +474,7 @@ void SPUThread::doCmd(u32 cmd) {
     }
 
     case GETLLAR: {
-        log("GETLLAR @ 0x%08x\n", ps3->spu->state.pc);
+        log("GETLLAR @ 0x%08x\n", ps3->spu_thread_manager.getSPU()->state.pc);
         
         // Did we already have a reservation, and is it from the one we are reserving now?
         if (reservation.addr && (reservation.addr != eal)) {
@@ -511,6 +483,7 @@ void SPUThread::doCmd(u32 cmd) {
         
         // Copy data to local storage
         std::memcpy(&ls[lsa & 0x3ffff], ps3->mem.getPtr(eal), 128);
+        markLSWritten(ls_dirty, lsa, 128);
         
         // Update atomic stat
         atomic_stat = 0;            // It gets overwritten on every command
@@ -526,6 +499,167 @@ void SPUThread::doCmd(u32 cmd) {
     }
 }
 
+static bool isListCommand(u32 cmd) {
+    return cmd == SPUThread::PUTL || cmd == SPUThread::GETL || cmd == SPUThread::GETLB || cmd == SPUThread::GETLF;
+}
+
+// Bulk copy for DMA transfers. Transfers of 16 bytes or more are always a multiple of 16 bytes
+static void dmaCopy(u8* dst, const u8* src, u32 size) {
+#ifdef SPU_DMA_SSE2
+    if (size >= 16 && !(size & 15)) {
+        u32 i = 0;
+        for (; i + 64 <= size; i += 64) {
+            const __m128i a = _mm_loadu_si128((const __m128i*)&src[i +  0]);
+            const __m128i b = _mm_loadu_si128((const __m128i*)&src[i + 16]);
+            const __m128i c = _mm_loadu_si128((const __m128i*)&src[i + 32]);
+            const __m128i d = _mm_loadu_si128((const __m128i*)&src[i + 48]);
+            _mm_storeu_si128((__m128i*)&dst[i +  0], a);
+            _mm_storeu_si128((__m128i*)&dst[i + 16], b);
+            _mm_storeu_si128((__m128i*)&dst[i + 32], c);
+            _mm_storeu_si128((__m128i*)&dst[i + 48], d);
+        }
+        for (; i < size; i += 16)
+            _mm_storeu_si128((__m128i*)&dst[i], _mm_loadu_si128((const __m128i*)&src[i]));
+        return;
+    }
+#endif
+    std::memcpy(dst, src, size);
+}
+
+void SPUThread::queueDMA(u32 cmd) {
+    if (isListCommand(cmd) && size == 0) return;
+    
+    DMACommand dma = { cmd, lsa, eal, size, tag_id & 31 };
+    dma.list_lsa = lsa & 0x3fff0;
+    log("Queued DMA command 0x%02x (lsa: 0x%05x, eal: 0x%08x, size: 0x%x, tag: %d) @ 0x%08x\n", cmd, lsa, eal, size, dma.tag, ps3->spu_thread_manager.getSPU()->state.pc);
+    dma_queue.push_back(dma);
+    tag_pending[dma.tag]++;
+    scheduleDMA();
+}
+
+// Carries out the next step of the given transfer. Returns true once the whole transfer is done.
+bool SPUThread::transferDMA(DMACommand& dma, u32 max_elements) {
+    switch (dma.cmd) {
+    
+    case PUTF:
+    case PUTB:
+    case PUT: {
+        log("mem[0x%08x] <- ls[0x%05x] size: %d\n", dma.eal, dma.lsa & 0x3ffff, dma.size);
+        dmaCopy(ps3->mem.getPtr(dma.eal), &ls[dma.lsa & 0x3ffff], dma.size);
+        ps3->mem.markWritten(dma.eal, dma.size);
+        return true;
+    }
+
+    case GETF:
+    case GETB:
+    case GET: {
+        log("ls[0x%05x] <- mem[0x%08x] size: %d\n", dma.lsa & 0x3ffff, dma.eal, dma.size);
+        dmaCopy(&ls[dma.lsa & 0x3ffff], ps3->mem.getPtr(dma.eal), dma.size);
+        markLSWritten(ls_dirty, dma.lsa, dma.size);
+        return true;
+    }
+
+    default: {
+        // List transfer
+        const bool is_put = dma.cmd == PUTL;
+        const u32 n_elements = dma.size / sizeof(MFCListElement);
+        
+        // TODO: Stall bit
+        
+        for (u32 i = 0; i < max_elements && dma.list_idx < n_elements; i++, dma.list_idx++) {
+            MFCListElement* elem = (MFCListElement*)&ls[(dma.eal & 0x3fff8) + dma.list_idx * sizeof(MFCListElement)]; // For list commands EAL is an offset in LS
+            if (elem->ts) {
+                const u32 ls_addr = (dma.list_lsa | (elem->ea & 0xf)) & 0x3ffff;
+                if (is_put) {
+                    log("mem[0x%08x] <- ls[0x%05x] size: %d\n", (u32)elem->ea, ls_addr, (u32)elem->ts);
+                    dmaCopy(ps3->mem.getPtr(elem->ea), &ls[ls_addr], elem->ts);
+                    ps3->mem.markWritten(elem->ea, elem->ts);
+                } else {
+                    log("ls[0x%05x] <- mem[0x%08x] size: %d\n", ls_addr, (u32)elem->ea, (u32)elem->ts);
+                    dmaCopy(&ls[ls_addr], ps3->mem.getPtr(elem->ea), elem->ts);
+                    markLSWritten(ls_dirty, ls_addr, elem->ts);
+                }
+            }
+            dma.list_lsa += elem->ts;
+            // TODO: Do I need to align ls_addr to 16 bytes again here?
+        }
+        return dma.list_idx >= n_elements;
+    }
+    }
+}
+
+// Returns how long the next step of the given transfer takes.
+u64 SPUThread::getDMACycles(const DMACommand& dma) {
+    u64 bytes = dma.size;
+    if (isListCommand(dma.cmd)) {
+        bytes = 0;
+        const u32 n_elements = dma.size / sizeof(MFCListElement);
+        const u32 end = std::min(n_elements, dma.list_idx + DMA_LIST_ELEMENTS_PER_STEP);
+        for (u32 i = dma.list_idx; i < end; i++)
+            bytes += ((MFCListElement*)&ls[(dma.eal & 0x3fff8) + i * sizeof(MFCListElement)])->ts;
+    }
+    return DMA_LATENCY + bytes / DMA_BYTES_PER_CYCLE;
+}
+
+// Retires the command at the front of the queue.
+void SPUThread::completeDMA() {
+    tag_pending[dma_queue.front().tag]--;
+    dma_queue.pop_front();
+    
+    if (waiting_tag_stat && isTagStatReady()) {
+        waiting_tag_stat = false;
+        wakeUp();
+    }
+}
+
+void SPUThread::scheduleDMA() {
+    if (dma_event || dma_queue.empty()) return;
+    dma_event = ps3->scheduler.push(Scheduler::EventType::SPUDMAStep, getDMACycles(dma_queue.front()), (u64)this);
+}
+
+void SPUThread::stepDMA() {
+    // Called by the scheduler, which doesn't necessarily hold the lock
+    auto lock = ps3->spu_thread_manager.lock();
+    dma_event = 0;
+    if (dma_queue.empty()) return;
+    
+    if (transferDMA(dma_queue.front(), DMA_LIST_ELEMENTS_PER_STEP))
+        completeDMA();
+    scheduleDMA();
+}
+
+// Completes all queued transfers right away.
+void SPUThread::flushDMA() {
+    if (dma_event) {
+        ps3->scheduler.cancel(dma_event);
+        dma_event = 0;
+    }
+    
+    while (!dma_queue.empty()) {
+        transferDMA(dma_queue.front(), UINT32_MAX);
+        completeDMA();
+    }
+}
+
+// Returns a bit for each tag group which has no queued commands.
+u32 SPUThread::completedTags() {
+    u32 completed = 0;
+    for (int i = 0; i < 32; i++) {
+        if (!tag_pending[i]) completed |= 1 << i;
+    }
+    return completed;
+}
+
+// Returns whether the tag status channel can be read without stalling.
+bool SPUThread::isTagStatReady() {
+    const u32 completed = completedTags() & tag_mask;
+    switch (tag_update) {
+    case TagUpdateAny:  return completed || !tag_mask;
+    case TagUpdateAll:  return completed == tag_mask;
+    default:            return true;
+    }
+}
+
 void SPUThread::readProblemState(u32 addr) {
     const u32 offs = addr - problem_addr;
     u32 val = 0;
@@ -534,7 +668,7 @@ void SPUThread::readProblemState(u32 addr) {
             
     case MFC_CMDStatus_offs:    val = 0;    /* Status OK */     break;
     case MFC_QStatus_offs: {
-        const bool complete = true; // TODO
+        const bool complete = dma_queue.empty();
         const u16 free_space = 0xffff;
         val = (complete << 31) | free_space;
         break;
@@ -592,6 +726,8 @@ void SPUThread::writeProblemState(u32 addr) {
         u16 cmd = val & 0xffff;
         // TODO: class_id
         writeChannel(MFC_Cmd, cmd);
+        // The proxy tag status registers aren't emulated and always report completion, so finish the transfer now
+        flushDMA();
         break;
     }
     case Prxy_QueryType_offs: /* TODO */            break;
@@ -616,6 +752,7 @@ void SPUThread::writeProblemState(u32 addr) {
     case SPU_NPC_offs: {
         log("Set NPC: 0x%08x\n", val);
         state.pc = val;
+        epoch++;
         break;
     }
             
@@ -6,6 +6,8 @@
 #include <thread>
 #include <atomic>
 #include <queue>
+#include <deque>
+#include <array>
 
 #include <SPUTypes.hpp>
 #include <OS/Syscalls/sys_spu.hpp>
@@ -25,7 +27,11 @@ public:
     PlayStation3* ps3;
 
     SPUTypes::State state;
+    u32 epoch = 0;  // Incremented when the state is changed from outside the SPU, so that host threads know their copy is stale
     u8* ls;
+    // Pages of ls written since the SPU JIT last checked them (see SPUTypes::markLSWritten).
+    // Raw SPU LS is mapped in main memory where the PPU can write to it directly, so it isn't tracked and this is null
+    std::atomic<u64>* ls_dirty = nullptr;
     u8* problem;
     u32 problem_addr;
 
@@ -150,6 +156,39 @@ public:
     u32 atomic_stat = 0;
     u32 decrementer = 0;
 
+    // DMA
+    // Transfers are queued and carried out by a scheduler event after a delay depending on their size.
+    // List transfers move a few elements per event. Commands complete in the order they were issued, which also
+    // satisfies the fence and barrier variants.
+    struct DMACommand {
+        u32 cmd;
+        u32 lsa;
+        u32 eal;
+        u32 size;
+        u32 tag;
+        u32 list_idx = 0;   // Next element of a list transfer
+        u32 list_lsa = 0;   // LS address of the next element of a list transfer
+    };
+    static constexpr u64 DMA_LATENCY = 500;     // In cycles
+    static constexpr u64 DMA_BYTES_PER_CYCLE = 8;
+    static constexpr u32 DMA_LIST_ELEMENTS_PER_STEP = 16;
+    std::deque<DMACommand> dma_queue;
+    std::array<u32, 32> tag_pending = {};   // Number of queued commands in each tag group
+    u64 dma_event = 0;  // Scheduler handle of the next DMA step
+    
+    enum TagUpdate : u32 {
+        TagUpdateImmediate  = 0,
+        TagUpdateAny        = 1,
+        TagUpdateAll        = 2,
+    };
+    u32 tag_update = TagUpdateImmediate;
+    bool waiting_tag_stat = false;
+    u32 completedTags();
+    bool isTagStatReady();
+    void queueDMA(u32 cmd);
+    void stepDMA();     // Called by the scheduler
+    void flushDMA();
+
     std::queue<u32> in_mbox = {};
     std::queue<u32> out_mbox = {};
     bool waiting_in_mbox = false;
@@ -222,5 +261,10 @@ private:
     
     MAKE_LOG_FUNCTION(log, thread_spu);
 
+    bool transferDMA(DMACommand& dma, u32 max_elements);
+    u64 getDMACycles(const DMACommand& dma);
+    void completeDMA();
+    void scheduleDMA();
+
     u64 group_id;
 };
@@ -2,6 +2,8 @@
 #include "PlayStation3.hpp"
 
 
+thread_local SPUThreadManager::HostThread* SPUThreadManager::current_host_thread = nullptr;
+
 SPUThread* SPUThreadManager::createThread(std::string name, bool is_raw, int raw_idx) {
     threads.push_back({ ps3, name, is_raw, raw_idx });
     threads.back().init();
@@ -23,10 +25,12 @@ void SPUThreadManager::contextSwitch(SPUThread& thread) {
     
     ps3->spu->state = thread.state;
     ps3->spu->ls = thread.ls;
+    ps3->spu->ls_dirty = thread.ls_dirty;
     current_thread_id = thread.id;
 }
 
 SPUThread* SPUThreadManager::getCurrentThread() {
+    if (current_host_thread) return current_host_thread->thread;
     return getThreadByID(current_thread_id);
 }
 
@@ -42,6 +46,19 @@ SPUThread* SPUThreadManager::getThreadByID(u32 id) {
 }
 
 void SPUThreadManager::reschedule() {
+    // Host threads schedule themselves, just wake up the ones whose thread is running
+    if (threaded) {
+        for (auto& i : threads) {
+            if (i.status != SPUThread::ThreadStatus::Running) continue;
+            
+            if (!host_threads.contains(i.id))
+                startHostThread(i);
+            else
+                host_threads[i.id]->cv.notify_one();
+        }
+        return;
+    }
+    
     // No thread is currently active - find the first running thread and execute it
     if (current_thread_id == 0) {
         for (auto& i : threads) {
@@ -80,54 +97,66 @@ void SPUThreadManager::reschedule() {
 }
 
 void SPUThreadManager::createReservation(u32 addr) {
-    const auto id = current_thread_id;
+    const auto id = getCurrentThread()->id;
+    // A thread only holds one reservation at a time
+    if (reservation_map.contains(id) && reservation_map[id].addr != addr)
+        removeReservation(id);
+    
     reservation_map[id].addr = addr;
     std::memcpy(reservation_map[id].data, ps3->mem.getPtr(addr), 128);
-    
-    // Setup memory watchpoints
-    for (u32 curr_addr = addr; curr_addr < addr + 128; curr_addr++) {
-        ps3->mem.watchpoints_w[curr_addr] = std::bind(&SPUThreadManager::reservationWritten, this, std::placeholders::_1);
-        // Slowmem for writes (to trigger the watchpoints)
-        // We do this in the loop because the SPU could technically reserve an area that crosses page boundaries (although very unlikely to happen)
-        ps3->mem.markAsSlowMem(curr_addr >> PAGE_SHIFT, false, true);
-    }
+    // Stores to the line will call reservationWritten
+    ps3->mem.reserveLockLine(addr);
 }
 
 // Returns whether the reservation was acquired successfully
 bool SPUThreadManager::acquireReservation(u32 addr) {
-    const auto id = current_thread_id;
+    const auto id = getCurrentThread()->id;
     if (reservation_map.contains(id)) {
         if (reservation_map[id].addr != addr) {
-            reservation_map.erase(id);
+            removeReservation(id);
             return false;
         } else {
-            reservation_map.erase(id);
+            removeReservation(id);
             
             // Lose the reservation for any other threads that reserved the same address
             std::vector<u32> woken_up;
-            for (auto [other_id, reservation] : reservation_map) {
+            for (auto& [other_id, reservation] : reservation_map) {
                 if (addr == reservation.addr) {
-                    ps3->scheduler.push(std::bind(&SPUThread::sendLocklineLostEvent, getThreadByID(other_id)), 5000);
+                    ps3->scheduler.push(Scheduler::EventType::SPULocklineLost, 5000, (u64)getThreadByID(other_id));
                     //getThreadByID(other_id)->sendLocklineLostEvent();
                     woken_up.push_back(other_id);
                 }
             }
             
             for (auto i : woken_up) {
-                reservation_map.erase(i);
+                removeReservation(i);
             }
             return true;
         }
     } else return false;
 }
 
-void SPUThreadManager::reservationWritten(u64 vaddr) {
+// Removes the reservation of the given thread. The lock line is released once no other thread has it reserved.
+void SPUThreadManager::removeReservation(u32 id) {
+    auto it = reservation_map.find(id);
+    if (it == reservation_map.end()) return;
+    const u32 addr = it->second.addr;
+    reservation_map.erase(it);
+
+    for (auto& [other_id, reservation] : reservation_map) {
+        if (reservation.addr == addr) return;
+    }
+    ps3->mem.releaseLockLine(addr);
+}
+
+// Called by Memory after a store of size bytes at vaddr touched a reserved lock line.
+void SPUThreadManager::reservationWritten(u64 vaddr, u64 size) {
     std::vector<u32> woken_up;
-    for (auto [id, reservation] : reservation_map) {
-        if (Helpers::inRangeSized<u32>(vaddr, reservation.addr, 128)) {
+    for (auto& [id, reservation] : reservation_map) {
+        if (vaddr < reservation.addr + 128 && vaddr + size > reservation.addr) {
             // Check if the data changed
             if (std::memcmp(reservation.data, ps3->mem.getPtr(reservation.addr), 128)) {
-                ps3->scheduler.push(std::bind(&SPUThread::sendLocklineLostEvent, getThreadByID(id)), 10000);
+                ps3->scheduler.push(Scheduler::EventType::SPULocklineLost, 10000, (u64)getThreadByID(id));
                 //getThreadByID(id)->sendLocklineLostEvent();
                 woken_up.push_back(id);
             }
@@ -136,6 +165,94 @@ void SPUThreadManager::reservationWritten(u64 vaddr) {
     
     for (auto id : woken_up) {
         log("Lockline written, woke up thread %d\n", id);
-        reservation_map.erase(id);
+        removeReservation(id);
+    }
+}
+
+std::unique_lock<std::recursive_mutex> SPUThreadManager::lock() {
+    // Everything runs on the emulator thread if host threads are disabled.
+    // The RSX thread can also get here, when it writes to a reserved lock line
+    if (!threaded && !ps3->rsx.threaded) return std::unique_lock<std::recursive_mutex>(mutex, std::defer_lock);
+    return std::unique_lock<std::recursive_mutex>(mutex);
+}
+
+bool SPUThreadManager::hasRunningHostThreads() {
+    if (!threaded) return false;
+    
+    for (auto& i : threads) {
+        if (i.status == SPUThread::ThreadStatus::Running)
+            return true;
+    }
+    return false;
+}
+
+void SPUThreadManager::stopHostThreads() {
+    {
+        auto lock = this->lock();
+        for (auto& [id, host] : host_threads) {
+            host->exit = true;
+            host->cv.notify_one();
+        }
+    }
+    
+    for (auto& [id, host] : host_threads) {
+        if (!host->host.joinable()) continue;
+        // We can end up here from a host thread if it crashed
+        if (host->host.get_id() == std::this_thread::get_id())
+            host->host.detach();
+        else
+            host->host.join();
+    }
+}
+
+SPU* SPUThreadManager::getSPU() {
+    if (current_host_thread) return current_host_thread->spu.get();
+    return ps3->spu.get();
+}
+
+void SPUThreadManager::startHostThread(SPUThread& thread) {
+    auto host = std::make_unique<HostThread>();
+    host->thread = &thread;
+    host->spu = ps3->createSPU();
+    host->spu->enabled = true;
+    host->spu->on_host_thread = true;
+    
+    HostThread* ptr = host.get();
+    host_threads[thread.id] = std::move(host);
+    ptr->host = std::thread(&SPUThreadManager::hostThreadLoop, this, ptr);
+    log("Started host thread for thread %d \"%s\"\n", thread.id, thread.name.c_str());
+}
+
+void SPUThreadManager::hostThreadLoop(HostThread* host) {
+    current_host_thread = host;
+    SPUThread* thread = host->thread;
+    SPU* spu = host->spu.get();
+    
+    try {
+        auto lock = this->lock();
+        while (!host->exit) {
+            if (thread->status != SPUThread::ThreadStatus::Running) {
+                host->cv.wait(lock);
+                continue;
+            }
+            
+            // Run on our own copy of the state. The SPUThread state is always up to date while we don't hold the lock
+            const u32 epoch = thread->epoch;
+            spu->state = thread->state;
+            spu->ls = thread->ls;
+            spu->ls_dirty = thread->ls_dirty;
+            lock.unlock();
+            spu->step();
+            lock = this->lock();
+            
+            // Drop our copy if the state was changed from outside while we were running (the thread was reset, NPC was written...)
+            if (thread->epoch == epoch)
+                thread->state = spu->state;
+        }
+    }
+    catch (std::runtime_error e) {
+        printf("SPU thread %d \"%s\" crashed\n", thread->id, thread->name.c_str());
+        spu->printState();
+        ps3->printCrashInfo(e);
     }
 }
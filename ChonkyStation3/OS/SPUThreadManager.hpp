@@ -3,8 +3,13 @@
 #include <common.hpp>
 
 #include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <SPUThread.hpp>
+#include <SPU.hpp>
 
 
 // Circular dependency
@@ -33,9 +38,35 @@ public:
     };
     void createReservation(u32 addr);
     bool acquireReservation(u32 addr);
-    void reservationWritten(u64 vaddr);
+    void removeReservation(u32 id);
+    void reservationWritten(u64 vaddr, u64 size);
     std::unordered_map<u32, Reservation> reservation_map;   // first is thread id, 2nd is address
+    
+    // Host threads (Settings: CPU.SPUHostThreads)
+    // Every SPU thread gets its own host thread and SPU instance, and runs in parallel with the PPU.
+    // The mutex guards the state shared with the emulator thread: the emulator thread takes it for HLE calls, the scheduler
+    // and stores to reserved lines, SPU host threads take it at channel accesses (mailboxes, signal notifications, events, DMA)
+    // and when syncing their state with the SPUThread. Threads waiting on a channel sleep on cv until they are woken up.
+    struct HostThread {
+        SPUThread* thread;
+        std::unique_ptr<SPU> spu;
+        std::thread host;
+        std::condition_variable_any cv;
+        bool exit = false;
+    };
+    bool threaded = false;
+    std::unordered_map<u32, std::unique_ptr<HostThread>> host_threads;
+    std::recursive_mutex mutex;
+    static thread_local HostThread* current_host_thread;
+
+    std::unique_lock<std::recursive_mutex> lock();  // Doesn't lock anything if neither SPU host threads nor the RSX thread are enabled
+    bool hasRunningHostThreads();
+    void stopHostThreads();
+    SPU* getSPU();  // The SPU instance running the current thread
 
 private:
     MAKE_LOG_FUNCTION(log, thread_spu);
+
+    void startHostThread(SPUThread& thread);
+    void hostThreadLoop(HostThread* host);
 };
@@ -11,15 +11,23 @@ void Syscall::todo(std::string name) {
     ps3->ppu->state.gprs[3] = CELL_OK;;
 }
 
-void Syscall::doSyscall(bool decrement_pc_if_module_call) {
+void Syscall::doSyscall(u32 instr, bool decrement_pc_if_module_call) {
+    // HLE code can touch anything SPU host threads use
+    auto lock = ps3->spu_thread_manager.lock();
     const auto syscall_num = ps3->ppu->state.gprs[11];
 
-    const u16 stub = ps3->mem.read<u32>(ps3->ppu->state.pc) & 0xffff;
+    const u16 stub = instr & 0xffff;
+    // Dense import index encoded by the stub patcher, 0 if the stub doesn't carry one
+    const u32 encoded_idx = (instr >> ModuleManager::STUB_INDEX_SHIFT) & ModuleManager::STUB_INDEX_MAX;
     switch (stub) {
     // Module call
     case 0x10: {
         // Normally the stub does this to jump to the function (mtctr + bctr), I don't think it matters but to be sure I added this here
         ps3->ppu->state.ctr = ps3->ppu->state.gprs[0];
+        if (encoded_idx) {
+            ps3->module_manager.call(ps3->module_manager.import_table[encoded_idx - 1]);
+            return;
+        }
         // import addr is stored in r12
         ps3->module_manager.call(ps3->module_manager.imports[ps3->ppu->state.gprs[12]]);
         return;
@@ -33,6 +41,10 @@ void Syscall::doSyscall(bool decrement_pc_if_module_call) {
         return;
     }
     case 0x1010: {
+        if (encoded_idx) {
+            ps3->module_manager.lle(ps3->module_manager.import_table[encoded_idx - 1].nid);
+            return;
+        }
         ps3->module_manager.lle(ps3->module_manager.imports[ps3->ppu->state.gprs[12]]);
         return;
     }
@@ -23,7 +23,7 @@ public:
     MAKE_LOG_FUNCTION(unimpl, unimplemented);
     MAKE_LOG_FUNCTION(tty, tty);
 
-    void doSyscall(bool decrement_pc_if_module_call = false);
+    void doSyscall(u32 instr, bool decrement_pc_if_module_call = false);    // instr is the sc instruction word, module stubs encode their type and index in it
 
     void todo(std::string name);
     // sys_mmapper
@@ -65,17 +65,17 @@ u64 Syscall::sys_prx_load_module() {
 
     const fs::path host_path = ps3->fs.guestPathToHost(guest_path);
     const fs::path guest_prx_path = guest_path.parent_path() / (guest_path.stem().generic_string() + ".prx");
-    const fs::path host_prx_path  = ps3->fs.guestPathToHost(guest_prx_path);
+    fs::path host_prx_path = ps3->fs.guestPathToHost(guest_prx_path);
     
-    // Decrypt the SPRX
+    // Decrypt the SPRX (or get it from the ELF cache)
     SELFToELF self = SELFToELF(ps3);
-    int ret = self.makeELF(host_path, host_prx_path);
+    fs::path cached_prx_path;
+    if (self.makeCachedELF(host_path, cached_prx_path) == 0)
+        host_prx_path = cached_prx_path;
     
     // Load the library
     u32 id;
-    ps3->prx_manager.loadModule(guest_prx_path, &id);
-    if (ret == 0)
-        fs::remove(guest_prx_path);
+    ps3->prx_manager.loadModule(guest_prx_path, &id, host_prx_path);
     
     return id;
 }
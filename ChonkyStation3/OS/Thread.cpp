@@ -85,12 +85,12 @@ void Thread::finalizeArgsAndEnv() {
 // We put the reschedule on the scheduler instead of having it happen instantly because it would break
 // if a reschedule is called in the middle of an HLE function
 void Thread::reschedule(u64 cycles) {
-    mgr->ps3->scheduler.push(std::bind(&ThreadManager::reschedule, mgr), cycles, "thread reschedule");
+    mgr->ps3->scheduler.push(Scheduler::EventType::ThreadReschedule, cycles);
 }
 
 void Thread::sleep(u64 us) {
     const u64 cycles = Scheduler::uSecondsToCycles(us);
-    mgr->ps3->scheduler.push(std::bind(&Thread::wakeUp, this), cycles, "thread wakeup");
+    mgr->ps3->scheduler.push(Scheduler::EventType::ThreadWakeUp, cycles, (u64)this);
     status = ThreadStatus::Sleeping;
     reschedule();
     mgr->setAllHighPriority();
@@ -98,7 +98,7 @@ void Thread::sleep(u64 us) {
 }
 
 void Thread::sleepForCycles(u64 cycles) {
-    mgr->ps3->scheduler.push(std::bind(&Thread::wakeUp, this), cycles, "thread wakeup");
+    mgr->ps3->scheduler.push(Scheduler::EventType::ThreadWakeUp, cycles, (u64)this);
     status = ThreadStatus::Sleeping;
     reschedule();
     log("Sleeping thread %d for %lld cycles\n", id, cycles);
@@ -113,17 +113,23 @@ void Thread::wait(std::string wait_reason) {
 
 void Thread::timeout(u64 us) {
     const u64 cycles = Scheduler::uSecondsToCycles(us);
-    mgr->ps3->scheduler.push(std::bind(&Thread::timeoutEvent, this), cycles, std::format("timeout {:d}", id));
+    timeout_event = mgr->ps3->scheduler.push(Scheduler::EventType::ThreadTimeout, cycles, (u64)this);
     reschedule();
 }
 
 void Thread::timeoutEvent() {
+    timeout_event = 0;
     state.gprs[3] = CELL_ETIMEDOUT;
     log("Timed out, waking up\n");
     wakeUp();
 }
 
 void Thread::wakeUp() {
+    // Whatever we were waiting on with a timeout happened
+    if (timeout_event) {
+        mgr->ps3->scheduler.cancel(timeout_event);
+        timeout_event = 0;
+    }
     status = ThreadStatus::Running;
     wait_reason = "";
     reschedule();
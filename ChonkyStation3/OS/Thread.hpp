@@ -71,6 +71,7 @@ public:
     void wait(std::string wait_reason = "Not specified");
     void timeout(u64 us);
     void timeoutEvent();    // Scheduled by "timeout", called when the timeout happens
+    u64 timeout_event = 0;  // Scheduler handle of the pending timeout, cancelled on wakeUp
     void wakeUp();
     void join(u32 id, u32 vptr);
     void exit(u64 exit_status);
@@ -4,6 +4,7 @@
 
 Thread* ThreadManager::createThread(u64 entry, u64 stack_size, u64 arg, s32 prio, const u8* name, u32 tls_vaddr, u32 tls_filesize, u32 tls_memsize, bool is_start_thread, bool is_emulator_thread, std::string executable_path) {
     threads.push_back({ entry, stack_size, arg, prio, name, !is_emulator_thread ? next_thread_id++ : next_emu_thread_id++, tls_vaddr, tls_filesize, tls_memsize, this });
+    (is_emulator_thread ? emu_thread_slots : thread_slots).push_back(threads.size() - 1);
     // If this is the first thread we create, set
     // current_thread to point to this thread and initialize ppu
     if (is_start_thread) {
@@ -20,6 +21,7 @@ Thread* ThreadManager::createThread(u64 entry, u64 stack_size, u64 arg, s32 prio
         // argc and argv
         auto data = ps3->mem.alloc(1_MB);
         std::memcpy(ps3->mem.getPtr(data->vaddr), executable_path.c_str(), executable_path.length());
+        ps3->mem.markWritten(data->vaddr, executable_path.length());
 
         thread.addArg(data->vaddr);    // argv[0] should be executable path
         thread.finalizeArgs();
@@ -55,8 +57,7 @@ void ThreadManager::reschedule() {
     bool found_thread = false;
     //log("Rescheduling...\n");
 
-    int curr_thread = 0;
-    while (threads[curr_thread].id != getCurrentThread()->id) curr_thread++;
+    int curr_thread = getCurrentThread() - threads.data();
 
     do {
         Thread* switch_to = nullptr;
@@ -109,7 +110,7 @@ void ThreadManager::reschedule() {
 
             if (!found_low_prio) {
                 if (getCurrentThread()->status == Thread::ThreadStatus::Running) break;
-                else if (idle_thread_id && ps3->spu->enabled) {
+                else if (idle_thread_id && (ps3->spu->enabled || ps3->spu_thread_manager.hasRunningHostThreads())) {
                     contextSwitch(*getThreadByID(idle_thread_id));
                     break;
                 }
@@ -135,14 +136,15 @@ Thread* ThreadManager::getCurrentThread() {
 }
 
 Thread* ThreadManager::getThreadByID(u32 id) {
-    Thread* thread = nullptr;
-    for (auto& i : threads) {
-        if (i.id == id) {
-            thread = &i;
-            break;
-        }
+    if (id >= FIRST_THREAD_ID) {
+        if (id - FIRST_THREAD_ID < thread_slots.size())
+            return &threads[thread_slots[id - FIRST_THREAD_ID]];
+    }
+    else if (id >= FIRST_EMU_THREAD_ID) {
+        if (id - FIRST_EMU_THREAD_ID < emu_thread_slots.size())
+            return &threads[emu_thread_slots[id - FIRST_EMU_THREAD_ID]];
     }
-    return thread;
+    return nullptr;
 }
 
 u64 ThreadManager::allocateStack(u64 stack_size) {
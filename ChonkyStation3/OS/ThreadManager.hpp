@@ -40,6 +40,11 @@ public:
 
 private:
     MAKE_LOG_FUNCTION(log, thread);
-    u32 next_thread_id = 0x10000000;
-    u32 next_emu_thread_id = 0x1000;
+    static constexpr u32 FIRST_THREAD_ID = 0x10000000;
+    static constexpr u32 FIRST_EMU_THREAD_ID = 0x1000;
+    u32 next_thread_id = FIRST_THREAD_ID;
+    u32 next_emu_thread_id = FIRST_EMU_THREAD_ID;
+    // IDs are handed out sequentially, these map (id - first id) to the index of the thread in threads
+    std::vector<u32> thread_slots;
+    std::vector<u32> emu_thread_slots;
 };
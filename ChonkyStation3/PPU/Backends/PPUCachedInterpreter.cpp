@@ -0,0 +1,99 @@
+#include "PPUCachedInterpreter.hpp"
+#include <PlayStation3.hpp>
+
+
+using Instruction = PPUTypes::Instruction;
+
+int PPUCachedInterpreter::step() {
+    int cycles = 0;
+
+    do {
+        // Slowmem pages might have read watchpoints on them, fetch and decode every instruction like the normal interpreter does
+        if (!mem.isFastRead(state.pc >> PAGE_SHIFT)) {
+            interpretInstruction();
+            if (cycles++ > 2048) should_break = true;
+            continue;
+        }
+
+        runBlock(getBlock(state.pc), cycles);
+    } while (!should_break);
+
+    should_break = false;
+    return cycles;
+}
+
+void PPUCachedInterpreter::runBlock(const Block& block, int& cycles) {
+    const Entry* entries = block.entries.data();
+    const size_t n_entries = block.entries.size();
+    const u64 curr_generation = generation;
+
+    for (size_t i = 0; i < n_entries; i++) {
+        (this->*entries[i].handler)(entries[i].instr);
+        state.pc += 4;
+        if (cycles++ > 2048) should_break = true;
+        // Don't touch the block after it was invalidated
+        if (should_break || generation != curr_generation) break;
+    }
+}
+
+void PPUCachedInterpreter::interpretInstruction() {
+    const Instruction instr = { .raw = mem.read<u32>(state.pc) };
+    (this->*decode(instr, state.pc))(instr);
+    state.pc += 4;
+}
+
+PPUCachedInterpreter::Block& PPUCachedInterpreter::getBlock(u32 addr) {
+    auto it = blocks.find(addr);
+    if (it != blocks.end()) return it->second;
+
+    // Decode a new block
+    Block block;
+    block.start = addr;
+    block.entries.reserve(16);
+
+    u32 pc = addr;
+    const u64 page = addr >> PAGE_SHIFT;
+    while (block.entries.size() < MAX_BLOCK_SIZE) {
+        const Instruction instr = { .raw = mem.read<u32>(pc) };
+        block.entries.push_back({ decode(instr, pc), instr });
+        pc += 4;
+
+        // Don't cross page boundaries, the next page might not be in fastmem
+        if (isBlockEnd(instr) || (pc >> PAGE_SHIFT) != page) break;
+    }
+    block.end = pc;
+
+    log("Compiled block 0x%08x-0x%08x (%d instructions)\n", block.start, block.end, block.entries.size());
+    return blocks.emplace(addr, std::move(block)).first->second;
+}
+
+bool PPUCachedInterpreter::isBlockEnd(const Instruction& instr) {
+    switch (instr.opc) {
+    case BC:
+    case SC:
+    case B:
+        return true;
+    case G_13:
+        return instr.g_13_field == BCLR || instr.g_13_field == BCCTR;
+    default:
+        return false;
+    }
+}
+
+void PPUCachedInterpreter::invalidateBlocks(u32 addr, u32 size) {
+    const u32 end = addr + size;
+    for (auto it = blocks.begin(); it != blocks.end(); ) {
+        if (it->second.start < end && addr < it->second.end)
+            it = blocks.erase(it);
+        else
+            it++;
+    }
+    generation++;
+    log("Invalidated blocks in range 0x%08x-0x%08x\n", addr, end);
+}
+
+void PPUCachedInterpreter::invalidateAllBlocks() {
+    blocks.clear();
+    generation++;
+    log("Invalidated all blocks\n");
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <PPU/Backends/PPUInterpreter.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+
+// Circular dependency
+class PlayStation3;
+
+using namespace PPUTypes;
+
+// Interpreter which decodes each basic block once and caches the resulting handler pointers.
+// Blocks are keyed by guest PC and end on branches, syscalls, page boundaries or after MAX_BLOCK_SIZE instructions.
+// Pages which aren't in fastmem are always interpreted normally, so that read watchpoints placed on code
+// (exec breakpoints, LOG_LLE_FUNC_RESULT...) keep working.
+class PPUCachedInterpreter : public PPUInterpreter {
+public:
+    PPUCachedInterpreter(Memory& mem, PlayStation3* ps3) : PPUInterpreter(mem, ps3) {}
+    int step() override;
+    void invalidateBlocks(u32 addr, u32 size) override;
+    void invalidateAllBlocks() override;
+
+    static constexpr size_t MAX_BLOCK_SIZE = 256;
+
+    struct Entry {
+        Handler handler;
+        Instruction instr;
+    };
+
+    struct Block {
+        u32 start;
+        u32 end;    // Exclusive
+        std::vector<Entry> entries;
+    };
+    std::unordered_map<u32, Block> blocks;
+
+protected:
+    MAKE_LOG_FUNCTION(log, ppu_cache);
+
+    Block& getBlock(u32 addr);
+    bool isBlockEnd(const Instruction& instr);
+    void runBlock(const Block& block, int& cycles);
+    void interpretInstruction();    // Fetches, decodes and runs the instruction at pc without going through the cache
+
+    // Incremented every time blocks are invalidated.
+    // step() uses this to stop running a block if it was freed by one of its own instructions (i.e. a syscall loading a PRX)
+    u64 generation = 0;
+};
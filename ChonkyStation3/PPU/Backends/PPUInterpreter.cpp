@@ -57,368 +57,365 @@ int PPUInterpreter::step() {
 
 #endif
         
-        switch (instr.opc) {
-                
-            case G_04: {
-                switch (instr.g_04_field & 0x3f) {
-                        
-                    case VMADDFP:       vmaddfp(instr);     break;
-                    case VMHRADDSHS:    vmhraddshs(instr);  break;
-                    case VMLADDUHM:     vmladduhm(instr);   break;
-                    case VNMSUBFP:      vnmsubfp(instr);    break;
-                    case VMSUMSHM:      vmsumshm(instr);    break;
-                    case VSEL:          vsel(instr);        break;
-                    case VPERM:         vperm(instr);       break;
-                    case VSLDOI:        vsldoi(instr);      break;
-                        
-                    default:
-                        switch (instr.g_04_field) {
-                                
-                            case VCMPEQUB:  vcmpequb(instr);    break;
-                            case VADDFP:    vaddfp(instr);      break;
-                            case VADDUHM:   vadduhm(instr);     break;
-                            case VMULOUH:   vmulouh(instr);     break;
-                            case VSUBFP:    vsubfp(instr);      break;
-                            case VMRGHH:    vmrghh(instr);      break;
-                            case VADDUWM:   vadduwm(instr);     break;
-                            case VRLW:      vrlw(instr);        break;
-                            case VCMPEQUW_:
-                            case VCMPEQUW:  vcmpequw(instr);    break;
-                            case VMRGHW:    vmrghw(instr);      break;
-                            case VCMPEQFP_:
-                            case VCMPEQFP:  vcmpeqfp(instr);    break;
-                            case VSLB:      vslb(instr);        break;
-                            case VREFP:     vrefp(instr);       break;
-                            case VPKSHUS:   vpkshus(instr);     break;
-                            case VSLH:      vslh(instr);        break;
-                            case VMULOSH:   vmulosh(instr);     break;
-                            case VRSQRTEFP: vrsqrtefp(instr);   break;
-                            case VMRGLH:    vmrglh(instr);      break;
-                            case VSLW:      vslw(instr);        break;
-                            case VEXPTEFP:  vexptefp(instr);    break;
-                            case VMRGLW:    vmrglw(instr);      break;
-                            case VCMPGEFP_:
-                            case VCMPGEFP:  vcmpgefp(instr);    break;
-                            case VPKSWSS:   vpkswss(instr);     break;
-                            case VCMPGTUB_:
-                            case VCMPGTUB:  vcmpgtub(instr);    break;
-                            case VSPLTB:    vspltb(instr);      break;
-                            case VUPKHSB:   vupkhsb(instr);     break;
-                            case VCMPGTUH_:
-                            case VCMPGTUH:  vcmpgtuh(instr);    break;
-                            case VSPLTH:    vsplth(instr);      break;
-                            case VUPKHSH:   vupkhsh(instr);     break;
-                            case VSRW:      vsrw(instr);        break;
-                            case VCMPGTUW_:
-                            case VCMPGTUW:  vcmpgtuw(instr);    break;
-                            case VSPLTW:    vspltw(instr);      break;
-                            case VUPKLSB:   vupklsb(instr);     break;
-                            case VCMPGTFP_:
-                            case VCMPGTFP:  vcmpgtfp(instr);    break;
-                            case VRFIM:     vrfim(instr);       break;
-                            case VUPKLSH:   vupklsh(instr);     break;
-                            case VCFUX:     vcfux(instr);       break;
-                            case VSPLTISB:  vspltisb(instr);    break;
-                            case VADDSHS:   vaddshs(instr);     break;
-                            case VSRAH:     vsrah(instr);       break;
-                            case VMULESH:   vmulesh(instr);     break;
-                            case VCFSX:     vcfsx(instr);       break;
-                            case VSPLTISH:  vspltish(instr);    break;
-                            case VSRAW:     vsraw(instr);       break;
-                            case VCMPGTSW:  vcmpgtsw(instr);    break;
-                            case VCTUXS:    vctuxs(instr);      break;
-                            case VSPLTISW:  vspltisw(instr);    break;
-                            case VCTSXS:    vctsxs(instr);      break;
-                            case VAND:      vand(instr);        break;
-                            case VMAXFP:    vmaxfp(instr);      break;
-                            case VSUBUHM:   vsubuhm(instr);     break;
-                            case VANDC:     vandc(instr);       break;
-                            case VMINFP:    vminfp(instr);      break;
-                            case VSUBUWM:   vsubuwm(instr);     break;
-                            case VOR:       vor(instr);         break;
-                            case VNOR:      vnor(instr);        break;
-                            case MFVSCR:    mfvscr(instr);      break;
-                            case MTVSCR:    mtvscr(instr);      break;
-                            case VXOR:      vxor(instr);        break;
-                            case VSUM4SBS:  vsum4sbs(instr);    break;
-                            case VSUBSHS:   vsubshs(instr);     break;
-                            case VSUMSWS:   vsumsws(instr);     break;
-                                
-                            default:
-                                Helpers::panic("Unimplemented G_04 instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_04_field, (u32)instr.g_04_field, instr.raw, state.pc);
-                        }
-                }
-                break;
+        (this->*decode(instr, state.pc))(instr);
+        state.pc += 4;
+        if (cycles++ > 2048) should_break = true;
+    } while (!should_break);
+    
+    should_break = false;
+    return cycles;
+}
+
+PPUInterpreter::Handler PPUInterpreter::decode(const Instruction& instr, u32 pc) {
+    switch (instr.opc) {
+            
+        case G_04: {
+            switch (instr.g_04_field & 0x3f) {
+                    
+                case VMADDFP:       return &PPUInterpreter::vmaddfp;
+                case VMHRADDSHS:    return &PPUInterpreter::vmhraddshs;
+                case VMLADDUHM:     return &PPUInterpreter::vmladduhm;
+                case VNMSUBFP:      return &PPUInterpreter::vnmsubfp;
+                case VMSUMSHM:      return &PPUInterpreter::vmsumshm;
+                case VSEL:          return &PPUInterpreter::vsel;
+                case VPERM:         return &PPUInterpreter::vperm;
+                case VSLDOI:        return &PPUInterpreter::vsldoi;
+                    
+                default:
+                    switch (instr.g_04_field) {
+                            
+                        case VCMPEQUB:  return &PPUInterpreter::vcmpequb;
+                        case VADDFP:    return &PPUInterpreter::vaddfp;
+                        case VADDUHM:   return &PPUInterpreter::vadduhm;
+                        case VMULOUH:   return &PPUInterpreter::vmulouh;
+                        case VSUBFP:    return &PPUInterpreter::vsubfp;
+                        case VMRGHH:    return &PPUInterpreter::vmrghh;
+                        case VADDUWM:   return &PPUInterpreter::vadduwm;
+                        case VRLW:      return &PPUInterpreter::vrlw;
+                        case VCMPEQUW_:
+                        case VCMPEQUW:  return &PPUInterpreter::vcmpequw;
+                        case VMRGHW:    return &PPUInterpreter::vmrghw;
+                        case VCMPEQFP_:
+                        case VCMPEQFP:  return &PPUInterpreter::vcmpeqfp;
+                        case VSLB:      return &PPUInterpreter::vslb;
+                        case VREFP:     return &PPUInterpreter::vrefp;
+                        case VPKSHUS:   return &PPUInterpreter::vpkshus;
+                        case VSLH:      return &PPUInterpreter::vslh;
+                        case VMULOSH:   return &PPUInterpreter::vmulosh;
+                        case VRSQRTEFP: return &PPUInterpreter::vrsqrtefp;
+                        case VMRGLH:    return &PPUInterpreter::vmrglh;
+                        case VSLW:      return &PPUInterpreter::vslw;
+                        case VEXPTEFP:  return &PPUInterpreter::vexptefp;
+                        case VMRGLW:    return &PPUInterpreter::vmrglw;
+                        case VCMPGEFP_:
+                        case VCMPGEFP:  return &PPUInterpreter::vcmpgefp;
+                        case VPKSWSS:   return &PPUInterpreter::vpkswss;
+                        case VCMPGTUB_:
+                        case VCMPGTUB:  return &PPUInterpreter::vcmpgtub;
+                        case VSPLTB:    return &PPUInterpreter::vspltb;
+                        case VUPKHSB:   return &PPUInterpreter::vupkhsb;
+                        case VCMPGTUH_:
+                        case VCMPGTUH:  return &PPUInterpreter::vcmpgtuh;
+                        case VSPLTH:    return &PPUInterpreter::vsplth;
+                        case VUPKHSH:   return &PPUInterpreter::vupkhsh;
+                        case VSRW:      return &PPUInterpreter::vsrw;
+                        case VCMPGTUW_:
+                        case VCMPGTUW:  return &PPUInterpreter::vcmpgtuw;
+                        case VSPLTW:    return &PPUInterpreter::vspltw;
+                        case VUPKLSB:   return &PPUInterpreter::vupklsb;
+                        case VCMPGTFP_:
+                        case VCMPGTFP:  return &PPUInterpreter::vcmpgtfp;
+                        case VRFIM:     return &PPUInterpreter::vrfim;
+                        case VUPKLSH:   return &PPUInterpreter::vupklsh;
+                        case VCFUX:     return &PPUInterpreter::vcfux;
+                        case VSPLTISB:  return &PPUInterpreter::vspltisb;
+                        case VADDSHS:   return &PPUInterpreter::vaddshs;
+                        case VSRAH:     return &PPUInterpreter::vsrah;
+                        case VMULESH:   return &PPUInterpreter::vmulesh;
+                        case VCFSX:     return &PPUInterpreter::vcfsx;
+                        case VSPLTISH:  return &PPUInterpreter::vspltish;
+                        case VSRAW:     return &PPUInterpreter::vsraw;
+                        case VCMPGTSW:  return &PPUInterpreter::vcmpgtsw;
+                        case VCTUXS:    return &PPUInterpreter::vctuxs;
+                        case VSPLTISW:  return &PPUInterpreter::vspltisw;
+                        case VCTSXS:    return &PPUInterpreter::vctsxs;
+                        case VAND:      return &PPUInterpreter::vand;
+                        case VMAXFP:    return &PPUInterpreter::vmaxfp;
+                        case VSUBUHM:   return &PPUInterpreter::vsubuhm;
+                        case VANDC:     return &PPUInterpreter::vandc;
+                        case VMINFP:    return &PPUInterpreter::vminfp;
+                        case VSUBUWM:   return &PPUInterpreter::vsubuwm;
+                        case VOR:       return &PPUInterpreter::vor;
+                        case VNOR:      return &PPUInterpreter::vnor;
+                        case MFVSCR:    return &PPUInterpreter::mfvscr;
+                        case MTVSCR:    return &PPUInterpreter::mtvscr;
+                        case VXOR:      return &PPUInterpreter::vxor;
+                        case VSUM4SBS:  return &PPUInterpreter::vsum4sbs;
+                        case VSUBSHS:   return &PPUInterpreter::vsubshs;
+                        case VSUMSWS:   return &PPUInterpreter::vsumsws;
+                            
+                        default:
+                            Helpers::panic("Unimplemented G_04 instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_04_field, (u32)instr.g_04_field, instr.raw, pc);
+                    }
             }
-            case MULLI:  mulli(instr);   break;
-            case SUBFIC: subfic(instr);  break;
-            case CMPLI:  cmpli(instr);   break;
-            case CMPI:   cmpi(instr);    break;
-            case ADDIC:  addic(instr);   break;
-            case ADDIC_: addic_(instr);  break;
-            case ADDI:   addi(instr);    break;
-            case ADDIS:  addis(instr);   break;
-            case BC:     bc(instr);      break;
-            case SC:     sc(instr);      break;
-            case B:      b(instr);       break;
-            case G_13: {
-                switch (instr.g_13_field) {
-                        
-                    case MCRF:      mcrf(instr);    break;
-                    case BCLR:      bclr(instr);    break;
-                    case CRNOR:     crnor(instr);   break;
-                    case CRANDC:    crandc(instr);  break;
-                    case ISYNC:     break;
-                    case CRNAND:    crnand(instr);  break;
-                    case CRAND:     crand(instr);  break;
-                    case CRORC:     crorc(instr);   break;
-                    case CROR:      cror(instr);    break;
-                    case BCCTR:     bcctr(instr);   break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_13 instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_13_field, (u32)instr.g_13_field, instr.raw, state.pc);
-                }
-                break;
+        }
+        case MULLI:  return &PPUInterpreter::mulli;
+        case SUBFIC: return &PPUInterpreter::subfic;
+        case CMPLI:  return &PPUInterpreter::cmpli;
+        case CMPI:   return &PPUInterpreter::cmpi;
+        case ADDIC:  return &PPUInterpreter::addic;
+        case ADDIC_: return &PPUInterpreter::addic_;
+        case ADDI:   return &PPUInterpreter::addi;
+        case ADDIS:  return &PPUInterpreter::addis;
+        case BC:     return &PPUInterpreter::bc;
+        case SC:     return &PPUInterpreter::sc;
+        case B:      return &PPUInterpreter::b;
+        case G_13: {
+            switch (instr.g_13_field) {
+                    
+                case MCRF:      return &PPUInterpreter::mcrf;
+                case BCLR:      return &PPUInterpreter::bclr;
+                case CRNOR:     return &PPUInterpreter::crnor;
+                case CRANDC:    return &PPUInterpreter::crandc;
+                case ISYNC:     return &PPUInterpreter::nop;
+                case CRNAND:    return &PPUInterpreter::crnand;
+                case CRAND:     return &PPUInterpreter::crand;
+                case CRORC:     return &PPUInterpreter::crorc;
+                case CROR:      return &PPUInterpreter::cror;
+                case BCCTR:     return &PPUInterpreter::bcctr;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_13 instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_13_field, (u32)instr.g_13_field, instr.raw, pc);
             }
-            case RLWIMI:    rlwimi(instr);  break;
-            case RLWINM:    rlwinm(instr);  break;
-            case RLWNM:     rlwnm(instr);   break;
-            case ORI:       ori(instr);     break;
-            case ORIS:      oris(instr);    break;
-            case XORI:      xori(instr);    break;
-            case XORIS:     xoris(instr);   break;
-            case ANDI:      andi(instr);    break;
-            case ANDIS:     andis(instr);   break;
-            case G_1E: {
-                switch (instr.g_1e_field) {
-                        
-                    case RLDICL_:
-                    case RLDICL:    rldicl(instr);  break;
-                    case RLDICR_:
-                    case RLDICR:    rldicr(instr);  break;
-                    case RLDIC_:
-                    case RLDIC:     rldic(instr);   break;
-                    case RLDIMI_:
-                    case RLDIMI:    rldimi(instr);  break;
-                    case RLDCL:     rldcl(instr);   break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_1E instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_1e_field, (u32)instr.g_1e_field, instr.raw);
-                }
-                break;
+        }
+        case RLWIMI:    return &PPUInterpreter::rlwimi;
+        case RLWINM:    return &PPUInterpreter::rlwinm;
+        case RLWNM:     return &PPUInterpreter::rlwnm;
+        case ORI:       return &PPUInterpreter::ori;
+        case ORIS:      return &PPUInterpreter::oris;
+        case XORI:      return &PPUInterpreter::xori;
+        case XORIS:     return &PPUInterpreter::xoris;
+        case ANDI:      return &PPUInterpreter::andi;
+        case ANDIS:     return &PPUInterpreter::andis;
+        case G_1E: {
+            switch (instr.g_1e_field) {
+                    
+                case RLDICL_:
+                case RLDICL:    return &PPUInterpreter::rldicl;
+                case RLDICR_:
+                case RLDICR:    return &PPUInterpreter::rldicr;
+                case RLDIC_:
+                case RLDIC:     return &PPUInterpreter::rldic;
+                case RLDIMI_:
+                case RLDIMI:    return &PPUInterpreter::rldimi;
+                case RLDCL:     return &PPUInterpreter::rldcl;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_1E instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_1e_field, (u32)instr.g_1e_field, instr.raw);
             }
-            case G_1F: {
-                switch (instr.g_1f_field) {
-                        
-                    case CMP:       cmp(instr);     break;
-                        //case TW:        ps3->thread_manager.getCurrentThread()->wait(); break;
-                    case LVSL:      lvsl(instr);    break;
-                    case SUBFC:     subfc(instr);   break;
-                    case MULHDU:    mulhdu(instr);  break;
-                    case ADDC:      addc(instr);    break;
-                    case MULHWU:    mulhwu(instr);  break;
-                    case MFCR:      mfcr(instr);    break;
-                    case LWARX:     lwarx(instr);   break;
-                    case LDX:       ldx(instr);     break;
-                    case LWZX:      lwzx(instr);    break;
-                    case CNTLZW:    cntlzw(instr);  break;
-                    case SLW:       slw(instr);     break;
-                    case SLD:       sld(instr);     break;
-                    case AND:       and_(instr);    break;
-                    case CMPL:      cmpl(instr);    break;
-                    case LVSR:      lvsr(instr);    break;
-                    case SUBF:      subf(instr);    break;
-                    case DCBST:     break;
-                    case LWZUX:     lwzux(instr);   break;
-                    case CNTLZD:    cntlzd(instr);  break;
-                    case ANDC:      andc(instr);    break;
-                    case LVEWX:     lvewx(instr);   break;
-                    case MULHD:     mulhd(instr);   break;
-                    case MULHW:     mulhw(instr);   break;
-                    case LDARX:     ldarx(instr);   break;
-                    case LBZX:      lbzx(instr);    break;
-                    case LVX:       lvx(instr);     break;
-                    case NEG:       neg(instr);     break;
-                    case NOR:       nor(instr);     break;
-                    case STVEBX:    stvebx(instr);  break;
-                    case SUBFE:     subfe(instr);   break;
-                    case ADDE:      adde(instr);    break;
-                    case MTCRF:     mtcrf(instr);   break;
-                    case STDX:      stdx(instr);    break;
-                    case STWCX_:    stwcx(instr);   break;
-                    case STWX:      stwx(instr);    break;
-                    case STVEHX:    stvehx(instr);  break;
-                    case STDUX:     stdux(instr);   break;
-                    case STVEWX:    stvewx(instr);  break;
-                    case ADDZE:     addze(instr);   break;
-                    case STDCX_:    stdcx(instr);   break;
-                    case STBX:      stbx(instr);    break;
-                    case STVX:      stvx(instr);    break;
-                    case MULLD:     mulld(instr);   break;
-                    case MULLW:     mullw(instr);   break;
-                    case STBUX:     stbux(instr);   break;
-                    case DCBTST:    break;
-                    case ADD:       add(instr);     break;
-                    case DCBT:      break;
-                    case LHZX:      lhzx(instr);    break;
-                    case LHZUX:     lhzux(instr);    break;
-                    case XOR:       xor_(instr);    break;
-                    case MFSPR:     mfspr(instr);   break;
-                    case DST:       break;
-                    case MFTB:      mftb(instr);    break;
-                    case DSTST:     break;
-                    case STHX:      sthx(instr);    break;
-                    case ORC:       orc(instr);     break;
-                    case OR:        or_(instr);     break;
-                    case DIVDU:     divdu(instr);   break;
-                    case DIVWU:     divwu(instr);   break;
-                    case MTSPR:     mtspr(instr);   break;
-                    case NAND:      nand(instr);    break;
-                    case DIVD:      divd(instr);    break;
-                    case DIVW:      divw(instr);    break;
-                    case LVLX:      lvlx(instr);    break;
-                    case LWBRX:     lwbrx(instr);   break;
-                    case LFSX:      lfsx(instr);    break;
-                    case SRW:       srw(instr);     break;
-                    case SRD:       srd(instr);     break;
-                    case LVRX:      lvrx(instr);    break;
-                    case SYNC:      break;
-                    case LFDX:      lfdx(instr);    break;
-                    case STVLX:     stvlx(instr);   break;
-                    case STFSX:     stfsx(instr);   break;
-                    case STVRX:     stvrx(instr);   break;
-                    case STFDX:     stfdx(instr);   break;
-                    case LHBRX:     lhbrx(instr);   break;
-                    case SRAW:      sraw(instr);    break;
-                    case SRAD:      srad(instr);    break;
-                    case DSS:       break;
-                    case SRAWI:     srawi(instr);   break;
-                    case SRADI1:
-                    case SRADI2:    sradi(instr);   break;
-                    case EIEIO:     break;
-                    case EXTSH:     extsh(instr);   break;
-                    case EXTSB:     extsb(instr);   break;
-                    case EXTSW:     extsw(instr);   break;
-                    case STFIWX:    stfiwx(instr);  break;
-                    case DCBZ:      dcbz(instr);    break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_1F instruction 0x%03x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_1f_field, (u32)instr.g_1f_field, instr.raw, state.pc);
-                }
-                break;
+        }
+        case G_1F: {
+            switch (instr.g_1f_field) {
+                    
+                case CMP:       return &PPUInterpreter::cmp;
+                    //case TW:        ps3->thread_manager.getCurrentThread()->wait(); break;
+                case LVSL:      return &PPUInterpreter::lvsl;
+                case SUBFC:     return &PPUInterpreter::subfc;
+                case MULHDU:    return &PPUInterpreter::mulhdu;
+                case ADDC:      return &PPUInterpreter::addc;
+                case MULHWU:    return &PPUInterpreter::mulhwu;
+                case MFCR:      return &PPUInterpreter::mfcr;
+                case LWARX:     return &PPUInterpreter::lwarx;
+                case LDX:       return &PPUInterpreter::ldx;
+                case LWZX:      return &PPUInterpreter::lwzx;
+                case CNTLZW:    return &PPUInterpreter::cntlzw;
+                case SLW:       return &PPUInterpreter::slw;
+                case SLD:       return &PPUInterpreter::sld;
+                case AND:       return &PPUInterpreter::and_;
+                case CMPL:      return &PPUInterpreter::cmpl;
+                case LVSR:      return &PPUInterpreter::lvsr;
+                case SUBF:      return &PPUInterpreter::subf;
+                case DCBST:     return &PPUInterpreter::nop;
+                case LWZUX:     return &PPUInterpreter::lwzux;
+                case CNTLZD:    return &PPUInterpreter::cntlzd;
+                case ANDC:      return &PPUInterpreter::andc;
+                case LVEWX:     return &PPUInterpreter::lvewx;
+                case MULHD:     return &PPUInterpreter::mulhd;
+                case MULHW:     return &PPUInterpreter::mulhw;
+                case LDARX:     return &PPUInterpreter::ldarx;
+                case LBZX:      return &PPUInterpreter::lbzx;
+                case LVX:       return &PPUInterpreter::lvx;
+                case NEG:       return &PPUInterpreter::neg;
+                case NOR:       return &PPUInterpreter::nor;
+                case STVEBX:    return &PPUInterpreter::stvebx;
+                case SUBFE:     return &PPUInterpreter::subfe;
+                case ADDE:      return &PPUInterpreter::adde;
+                case MTCRF:     return &PPUInterpreter::mtcrf;
+                case STDX:      return &PPUInterpreter::stdx;
+                case STWCX_:    return &PPUInterpreter::stwcx;
+                case STWX:      return &PPUInterpreter::stwx;
+                case STVEHX:    return &PPUInterpreter::stvehx;
+                case STDUX:     return &PPUInterpreter::stdux;
+                case STVEWX:    return &PPUInterpreter::stvewx;
+                case ADDZE:     return &PPUInterpreter::addze;
+                case STDCX_:    return &PPUInterpreter::stdcx;
+                case STBX:      return &PPUInterpreter::stbx;
+                case STVX:      return &PPUInterpreter::stvx;
+                case MULLD:     return &PPUInterpreter::mulld;
+                case MULLW:     return &PPUInterpreter::mullw;
+                case STBUX:     return &PPUInterpreter::stbux;
+                case DCBTST:    return &PPUInterpreter::nop;
+                case ADD:       return &PPUInterpreter::add;
+                case DCBT:      return &PPUInterpreter::nop;
+                case LHZX:      return &PPUInterpreter::lhzx;
+                case LHZUX:     return &PPUInterpreter::lhzux;
+                case XOR:       return &PPUInterpreter::xor_;
+                case MFSPR:     return &PPUInterpreter::mfspr;
+                case DST:       return &PPUInterpreter::nop;
+                case MFTB:      return &PPUInterpreter::mftb;
+                case DSTST:     return &PPUInterpreter::nop;
+                case STHX:      return &PPUInterpreter::sthx;
+                case ORC:       return &PPUInterpreter::orc;
+                case OR:        return &PPUInterpreter::or_;
+                case DIVDU:     return &PPUInterpreter::divdu;
+                case DIVWU:     return &PPUInterpreter::divwu;
+                case MTSPR:     return &PPUInterpreter::mtspr;
+                case NAND:      return &PPUInterpreter::nand;
+                case DIVD:      return &PPUInterpreter::divd;
+                case DIVW:      return &PPUInterpreter::divw;
+                case LVLX:      return &PPUInterpreter::lvlx;
+                case LWBRX:     return &PPUInterpreter::lwbrx;
+                case LFSX:      return &PPUInterpreter::lfsx;
+                case SRW:       return &PPUInterpreter::srw;
+                case SRD:       return &PPUInterpreter::srd;
+                case LVRX:      return &PPUInterpreter::lvrx;
+                case SYNC:      return &PPUInterpreter::nop;
+                case LFDX:      return &PPUInterpreter::lfdx;
+                case STVLX:     return &PPUInterpreter::stvlx;
+                case STFSX:     return &PPUInterpreter::stfsx;
+                case STVRX:     return &PPUInterpreter::stvrx;
+                case STFDX:     return &PPUInterpreter::stfdx;
+                case LHBRX:     return &PPUInterpreter::lhbrx;
+                case SRAW:      return &PPUInterpreter::sraw;
+                case SRAD:      return &PPUInterpreter::srad;
+                case DSS:       return &PPUInterpreter::nop;
+                case SRAWI:     return &PPUInterpreter::srawi;
+                case SRADI1:
+                case SRADI2:    return &PPUInterpreter::sradi;
+                case EIEIO:     return &PPUInterpreter::nop;
+                case EXTSH:     return &PPUInterpreter::extsh;
+                case EXTSB:     return &PPUInterpreter::extsb;
+                case EXTSW:     return &PPUInterpreter::extsw;
+                case STFIWX:    return &PPUInterpreter::stfiwx;
+                case DCBZ:      return &PPUInterpreter::dcbz;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_1F instruction 0x%03x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_1f_field, (u32)instr.g_1f_field, instr.raw, pc);
             }
-            case LWZ:   lwz(instr);     break;
-            case LWZU:  lwzu(instr);    break;
-            case LBZ:   lbz(instr);     break;
-            case LBZU:  lbzu(instr);    break;
-            case STW:   stw(instr);     break;
-            case STWU:  stwu(instr);    break;
-            case STB:   stb(instr);     break;
-            case STBU:  stbu(instr);    break;
-            case LHZ:   lhz(instr);     break;
-            case LHZU:  lhzu(instr);    break;
-            case STH:   sth(instr);     break;
-            case STHU:  sthu(instr);    break;
-            case LFS:   lfs(instr);     break;
-            case LFSU:  lfsu(instr);     break;
-            case LFD:   lfd(instr);     break;
-            case LFDU:  lfdu(instr);    break;
-            case STFS:  stfs(instr);    break;
-            case STFSU: stfsu(instr);   break;
-            case STFD:  stfd(instr);    break;
-            case STFDU: stfdu(instr);   break;
-            case G_3A: {
-                switch (instr.g_3a_field) {
-                        
-                    case LD:    ld(instr);      break;
-                    case LDU:   ldu(instr);     break;
-                    case LWA:   lwa(instr);     break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_3A instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3a_field, (u32)instr.g_3a_field, instr.raw);
-                }
-                break;
+        }
+        case LWZ:   return &PPUInterpreter::lwz;
+        case LWZU:  return &PPUInterpreter::lwzu;
+        case LBZ:   return &PPUInterpreter::lbz;
+        case LBZU:  return &PPUInterpreter::lbzu;
+        case STW:   return &PPUInterpreter::stw;
+        case STWU:  return &PPUInterpreter::stwu;
+        case STB:   return &PPUInterpreter::stb;
+        case STBU:  return &PPUInterpreter::stbu;
+        case LHZ:   return &PPUInterpreter::lhz;
+        case LHZU:  return &PPUInterpreter::lhzu;
+        case STH:   return &PPUInterpreter::sth;
+        case STHU:  return &PPUInterpreter::sthu;
+        case LFS:   return &PPUInterpreter::lfs;
+        case LFSU:  return &PPUInterpreter::lfsu;
+        case LFD:   return &PPUInterpreter::lfd;
+        case LFDU:  return &PPUInterpreter::lfdu;
+        case STFS:  return &PPUInterpreter::stfs;
+        case STFSU: return &PPUInterpreter::stfsu;
+        case STFD:  return &PPUInterpreter::stfd;
+        case STFDU: return &PPUInterpreter::stfdu;
+        case G_3A: {
+            switch (instr.g_3a_field) {
+                    
+                case LD:    return &PPUInterpreter::ld;
+                case LDU:   return &PPUInterpreter::ldu;
+                case LWA:   return &PPUInterpreter::lwa;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_3A instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3a_field, (u32)instr.g_3a_field, instr.raw);
             }
-            case G_3B: {
-                switch (instr.g_3b_field) {
-                        
-                    case FDIVS:     fdivs(instr);   break;
-                    case FSUBS:     fsubs(instr);   break;
-                    case FADDS:     fadds(instr);   break;
-                    case FSQRTS:    fsqrts(instr);  break;
-                    case FMULS:     fmuls(instr);   break;
-                    case FMSUBS:    fmsubs(instr);  break;
-                    case FMADDS:    fmadds(instr);  break;
-                    case FNMSUBS:   fnmsubs(instr); break;
-                    case FNMADDS:   fnmadds(instr); break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_3B instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3b_field, (u32)instr.g_3b_field, instr.raw);
-                }
-                break;
+        }
+        case G_3B: {
+            switch (instr.g_3b_field) {
+                    
+                case FDIVS:     return &PPUInterpreter::fdivs;
+                case FSUBS:     return &PPUInterpreter::fsubs;
+                case FADDS:     return &PPUInterpreter::fadds;
+                case FSQRTS:    return &PPUInterpreter::fsqrts;
+                case FMULS:     return &PPUInterpreter::fmuls;
+                case FMSUBS:    return &PPUInterpreter::fmsubs;
+                case FMADDS:    return &PPUInterpreter::fmadds;
+                case FNMSUBS:   return &PPUInterpreter::fnmsubs;
+                case FNMADDS:   return &PPUInterpreter::fnmadds;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_3B instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3b_field, (u32)instr.g_3b_field, instr.raw);
             }
-            case G_3E: {
-                switch (instr.g_3e_field) {
-                        
-                    case STD:   std(instr);     break;
-                    case STDU:  stdu(instr);    break;
-                        
-                    default:
-                        Helpers::panic("Unimplemented G_3E instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3e_field, (u32)instr.g_3e_field, instr.raw);
-                }
-                break;
+        }
+        case G_3E: {
+            switch (instr.g_3e_field) {
+                    
+                case STD:   return &PPUInterpreter::std;
+                case STDU:  return &PPUInterpreter::stdu;
+                    
+                default:
+                    Helpers::panic("Unimplemented G_3E instruction 0x%02x (decimal: %d) (full instr: 0x%08x)\n", (u32)instr.g_3e_field, (u32)instr.g_3e_field, instr.raw);
             }
-            case G_3F: {
-                switch (instr.g_3f_field & 0x1f) {
-                        
-                    case FSEL:      fsel(instr);    break;
-                    case FMUL:      fmul(instr);    break;
-                    case FRSQRTE:   frsqrte(instr); break;
-                    case FMSUB:     fmsub(instr);   break;
-                    case FMADD:     fmadd(instr);   break;
-                    case FNMSUB:    fnmsub(instr);  break;
-                    case FNMADD:    fnmadd(instr);  break;
-                        
-                    default:
-                        switch (instr.g_3f_field) {
-                                
-                            case MFFS:      mffs(instr);    break;
-                            case MTFSF:     mtfsf(instr);   break;
-                            case FCMPU:     fcmpu(instr);   break;
-                            case FRSP:      frsp(instr);    break;
-                            case FCTIW:
-                            case FCTIWZ:    fctiwz(instr);  break;
-                            case FDIV:      fdiv(instr);    break;
-                            case FSUB:      fsub(instr);    break;
-                            case FADD:      fadd(instr);    break;
-                            case FSQRT:     fsqrt(instr);   break;
-                            case FMR:       fmr(instr);     break;
-                            case FNEG:      fneg(instr);    break;
-                            case FNABS:     fnabs(instr);   break;
-                            case FABS:      fabs_(instr);   break;
-                            case FCTID:     fctid(instr);   break;
-                            case FCTIDZ:    fctidz(instr);  break;
-                            case FCFID:     fcfid(instr);   break;
-                                
-                            default:
-                                Helpers::panic("Unimplemented G_3F instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_3f_field, (u32)instr.g_3f_field, instr.raw, state.pc);
-                        }
-                }
-                break;
+        }
+        case G_3F: {
+            switch (instr.g_3f_field & 0x1f) {
+                    
+                case FSEL:      return &PPUInterpreter::fsel;
+                case FMUL:      return &PPUInterpreter::fmul;
+                case FRSQRTE:   return &PPUInterpreter::frsqrte;
+                case FMSUB:     return &PPUInterpreter::fmsub;
+                case FMADD:     return &PPUInterpreter::fmadd;
+                case FNMSUB:    return &PPUInterpreter::fnmsub;
+                case FNMADD:    return &PPUInterpreter::fnmadd;
+                    
+                default:
+                    switch (instr.g_3f_field) {
+                            
+                        case MFFS:      return &PPUInterpreter::mffs;
+                        case MTFSF:     return &PPUInterpreter::mtfsf;
+                        case FCMPU:     return &PPUInterpreter::fcmpu;
+                        case FRSP:      return &PPUInterpreter::frsp;
+                        case FCTIW:
+                        case FCTIWZ:    return &PPUInterpreter::fctiwz;
+                        case FDIV:      return &PPUInterpreter::fdiv;
+                        case FSUB:      return &PPUInterpreter::fsub;
+                        case FADD:      return &PPUInterpreter::fadd;
+                        case FSQRT:     return &PPUInterpreter::fsqrt;
+                        case FMR:       return &PPUInterpreter::fmr;
+                        case FNEG:      return &PPUInterpreter::fneg;
+                        case FNABS:     return &PPUInterpreter::fnabs;
+                        case FABS:      return &PPUInterpreter::fabs_;
+                        case FCTID:     return &PPUInterpreter::fctid;
+                        case FCTIDZ:    return &PPUInterpreter::fctidz;
+                        case FCFID:     return &PPUInterpreter::fcfid;
+                            
+                        default:
+                            Helpers::panic("Unimplemented G_3F instruction 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.g_3f_field, (u32)instr.g_3f_field, instr.raw, pc);
+                    }
             }
-                
-            default:
-                Helpers::panic("Unimplemented opcode 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.opc, (u32)instr.opc, instr.raw, state.pc);
         }
-        
-        state.pc += 4;
-        if (cycles++ > 2048) should_break = true;
-    } while (!should_break);
-    
-    should_break = false;
-    return cycles;
+            
+        default:
+            Helpers::panic("Unimplemented opcode 0x%02x (decimal: %d) (full instr: 0x%08x) @ 0x%016llx\n", (u32)instr.opc, (u32)instr.opc, instr.raw, pc);
+    }
 }
 
+void PPUInterpreter::nop(const Instruction& instr) {}
+
 // Main
 
 void PPUInterpreter::mulli(const Instruction& instr) {
@@ -505,7 +502,7 @@ void PPUInterpreter::bc(const Instruction& instr) {
 
 void PPUInterpreter::sc(const Instruction& instr) {
     should_break = true;
-    ps3->syscall.doSyscall(true);
+    ps3->syscall.doSyscall(instr.raw, true);
 }
 
 void PPUInterpreter::b(const Instruction& instr) {
@@ -2209,6 +2206,7 @@ void PPUInterpreter::stfiwx(const Instruction& instr) {
 void PPUInterpreter::dcbz(const Instruction& instr) {
     const u32 addr = instr.ra ? (state.gprs[instr.ra] + state.gprs[instr.rb]) : state.gprs[instr.rb];
     std::memset(ps3->mem.getPtr(addr & ~127), 0, 128);
+    ps3->mem.markWritten(addr & ~127, 128);
 }
 
 // G_3A
@@ -41,6 +41,11 @@ public:
     std::vector<std::pair<u32, u32>> call_stack;    // First: addr of function, second: addr the function is called from
     // Debug symbols
     void printFunctionCall();
+
+    // Decoding
+    using Handler = void (PPUInterpreter::*)(const Instruction&);
+    Handler decode(const Instruction& instr, u32 pc);   // pc is only used for error messages
+    void nop        (const Instruction& instr);
     
     // Main
     void mulli      (const Instruction& instr);
@@ -0,0 +1,532 @@
+#include "PPUJIT.hpp"
+#include <PlayStation3.hpp>
+
+#ifdef CHONKYSTATION3_PPU_JIT
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+
+using Instruction = PPUTypes::Instruction;
+
+// Host registers
+static constexpr u8 RAX = 0;
+static constexpr u8 RCX = 1;
+
+PPUJIT::PPUJIT(Memory& mem, PlayStation3* ps3, bool compare) : PPUCachedInterpreter(mem, ps3), compare(compare) {
+#ifdef _WIN32
+    code_buffer = (u8*)VirtualAlloc(nullptr, CODE_BUFFER_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+    if (!code_buffer)
+        Helpers::panic("PPUJIT: failed to allocate code buffer\n");
+#else
+    code_buffer = (u8*)mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code_buffer == MAP_FAILED)
+        Helpers::panic("PPUJIT: failed to allocate code buffer\n");
+#endif
+    code_ptr = code_buffer;
+}
+
+PPUJIT::~PPUJIT() {
+#ifdef _WIN32
+    VirtualFree(code_buffer, 0, MEM_RELEASE);
+#else
+    munmap(code_buffer, CODE_BUFFER_SIZE);
+#endif
+}
+
+int PPUJIT::step() {
+    int cycles = 0;
+    depth++;
+
+    do {
+        // Single stepping from the debugger, or code which might have read watchpoints on it
+        if (should_break || !mem.isFastRead(state.pc >> PAGE_SHIFT)) {
+            interpretInstruction();
+            if (cycles++ > 2048) should_break = true;
+            continue;
+        }
+
+        BlockFunc func = getCode(state.pc);
+        if (!func) {
+            runBlock(getBlock(state.pc), cycles);
+            continue;
+        }
+
+        // The block might call step() again through runFunc, which would overwrite block_generation
+        const u64 old_generation = block_generation;
+        block_generation = generation;
+        cycles += func();
+        block_generation = old_generation;
+        if (cycles > 2048) should_break = true;
+    } while (!should_break);
+
+    depth--;
+    should_break = false;
+    return cycles;
+}
+
+PPUJIT::BlockFunc PPUJIT::getCode(u32 addr) {
+    auto it = code_cache.find(addr);
+    if (it != code_cache.end()) return it->second;
+
+    Block* block = &getBlock(addr);
+    // Worst case is a load/store with its slow path, plus 2 calls per instruction in compare mode
+    const size_t max_size = block->entries.size() * 256 + 64;
+    if (code_ptr + max_size > code_buffer + CODE_BUFFER_SIZE) {
+        // We can't throw away the code buffer while one of the blocks in it is still running
+        if (depth > 1) return nullptr;
+
+        log("Code buffer full, flushing\n");
+        invalidateAllBlocks();
+        code_ptr = code_buffer;
+        block = &getBlock(addr);
+    }
+
+    BlockFunc func = compile(*block);
+    code_cache[addr] = func;
+    return func;
+}
+
+PPUJIT::BlockFunc PPUJIT::compile(Block& block) {
+    BlockFunc func = (BlockFunc)code_ptr;
+
+    // Prologue
+    emit8(0x53);    // push rbx
+#ifdef _WIN32
+    // Shadow space
+    emit8(0x48); emit8(0x83); emit8(0xec); emit8(0x20);     // sub rsp, 32
+#endif
+    emit8(0x48); emit8(0xbb); emit64((u64)&state);          // mov rbx, &state
+
+    u32 pending_pc = 0;
+    auto flushPC = [&]() {
+        if (pending_pc) {
+            emitAddPC(pending_pc);
+            pending_pc = 0;
+        }
+    };
+
+    for (int i = 0; i < block.entries.size(); i++) {
+        const Entry* entry = &block.entries[i];
+        u8* native_start = code_ptr;
+
+        if (compare) {
+            flushPC();
+            emitCall((void*)&PPUJIT::compareBefore, entry);
+        }
+
+        if (compileNative(entry, i, pending_pc)) {
+            pending_pc += 4;
+            if (compare) {
+                flushPC();
+                emitCall((void*)&PPUJIT::compareAfter, entry);
+            }
+            continue;
+        }
+
+        // Not natively implemented, fall back to the interpreter
+        code_ptr = native_start;
+        flushPC();
+        emitCallHandler(entry, i);
+    }
+
+    flushPC();
+    emit8(0xb8); emit32(block.entries.size());  // mov eax, executed instructions
+    emitEpilogue();
+
+    log("Compiled block 0x%08x (%d instructions, %d bytes)\n", block.start, block.entries.size(), (u32)(code_ptr - (u8*)func));
+    return func;
+}
+
+// Emits host code for simple integer instructions, compares, rlwinm and loads/stores.
+// Returns false if the instruction has to go through the interpreter
+bool PPUJIT::compileNative(const Entry* entry, int idx, u32 pending_pc) {
+    const Instruction& instr = entry->instr;
+    switch (instr.opc) {
+
+    case CMPLI:
+    case CMPI: {
+        const bool is_unsigned = instr.opc == CMPLI;
+        const s32 imm = is_unsigned ? (s32)instr.ui : (s32)(s16)instr.si;
+        emitLoadGPR(RAX, instr.ra);
+        if (instr.l) emit8(0x48);
+        emit8(0x3d); emit32(imm);   // cmp eax/rax, imm
+        emitSetCRField(instr.bf, is_unsigned);
+        return true;
+    }
+
+    case ADDI:
+    case ADDIS: {
+        if (instr.ra) emitLoadGPR(RAX, instr.ra);
+        else {
+            emit8(0x31); emit8(0xc0);   // xor eax, eax
+        }
+        const s32 imm = (instr.opc == ADDI) ? (s32)(s16)instr.si : (s32)(instr.si << 16);
+        emit8(0x48); emit8(0x05); emit32(imm);  // add rax, imm (sign extended)
+        emitStoreRAX(instr.rt);
+        return true;
+    }
+
+    case RLWINM: {
+        const u64 mask = rotation_mask[32 + instr.mb_5][32 + instr.me_5];
+        emit8(0x8b); emit8(0x83); emit32(offsetof(PPUTypes::State, gprs) + instr.rs * sizeof(u64));    // mov eax, [rbx + gprs[rs]]
+        if (instr.sh) {
+            emit8(0xc1); emit8(0xc0); emit8(instr.sh);  // rol eax, sh
+        }
+        if (mask >> 32) {
+            // The mask wraps around, the upper word gets a copy of the rotated word
+            emit8(0x48); emit8(0x89); emit8(0xc1);              // mov rcx, rax
+            emit8(0x48); emit8(0xc1); emit8(0xe1); emit8(32);   // shl rcx, 32
+            emit8(0x48); emit8(0x09); emit8(0xc8);              // or rax, rcx
+            emit8(0x48); emit8(0xb9); emit64(mask);             // mov rcx, mask
+            emit8(0x48); emit8(0x21); emit8(0xc8);              // and rax, rcx
+        } else {
+            emit8(0x25); emit32(mask);  // and eax, mask (zero extended)
+        }
+        emitStoreRAX(instr.ra);
+        if (instr.rc) {
+            // The interpreter compares the low word
+            emit8(0x85); emit8(0xc0);   // test eax, eax
+            emitSetCRField(0, false);
+        }
+        return true;
+    }
+
+    case ORI:
+    case ORIS:
+    case XORI:
+    case XORIS: {
+        const bool shifted = instr.opc == ORIS || instr.opc == XORIS;
+        const bool is_xor = instr.opc == XORI || instr.opc == XORIS;
+        emitLoadGPR(RAX, instr.rs);
+        emit8(0xb9); emit32(shifted ? ((u32)instr.ui << 16) : (u32)instr.ui);   // mov ecx, imm (zero extended)
+        emit8(0x48); emit8(is_xor ? 0x31 : 0x09); emit8(0xc8);                  // or/xor rax, rcx
+        emitStoreRAX(instr.ra);
+        return true;
+    }
+
+    case ANDI:
+    case ANDIS: {
+        emitLoadGPR(RAX, instr.rs);
+        emit8(0x25); emit32(instr.opc == ANDIS ? ((u32)instr.ui << 16) : (u32)instr.ui);  // and eax, imm (zero extended)
+        emitStoreRAX(instr.ra);
+        emitSetCR0();
+        return true;
+    }
+
+    case G_1F: {
+        switch (instr.g_1f_field) {
+
+        case CMP:
+        case CMPL: {
+            emitLoadGPR(RAX, instr.ra);
+            emitLoadGPR(RCX, instr.rb);
+            if (instr.l) emit8(0x48);
+            emit8(0x39); emit8(0xc8);   // cmp eax/rax, ecx/rcx
+            emitSetCRField(instr.bf, instr.g_1f_field == CMPL);
+            return true;
+        }
+
+        case OR:
+        case AND:
+        case XOR: {
+            const u8 op = (instr.g_1f_field == OR) ? 0x09 : ((instr.g_1f_field == AND) ? 0x21 : 0x31);
+            emitLoadGPR(RAX, instr.rs);
+            emitLoadGPR(RCX, instr.rb);
+            emit8(0x48); emit8(op); emit8(0xc8);    // op rax, rcx
+            emitStoreRAX(instr.ra);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case ADD: {
+            if (instr.oe) return false;
+            emitLoadGPR(RAX, instr.ra);
+            emitLoadGPR(RCX, instr.rb);
+            emit8(0x48); emit8(0x01); emit8(0xc8);  // add rax, rcx
+            emitStoreRAX(instr.rt);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case SUBF: {
+            if (instr.oe) return false;
+            emitLoadGPR(RAX, instr.rb);
+            emitLoadGPR(RCX, instr.ra);
+            emit8(0x48); emit8(0x29); emit8(0xc8);  // sub rax, rcx
+            emitStoreRAX(instr.rt);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case NEG: {
+            if (instr.oe) return false;
+            emitLoadGPR(RAX, instr.ra);
+            emit8(0x48); emit8(0xf7); emit8(0xd8);  // neg rax
+            emitStoreRAX(instr.rt);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case EXTSW: {
+            emitLoadGPR(RAX, instr.rs);
+            emit8(0x48); emit8(0x63); emit8(0xc0);  // movsxd rax, eax
+            emitStoreRAX(instr.ra);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case EXTSH: {
+            emitLoadGPR(RAX, instr.rs);
+            emit8(0x48); emit8(0x0f); emit8(0xbf); emit8(0xc0); // movsx rax, ax
+            emitStoreRAX(instr.ra);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        case EXTSB: {
+            emitLoadGPR(RAX, instr.rs);
+            emit8(0x48); emit8(0x0f); emit8(0xbe); emit8(0xc0); // movsx rax, al
+            emitStoreRAX(instr.ra);
+            if (instr.rc) emitSetCR0();
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    default:
+        return compileLoadStore(entry, idx, pending_pc);
+    }
+}
+
+// D-form and DS-form integer loads and stores.
+// The fast path accesses arena + address when the page flags allow the access, like Memory::read/write do.
+// Otherwise the instruction goes through the interpreter handler, which also takes care of MMIO, watchpoints, tracked pages and reservations
+bool PPUJIT::compileLoadStore(const Entry* entry, int idx, u32 pending_pc) {
+#ifndef CHONKYSTATION3_MEMORY_ARENA
+    return false;
+#else
+    const Instruction& instr = entry->instr;
+    u8 size;
+    bool store;
+    bool update;
+    s32 offs = (s32)(s16)instr.d;
+
+    switch (instr.opc) {
+    case LBZ:   size = 1; store = false; update = false; break;
+    case LBZU:  size = 1; store = false; update = true;  break;
+    case LHZ:   size = 2; store = false; update = false; break;
+    case LHZU:  size = 2; store = false; update = true;  break;
+    case LWZ:   size = 4; store = false; update = false; break;
+    case LWZU:  size = 4; store = false; update = true;  break;
+    case STB:   size = 1; store = true;  update = false; break;
+    case STBU:  size = 1; store = true;  update = true;  break;
+    case STH:   size = 2; store = true;  update = false; break;
+    case STHU:  size = 2; store = true;  update = true;  break;
+    case STW:   size = 4; store = true;  update = false; break;
+    case STWU:  size = 4; store = true;  update = true;  break;
+    case G_3A:
+        if (instr.g_3a_field != LD && instr.g_3a_field != LDU) return false;
+        size = 8; store = false; update = instr.g_3a_field == LDU;
+        offs = (s32)(s16)(instr.ds << 2);
+        break;
+    case G_3E:
+        if (instr.g_3e_field != STD && instr.g_3e_field != STDU) return false;
+        size = 8; store = true; update = instr.g_3e_field == STDU;
+        offs = (s32)(s16)(instr.ds << 2);
+        break;
+    default:
+        return false;
+    }
+
+    // rcx = effective address (written back by the update forms), edx = 32-bit guest address
+    if (instr.ra || update) {
+        emitLoadGPR(RCX, instr.ra);
+        emit8(0x48); emit8(0x81); emit8(0xc1); emit32(offs);    // add rcx, offs
+    } else {
+        emit8(0xb9); emit32(offs);  // mov ecx, offs
+    }
+    emit8(0x89); emit8(0xca);   // mov edx, ecx
+
+    // Check the flags of the page
+    emit8(0x89); emit8(0xd0);                           // mov eax, edx
+    emit8(0xc1); emit8(0xe8); emit8(PAGE_SHIFT);        // shr eax, PAGE_SHIFT
+    emit8(0x48); emit8(0xbe); emit64((u64)mem.page_flags.data());   // mov rsi, page_flags
+    emit8(0x0f); emit8(0xb6); emit8(0x04); emit8(0x06); // movzx eax, byte [rsi + rax]
+    emit8(0xa8); emit8(store ? (Memory::SLOW_WRITE | Memory::TRACKED | Memory::RESERVED) : Memory::SLOW_READ);  // test al, flags
+    emit8(0x0f); emit8(0x85); u8* jnz_slow = code_ptr; emit32(0);  // jnz slow
+    u8* ja_slow = nullptr;
+    if (store && size > 1) {
+        // Stores crossing into the next page would also need its flags
+        emit8(0x89); emit8(0xd0);                   // mov eax, edx
+        emit8(0x25); emit32(PAGE_MASK);             // and eax, PAGE_MASK
+        emit8(0x3d); emit32(PAGE_SIZE - size);      // cmp eax, PAGE_SIZE - size
+        emit8(0x0f); emit8(0x87); ja_slow = code_ptr; emit32(0);   // ja slow
+    }
+
+    // Fast path
+    emit8(0x48); emit8(0xbe); emit64((u64)mem.arena);   // mov rsi, arena
+    if (store) {
+        emitLoadGPR(RAX, instr.rs);
+        switch (size) {
+        case 1: emit8(0x88); break;                                                 // mov [rsi + rdx], al
+        case 2: emit8(0x66); emit8(0xc1); emit8(0xc0); emit8(8); emit8(0x66); emit8(0x89); break;    // rol ax, 8; mov [rsi + rdx], ax
+        case 4: emit8(0x0f); emit8(0xc8); emit8(0x89); break;                       // bswap eax; mov [rsi + rdx], eax
+        case 8: emit8(0x48); emit8(0x0f); emit8(0xc8); emit8(0x48); emit8(0x89); break;  // bswap rax; mov [rsi + rdx], rax
+        }
+        emit8(0x04); emit8(0x16);
+    } else {
+        switch (size) {
+        case 1: emit8(0x0f); emit8(0xb6); emit8(0x04); emit8(0x16); break;     // movzx eax, byte [rsi + rdx]
+        case 2: emit8(0x0f); emit8(0xb7); emit8(0x04); emit8(0x16); emit8(0x66); emit8(0xc1); emit8(0xc0); emit8(8); break;   // movzx eax, word [rsi + rdx]; rol ax, 8
+        case 4: emit8(0x8b); emit8(0x04); emit8(0x16); emit8(0x0f); emit8(0xc8); break;   // mov eax, [rsi + rdx]; bswap eax
+        case 8: emit8(0x48); emit8(0x8b); emit8(0x04); emit8(0x16); emit8(0x48); emit8(0x0f); emit8(0xc8); break;  // mov rax, [rsi + rdx]; bswap rax
+        }
+        emitStoreRAX(instr.rt);
+    }
+    if (update) emitStoreGPR(RCX, instr.ra);
+    emit8(0xe9); u8* jmp_done = code_ptr; emit32(0);   // jmp done
+
+    // Slow path. The handler expects pc to point to the instruction and increments it, put it back where the fast path leaves it
+    const s32 slow_offs = code_ptr - jnz_slow - 4;
+    std::memcpy(jnz_slow, &slow_offs, 4);
+    if (ja_slow) {
+        const s32 ja_offs = code_ptr - ja_slow - 4;
+        std::memcpy(ja_slow, &ja_offs, 4);
+    }
+    if (pending_pc) emitAddPC(pending_pc);
+    emitCallHandler(entry, idx);
+    emitAddPC(-(pending_pc + 4));  // Sign extended
+
+    const s32 done_offs = code_ptr - jmp_done - 4;
+    std::memcpy(jmp_done, &done_offs, 4);
+    return true;
+#endif
+}
+
+u8 PPUJIT::callHandler(PPUJIT* jit, const Entry* entry) {
+    (jit->*entry->handler)(entry->instr);
+    jit->state.pc += 4;
+    return jit->should_break || jit->generation != jit->block_generation;
+}
+
+// Runs the instruction through the interpreter and saves the result, then restores the state so the JIT code can run
+void PPUJIT::compareBefore(PPUJIT* jit, const Entry* entry) {
+    jit->saved_state = jit->state;
+    (jit->*entry->handler)(entry->instr);
+    jit->state.pc += 4;
+    jit->expected_state = jit->state;
+    jit->state = jit->saved_state;
+}
+
+void PPUJIT::compareAfter(PPUJIT* jit, const Entry* entry) {
+    const auto& jit_state = jit->state;
+    const auto& expected = jit->expected_state;
+    const u32 pc = jit_state.pc - 4;
+
+    auto mismatch = [&](const char* reg, u64 jit_val, u64 interpreter_val) {
+        Helpers::panic("PPUJIT: %s mismatch after %s @ 0x%08x (jit: 0x%016llx, interpreter: 0x%016llx)\n", reg, PPUDisassembler::disasm(jit->state, entry->instr, &jit->mem, pc).c_str(), pc, jit_val, interpreter_val);
+    };
+
+    for (int i = 0; i < 32; i++) {
+        if (jit_state.gprs[i] != expected.gprs[i])
+            mismatch(std::format("r{}", i).c_str(), jit_state.gprs[i], expected.gprs[i]);
+    }
+    if (jit_state.pc != expected.pc)            mismatch("pc", jit_state.pc, expected.pc);
+    if (jit_state.lr != expected.lr)            mismatch("lr", jit_state.lr, expected.lr);
+    if (jit_state.ctr != expected.ctr)          mismatch("ctr", jit_state.ctr, expected.ctr);
+    if (jit_state.cr.raw != expected.cr.raw)    mismatch("cr", jit_state.cr.raw, expected.cr.raw);
+    if (jit_state.xer.ca != expected.xer.ca)    mismatch("xer.ca", jit_state.xer.ca, expected.xer.ca);
+}
+
+void PPUJIT::invalidateBlocks(u32 addr, u32 size) {
+    PPUCachedInterpreter::invalidateBlocks(addr, size);
+    // The code itself stays in the buffer until it's flushed, in case one of the invalidated blocks is still running
+    std::erase_if(code_cache, [this](const auto& i) { return !blocks.contains(i.first); });
+}
+
+void PPUJIT::invalidateAllBlocks() {
+    PPUCachedInterpreter::invalidateAllBlocks();
+    code_cache.clear();
+}
+
+void PPUJIT::emitLoadGPR(u8 host_reg, int gpr) {
+    emit8(0x48); emit8(0x8b); emit8(0x83 | (host_reg << 3));
+    emit32(offsetof(PPUTypes::State, gprs) + gpr * sizeof(u64));
+}
+
+void PPUJIT::emitStoreRAX(int gpr) {
+    emitStoreGPR(RAX, gpr);
+}
+
+void PPUJIT::emitStoreGPR(u8 host_reg, int gpr) {
+    emit8(0x48); emit8(0x89); emit8(0x83 | (host_reg << 3));
+    emit32(offsetof(PPUTypes::State, gprs) + gpr * sizeof(u64));
+}
+
+// Same result as ConditionRegister::compareAndUpdateCRField (without SO, like the interpreter)
+void PPUJIT::emitSetCRField(int n, bool is_unsigned) {
+    const u8 shift = 28 - n * 4;
+    emit8(0xba); emit32(ConditionRegister::EQUAL);      // mov edx, EQUAL
+    emit8(0xb8); emit32(ConditionRegister::LESS);       // mov eax, LESS
+    emit8(0x0f); emit8(is_unsigned ? 0x42 : 0x4c); emit8(0xd0);    // cmovb/cmovl edx, eax
+    emit8(0xb8); emit32(ConditionRegister::GREATER);    // mov eax, GREATER
+    emit8(0x0f); emit8(is_unsigned ? 0x47 : 0x4f); emit8(0xd0);    // cmova/cmovg edx, eax
+    emit8(0x8b); emit8(0x83); emit32(offsetof(PPUTypes::State, cr));   // mov eax, [rbx + cr]
+    emit8(0x25); emit32(~(0xfu << shift));              // and eax, ~field
+    if (shift) {
+        emit8(0xc1); emit8(0xe2); emit8(shift);         // shl edx, shift
+    }
+    emit8(0x09); emit8(0xd0);                           // or eax, edx
+    emit8(0x89); emit8(0x83); emit32(offsetof(PPUTypes::State, cr));   // mov [rbx + cr], eax
+}
+
+void PPUJIT::emitSetCR0() {
+    emit8(0x48); emit8(0x85); emit8(0xc0);  // test rax, rax
+    emitSetCRField(0, false);
+}
+
+void PPUJIT::emitAddPC(u32 val) {
+    emit8(0x48); emit8(0x81); emit8(0x83);
+    emit32(offsetof(PPUTypes::State, pc));
+    emit32(val);
+}
+
+void PPUJIT::emitCall(void* func, const Entry* entry) {
+#ifdef _WIN32
+    emit8(0x48); emit8(0xb9); emit64((u64)this);    // mov rcx, this
+    emit8(0x48); emit8(0xba); emit64((u64)entry);   // mov rdx, entry
+#else
+    emit8(0x48); emit8(0xbf); emit64((u64)this);    // mov rdi, this
+    emit8(0x48); emit8(0xbe); emit64((u64)entry);   // mov rsi, entry
+#endif
+    emit8(0x48); emit8(0xb8); emit64((u64)func);    // mov rax, func
+    emit8(0xff); emit8(0xd0);                       // call rax
+}
+
+void PPUJIT::emitCallHandler(const Entry* entry, int idx) {
+    emitCall((void*)&PPUJIT::callHandler, entry);
+
+    // Exit early if the handler asked to
+    emit8(0x84); emit8(0xc0);   // test al, al
+    emit8(0x74); u8* jz = code_ptr; emit8(0);   // jz skip
+    emit8(0xb8); emit32(idx + 1);   // mov eax, executed instructions
+    emitEpilogue();
+    *jz = code_ptr - jz - 1;
+}
+
+void PPUJIT::emitEpilogue() {
+#ifdef _WIN32
+    emit8(0x48); emit8(0x83); emit8(0xc4); emit8(0x20);     // add rsp, 32
+#endif
+    emit8(0x5b);    // pop rbx
+    emit8(0xc3);    // ret
+}
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <PPU/Backends/PPUCachedInterpreter.hpp>
+
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHONKYSTATION3_PPU_JIT
+#endif
+
+#ifdef CHONKYSTATION3_PPU_JIT
+
+// Circular dependency
+class PlayStation3;
+
+using namespace PPUTypes;
+
+// x86-64 recompiler.
+// Blocks are decoded by PPUCachedInterpreter, then each block is compiled to host code which works directly on the PPU state.
+// Simple integer instructions, compares, rlwinm and loads/stores are emitted natively, everything else is a call to the interpreter handler.
+// Loads and stores access the memory arena directly when the page flags allow it, otherwise they call the interpreter handler.
+// In compare mode every natively emitted instruction is also run through the interpreter and the resulting states are compared.
+class PPUJIT : public PPUCachedInterpreter {
+public:
+    PPUJIT(Memory& mem, PlayStation3* ps3, bool compare = false);
+    ~PPUJIT();
+    int step() override;
+    void invalidateBlocks(u32 addr, u32 size) override;
+    void invalidateAllBlocks() override;
+
+    static constexpr size_t CODE_BUFFER_SIZE = 64_MB;
+
+    using BlockFunc = u32 (*)();    // Returns the number of instructions executed
+    std::unordered_map<u32, BlockFunc> code_cache;
+
+private:
+    MAKE_LOG_FUNCTION(log, ppu_jit);
+
+    bool compare;
+    int depth = 0;  // Nested step() calls (runFunc)
+    u64 block_generation = 0;
+    PPUTypes::State saved_state;
+    PPUTypes::State expected_state;
+
+    u8* code_buffer = nullptr;
+    u8* code_ptr = nullptr;
+
+    BlockFunc getCode(u32 addr);
+    BlockFunc compile(Block& block);
+    bool compileNative(const Entry* entry, int idx, u32 pending_pc);
+    bool compileLoadStore(const Entry* entry, int idx, u32 pending_pc);
+
+    // Called from the generated code
+    static u8 callHandler(PPUJIT* jit, const Entry* entry);
+    static void compareBefore(PPUJIT* jit, const Entry* entry);
+    static void compareAfter(PPUJIT* jit, const Entry* entry);
+
+    // Emitter
+    void emit8(u8 val) { *code_ptr++ = val; }
+    void emit32(u32 val) { std::memcpy(code_ptr, &val, 4); code_ptr += 4; }
+    void emit64(u64 val) { std::memcpy(code_ptr, &val, 8); code_ptr += 8; }
+    void emitLoadGPR(u8 host_reg, int gpr);     // mov host_reg, [rbx + gprs[gpr]]
+    void emitStoreRAX(int gpr);                 // mov [rbx + gprs[gpr]], rax
+    void emitStoreGPR(u8 host_reg, int gpr);    // mov [rbx + gprs[gpr]], host_reg
+    void emitSetCRField(int n, bool is_unsigned);   // Sets CR field n from the host flags of a compare
+    void emitSetCR0();                          // Sets CR0 from the 64-bit result in rax
+    void emitAddPC(u32 val);                    // add qword [rbx + pc], val
+    void emitCall(void* func, const Entry* entry);
+    void emitCallHandler(const Entry* entry, int idx);  // Runs the instruction through the interpreter, exits the block if needed
+    void emitEpilogue();
+};
+
+#endif
@@ -18,6 +18,9 @@ public:
     PlayStation3* ps3;
     virtual int step(); // Returns number of cycles executed
     virtual void printCallStack() { printf("Callstack not available for PPU core\n"); }
+    // Backends which cache decoded code must drop it when the code is modified
+    virtual void invalidateBlocks(u32 addr, u32 size) {}
+    virtual void invalidateAllBlocks() {}
 
     void runFunc(u32 addr, u32 toc = 0, bool save_all_state = true);
 
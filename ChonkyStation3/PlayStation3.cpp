@@ -4,8 +4,16 @@ PlayStation3::PlayStation3(const fs::path& executable) : elf_parser(executable),
     // Load settings
     settings.load();
     
+    // Stores to reserved SPU lock lines make the SPU threads holding them lose their reservation
+    mem.reservation_handler = [this](u64 vaddr, u64 size) {
+        auto lock = spu_thread_manager.lock();
+        spu_thread_manager.reservationWritten(vaddr, size);
+    };
+    mem.page_write_handler = [this](u64 page) { rsx.pageWritten(page); };
+    
     createProcessors();
     createAudioDevice();
+    registerSchedulerEvents();
 
     module_manager.init();
 
@@ -55,6 +63,18 @@ void PlayStation3::loadGame(const GameLoader::InstalledGame& game) {
     elf_path_encrypted = (game.content_path / "USRDIR/EBOOT.BIN").generic_string();
 }
 
+void PlayStation3::registerSchedulerEvents() {
+    using EventType = Scheduler::EventType;
+    scheduler.setHandler(EventType::ThreadReschedule,    [this](u64) { thread_manager.reschedule(); });
+    scheduler.setHandler(EventType::ThreadWakeUp,        [](u64 thread) { ((Thread*)thread)->wakeUp(); });
+    scheduler.setHandler(EventType::ThreadTimeout,       [](u64 thread) { ((Thread*)thread)->timeoutEvent(); });
+    scheduler.setHandler(EventType::SPUThreadReschedule, [this](u64) { spu_thread_manager.reschedule(); });
+    scheduler.setHandler(EventType::SPUThreadWakeUp,     [](u64 thread) { ((SPUThread*)thread)->wakeUp(); });
+    scheduler.setHandler(EventType::SPULocklineLost,     [](u64 thread) { ((SPUThread*)thread)->sendLocklineLostEvent(); });
+    scheduler.setHandler(EventType::SPUDMAStep,          [](u64 thread) { ((SPUThread*)thread)->stepDMA(); });
+    scheduler.setHandler(EventType::Breakpoint,          [](u64) {});   // Set by the frontend
+}
+
 void PlayStation3::setFlipHandler(std::function<void(void)> const& handler) {
     flip_handler = handler;
 }
@@ -63,25 +83,19 @@ int PlayStation3::init() {
     // Only init if we aren't replaying an RSX capture (aka if we actually booted something)
     if (!rsx_capture_path.empty()) return 0;
     
-    // Use the pre-decrypted EBOOT.elf if present, otherwise decrypt it ourselves and delete it later
-    bool decrypted_self = false;
+    // Use the pre-decrypted EBOOT.elf if present, otherwise decrypt it ourselves (or get it from the ELF cache)
+    fs::path elf_to_load = elf_path;
     if (!fs::exists(elf_path)) {
         SELFToELF self = SELFToELF(this);
-        if (int e = self.makeELF(fs.guestPathToHost(elf_path_encrypted), elf_path))
+        if (int e = self.makeCachedELF(fs.guestPathToHost(elf_path_encrypted), elf_to_load))
             return e;
-        decrypted_self = true;
     }
     
     // Load ELF file
     ELFLoader elf = ELFLoader(this, mem);
     std::unordered_map<u32, u32> imports = {};
     ELFLoader::PROCParam proc_param;
-    auto entry = elf.load(elf_path, imports, proc_param, module_manager);
-    
-    // Delete the decrypted ELF if we decrypted it ourselves
-    if (decrypted_self) {
-        fs::remove(elf_path);
-    }
+    auto entry = elf.load(elf_to_load, imports, proc_param, module_manager);
 
     // Mount /app_home
     fs.mount(Filesystem::Device::APP_HOME, elf_path.parent_path());
@@ -169,18 +183,26 @@ void PlayStation3::step() {
     const int ppu_cycles = ppu->step();
     const int spu_cycles = spu->step();
 
+    // The scheduler and the thread managers are shared with the SPU host threads
+    auto lock = spu_thread_manager.lock();
     scheduler.tick(ppu_cycles + spu_cycles);
     curr_block_cycles += ppu_cycles;
     if (curr_block_cycles > reschedule_every_n_cycles) {
         curr_block_cycles = 0;
         thread_manager.reschedule();
         spu_thread_manager.reschedule();
-        if (rsx.hanged)  {
+        if (!rsx.threaded && rsx.hanged)  {
             //module_manager.cellGcmSys.ctrl->get = module_manager.cellGcmSys.ctrl->put;
             //module_manager.cellGcmSys.ctrl->get = module_manager.cellGcmSys.ctrl->get + 4;
             rsx.runCommandList();
         }
     }
+    
+    // Flips presented by the RSX thread. The guest flip handlers have to run on the PPU
+    if (rsx.pending_flips) {
+        rsx.pending_flips--;
+        flip();
+    }
 }
 
 void PlayStation3::printCrashInfo(std::runtime_error err) {
@@ -250,6 +272,7 @@ void PlayStation3::vblank() {
 
 // Returns whether or not there was a next event
 bool PlayStation3::skipToNextEvent() {
+    auto lock = spu_thread_manager.lock();
     u64 ticks;
     bool ok = scheduler.tickToNextEvent(ticks);
     if (ok) {
@@ -296,8 +319,32 @@ void PlayStation3::enableSPUOnPC(u32 unused) {
 }
 
 void PlayStation3::createProcessors() {
-    ppu = std::make_unique<PPUInterpreter>(mem, this);
-    spu = std::make_unique<SPUInterpreter>(this);
+    if (settings.cpu.ppu_backend == "JIT") {
+#ifdef CHONKYSTATION3_PPU_JIT
+        ppu = std::make_unique<PPUJIT>(mem, this, settings.debug.ppu_jit_compare);
+#else
+        printf("The PPU JIT is not supported on this platform, using the cached interpreter\n");
+        ppu = std::make_unique<PPUCachedInterpreter>(mem, this);
+#endif
+    }
+    else if (settings.cpu.ppu_backend == "CachedInterpreter")
+        ppu = std::make_unique<PPUCachedInterpreter>(mem, this);
+    else
+        ppu = std::make_unique<PPUInterpreter>(mem, this);
+    
+    spu = createSPU();
+    spu_thread_manager.threaded = settings.cpu.spu_host_threads;
+}
+
+std::unique_ptr<SPU> PlayStation3::createSPU() {
+    if (settings.cpu.spu_backend == "JIT") {
+#ifdef CHONKYSTATION3_SPU_JIT
+        return std::make_unique<SPUJIT>(this, settings.debug.spu_jit_compare);
+#else
+        printf("The SPU JIT is not supported on this platform, using the interpreter\n");
+#endif
+    }
+    return std::make_unique<SPUInterpreter>(this);
 }
 
 void PlayStation3::createAudioDevice() {
@@ -313,10 +360,9 @@ void PlayStation3::createAudioDevice() {
 }
 
 void PlayStation3::terminate() {
+    spu_thread_manager.stopHostThreads();
+    rsx.stopThread();
+    
     // Join audio thread
     module_manager.cellAudio.endAudioThread();
-
-    // Free memory
-    for (auto& i : mem.regions)
-        free(i->mem);
 }
@@ -9,8 +9,11 @@
 #include <Settings.hpp>
 #include <PPU.hpp>
 #include <PPU/Backends/PPUInterpreter.hpp>
+#include <PPU/Backends/PPUCachedInterpreter.hpp>
+#include <PPU/Backends/PPUJIT.hpp>
 #include <SPU.hpp>
 #include <SPU/Backends/SPUInterpreter.hpp>
+#include <SPU/Backends/SPUJIT.hpp>
 #include <RSX.hpp>
 #include <Memory.hpp>
 #include <ELF/ELFLoader.hpp>
@@ -88,6 +91,7 @@ public:
 
     std::string getCurrentUserID() { return "00000001"; }
     fs::path getCurrentUserHomeDir() { return "/dev_hdd0/home/" + getCurrentUserID(); }
+    fs::path getCacheDir() { return fs::path(SDL_GetPrefPath("ChonkyStation", "ChonkyStation3")) / "Cache"; }
 
     // Debugging
     void enableSPUOnPC(u32 unused);
@@ -95,7 +99,9 @@ public:
     std::string spu_thread_to_enable = "";
     
     void createProcessors();
+    std::unique_ptr<SPU> createSPU();   // Creates an SPU with the backend selected in the settings
     void createAudioDevice();
+    void registerSchedulerEvents();
     
 private:
     void terminate();
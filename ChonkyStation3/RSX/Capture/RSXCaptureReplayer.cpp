@@ -1,6 +1,10 @@
 #include "RSXCaptureReplayer.hpp"
 #include "PlayStation3.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
 
 void RSXCaptureReplayer::load(fs::path capture_dir) {
     log("Loading capture %s\n", capture_dir.generic_string().c_str());
@@ -76,10 +80,29 @@ void RSXCaptureReplayer::load(fs::path capture_dir) {
     }
 
     // Execute
+    // The first frame is where the shaders get decompiled and linked (unless they came from the disk cache),
+    // comparing it to the others shows the stutter of seeing shaders for the first time
     log("Done, executing...\n");
-    ps3->rsx.runCommandList();
-    ps3->flip();
-    ctrl->get = start_offs;
-    ps3->rsx.runCommandList();
-    ps3->flip();
+    std::vector<double> frame_times;
+    for (int i = 0; i < REPLAY_FRAMES; i++) {
+        ctrl->get = start_offs;
+        const auto start = std::chrono::steady_clock::now();
+        ps3->rsx.runCommandList();
+        ps3->flip();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        frame_times.push_back(elapsed.count());
+    }
+    printFrameTimes(frame_times);
+}
+
+void RSXCaptureReplayer::printFrameTimes(std::vector<double>& frame_times) {
+    const double first = frame_times[0];
+    const auto worst = std::max_element(frame_times.begin(), frame_times.end());
+    const double average = std::accumulate(frame_times.begin(), frame_times.end(), 0.0) / frame_times.size();
+    const int worst_frame = worst - frame_times.begin();
+    const double worst_time = *worst;
+    std::sort(frame_times.begin(), frame_times.end());
+    const double median = frame_times[frame_times.size() / 2];
+
+    printf("Replayed %d frames: first %.3f ms, worst %.3f ms (frame %d), average %.3f ms, median %.3f ms\n", (int)frame_times.size(), first, worst_time, worst_frame, average, median);
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <common.hpp>
 #include <logger.hpp>
 
+#include <vector>
+
 
 class PlayStation3;
 
@@ -15,7 +17,11 @@ public:
 
     static constexpr char CSCF_MAGIC[4] = { 'C', 'S', 'C', 'F' };
     static constexpr char CSCM_MAGIC[4] = { 'C', 'S', 'C', 'M' };
+    // The command list is replayed this many times, each replay is timed as a frame
+    static constexpr int REPLAY_FRAMES = 60;
 
 private:
     MAKE_LOG_FUNCTION(log, rsx_capture_replayer);
+
+    void printFrameTimes(std::vector<double>& frame_times);
 };
\ No newline at end of file
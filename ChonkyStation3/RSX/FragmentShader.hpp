@@ -14,7 +14,7 @@ public:
     u32 addr;
     u32 ctrl;
 
-    // Returns size of the fragment shader
+    // Returns size of the fragment shader, including the constant after the last instruction if it has one
     // TODO: when I implement control flow instructions, we need to analyze all possible code paths to find the actual size 
     u32 getSize(Memory& mem) {
         Helpers::debugAssert(addr != 0, "FragmentShader::getSize(): addr == 0\n");
@@ -23,20 +23,27 @@ public:
         while (true) {
             FragmentInstruction instr = fetchInstr(offs, mem);
             offs += sizeof(FragmentInstruction);
+            // Constants are stored inline, in the 16 bytes following the instruction that uses them
+            if (usesConstant(instr)) offs += sizeof(FragmentInstruction);
             if (instr.dst.end) break;
         }
         
         return offs - addr;
     }
 
-    u8* getData(Memory& mem) {
-        const auto size = getSize(mem);
+    u8* getData(Memory& mem) { return getData(mem, getSize(mem)); }
+
+    // Same as above, for callers that already know the size
+    u8* getData(Memory& mem, u32 size) {
         data.clear();
         data.resize(size);
         std::memcpy(data.data(), mem.getPtr(addr), size);
         return data.data();
     }
 
+    // The microcode copied by the last getData call
+    const std::vector<u8>& getCopiedData() const { return data; }
+
 private:
     std::vector<u8> data;
 
@@ -51,10 +58,16 @@ private:
         return instr;
     }
 
+    // Called on the RSX thread while the guest may be writing the program
     u32 fetch32(u32 addr, Memory& mem) {
-        const auto data = mem.read<u32>(addr);
+        const auto data = mem.readShared<u32>(addr);
         return swap(data);
     }
 
+    static bool usesConstant(const FragmentInstruction& instr) {
+        static constexpr u32 CONST = 2;
+        return instr.src0.type == CONST || instr.src1.type == CONST || instr.src2.type == CONST;
+    }
+
     static u32 swap(u32 v) { return (v >> 16) | (v << 16); }
 };
\ No newline at end of file
@@ -30,22 +30,10 @@ uniform sampler2D tex13;
 uniform sampler2D tex14;
 uniform sampler2D tex15;
 
-uniform bool flip_tex0;
-uniform bool flip_tex1;
-uniform bool flip_tex2;
-uniform bool flip_tex3;
-uniform bool flip_tex4;
-uniform bool flip_tex5;
-uniform bool flip_tex6;
-uniform bool flip_tex7;
-uniform bool flip_tex8;
-uniform bool flip_tex9;
-uniform bool flip_tex10;
-uniform bool flip_tex11;
-uniform bool flip_tex12;
-uniform bool flip_tex13;
-uniform bool flip_tex14;
-uniform bool flip_tex15;
+// Set when the texture is a framebuffer, which is upside down. flip_tex[i / 4][i % 4]
+layout (std140) uniform FragmentState {
+    ivec4 flip_tex[4];
+};
 
 )";
     std::string shader;
@@ -59,6 +47,7 @@ uniform bool flip_tex15;
     initialization = "";
     next_constant = 0;
 
+    curr_program = &shader_program;
     curr_offs = shader_program.addr;
     const bool float16_exports = !(shader_program.ctrl & 0x40); // CELL_GCM_SHADER_CONTROL_32_BITS_EXPORTS
     //const bool float16_exports = false;
@@ -169,13 +158,13 @@ uniform bool flip_tex15;
         }
         case RSXFragment::TEX: {
             const auto sampler = std::format("tex{:d}", (u32)instr.dst.tex_num);
-            const auto flip_tex = std::format("flip_tex{:d}", (u32)instr.dst.tex_num);
+            const auto flip_tex = std::format("(flip_tex[{:d}][{:d}] != 0)", (u32)instr.dst.tex_num / 4, (u32)instr.dst.tex_num % 4);
             decompiled_src = std::format("texture({}, vec2({}.x, {} ? (1.0f - {}.y) : {}.y))", sampler, source(instr, 0), flip_tex, source(instr, 0), source(instr, 0));
             break;
         }
         case RSXFragment::TXP: {
             const auto sampler = std::format("tex{:d}", (u32)instr.dst.tex_num);
-            const auto flip_tex = std::format("flip_tex{:d}", (u32)instr.dst.tex_num);
+            const auto flip_tex = std::format("(flip_tex[{:d}][{:d}] != 0)", (u32)instr.dst.tex_num / 4, (u32)instr.dst.tex_num % 4);
             decompiled_src = std::format("texture({}, vec2({}.x / {}.w, ({} ? (1.0f - {}.y) : {}.y)) / {}.w)", sampler, source(instr, 0), source(instr, 0), flip_tex, source(instr, 0), source(instr, 0), source(instr, 0));
             break;
         }
@@ -202,7 +191,7 @@ uniform bool flip_tex15;
         }
         case RSXFragment::TXB: {
             const auto sampler = std::format("tex{:d}", (u32)instr.dst.tex_num);
-            const auto flip_tex = std::format("flip_tex{:d}", (u32)instr.dst.tex_num);
+            const auto flip_tex = std::format("(flip_tex[{:d}][{:d}] != 0)", (u32)instr.dst.tex_num / 4, (u32)instr.dst.tex_num % 4);
             decompiled_src = std::format("/* TODO: TXB */ texture({}, vec2({}.x, {} ? (1.0f - {}.y) : {}.y))", sampler, source(instr, 0), flip_tex, source(instr, 0), source(instr, 0));
             break;
         }
@@ -271,7 +260,9 @@ uniform bool flip_tex15;
     shader_base += inputs + "\n";
     shader_base += regs + "\n";
     shader_base += constants + "\n";
-    shader_base += uniforms;
+    // Constants patched by the FIFO, RSX uploads them to a buffer owned by the program
+    if (!uniforms.empty())
+        shader_base += "layout (std140) uniform FragmentConstants {\n" + uniforms + "};\n";
     std::string full_shader = shader_base + "\n\n" + shader;
 
     log("Decompiled fragment shader:\n");
@@ -293,8 +284,15 @@ FragmentInstruction FragmentShaderDecompiler::fetchInstr(u32 addr) {
 }
 
 u32 FragmentShaderDecompiler::fetch32(u32 addr) {
-    const auto data = ps3->mem.read<u32>(addr);
-    return swap(data);
+    // Read from the copy of the microcode taken when the shader was hashed, decompilation runs on the shader workers
+    const auto& data = curr_program->getCopiedData();
+    const u32 offs = addr - curr_program->addr;
+    if (offs + sizeof(u32) > data.size())
+        Helpers::panic("FragmentShaderDecompiler: read at offset 0x%x is past the end of the program (0x%x bytes)\n", offs, (u32)data.size());
+
+    u32 word;
+    std::memcpy(&word, &data[offs], sizeof(u32));
+    return swap(Helpers::bswap<u32>(word));
 }
 
 std::string FragmentShaderDecompiler::addConstant(float x, float y, float z, float w) {
@@ -311,7 +309,7 @@ std::string FragmentShaderDecompiler::addUniform(u32 addr) {
         return name;
     
     uniform_names.push_back(name);
-    uniforms += "uniform vec4 " + name + ";\n";
+    uniforms += "    vec4 " + name + ";\n";
     log("Added uniform: %s\n", name.c_str());
     return name;
 }
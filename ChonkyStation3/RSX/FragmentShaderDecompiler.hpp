@@ -44,6 +44,7 @@ public:
     std::string getCond(FragmentInstruction& instr);
     bool hasCond(FragmentInstruction& instr);
 
+    const FragmentShader* curr_program = nullptr;
     u32 curr_offs = 0;
     std::string curr_const = "";    // The current instruction's constant. If multiple sources in 1 instruction are constants they will access the same constant
     int next_constant = 0;
@@ -1,6 +1,11 @@
 #include "RSX.hpp"
 #include "PlayStation3.hpp"
 
+// GL_KHR_parallel_shader_compile, glad was generated without extensions
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 
 RSX::RSX(PlayStation3* ps3) : ps3(ps3), gcm(ps3->module_manager.cellGcmSys), fragment_shader_decompiler(ps3) {
     std::memset(constants, 0, 512 * 4);
@@ -20,28 +25,18 @@ void RSX::initGL() {
     OpenGL::clearColor();
     OpenGL::clearDepth();
     vao.create();
-    vbo.create();
     vao.bind();
-    vbo.bind();
-    glGenBuffers(1, &ibo);
+    index_stream.create(GL_ELEMENT_ARRAY_BUFFER, INDEX_STREAM_SIZE);
+    vertex_stream.create(GL_ARRAY_BUFFER, VERTEX_STREAM_SIZE);     // Stays bound to GL_ARRAY_BUFFER
     glGenBuffers(1, &quad_ibo);
 
     OpenGL::setDepthFunc(OpenGL::DepthFunc::Lequal);
     OpenGL::disableScissor();
+    gl_state.scissor_test = false;
     OpenGL::setFillMode(OpenGL::FillMode::FillPoly);
     OpenGL::setBlendEquation(OpenGL::BlendEquation::Add);
     //glFrontFace(GL_CW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ibo);
-    quad_index_array.push_back(0);
-    quad_index_array.push_back(1);
-    quad_index_array.push_back(2);
-    quad_index_array.push_back(2);
-    quad_index_array.push_back(3);
-    quad_index_array.push_back(0);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_index_array.size() * 4, quad_index_array.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-
     fb.create();
 
     // Create depth texture
@@ -61,7 +56,30 @@ void RSX::initGL() {
     glGenBuffers(1, &vertex_consts_ubo);
     glBindBuffer(GL_UNIFORM_BUFFER, vertex_consts_ubo);
     glBufferData(GL_UNIFORM_BUFFER, 468 * 4 * sizeof(float), (void*)0, GL_STATIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 10, vertex_consts_ubo);
+    glBindBufferBase(GL_UNIFORM_BUFFER, VERTEX_CONSTANTS_BINDING, vertex_consts_ubo);
+
+    // Setup fragment state UBO (texture flip flags)
+    glGenBuffers(1, &fragment_state_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, fragment_state_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(uploaded_flip_tex), uploaded_flip_tex.data(), GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAGMENT_STATE_BINDING, fragment_state_ubo);
+
+    // Check if the driver can compile and link shaders in the background
+    GLint n_extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &n_extensions);
+    for (int i = 0; i < n_extensions; i++) {
+        const std::string_view ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (ext == "GL_KHR_parallel_shader_compile" || ext == "GL_ARB_parallel_shader_compile") {
+            parallel_shader_compile = true;
+            // Let the driver use as many threads as it wants
+            auto max_threads = (void (*)(GLuint))SDL_GL_GetProcAddress(ext == "GL_KHR_parallel_shader_compile" ? "glMaxShaderCompilerThreadsKHR" : "glMaxShaderCompilerThreadsARB");
+            if (max_threads) max_threads(0xffffffff);
+            break;
+        }
+    }
+    log("Parallel shader compile: %s\n", parallel_shader_compile ? "supported" : "not supported");
+
+    loadShaderCache();
 }
 
 void RSX::setEaTableAddr(u32 addr) {
@@ -70,13 +88,27 @@ void RSX::setEaTableAddr(u32 addr) {
 }
 
 u32 RSX::ioToEa(u32 offs) {
-    return ((u32)ps3->mem.read<u16>(ea_table + ((offs >> 20) * 2)) << 20) | (offs & 0xfffff);
+    return ((u32)ps3->mem.readShared<u16>(ea_table + ((offs >> 20) * 2)) << 20) | (offs & 0xfffff);
+}
+
+// put is written by the guest and get is read by it while the RSX thread runs, so they are accessed atomically.
+// The acquire on put pairs with the kick in putWritten, the release on get makes our reads of the FIFO happen before the guest reuses it
+u32 RSX::loadPut() {
+    return Helpers::bswap<u32>(std::atomic_ref<u32>(gcm.ctrl->put.val).load(std::memory_order_acquire));
+}
+
+u32 RSX::loadGet() {
+    return Helpers::bswap<u32>(std::atomic_ref<u32>(gcm.ctrl->get.val).load(std::memory_order_acquire));
+}
+
+void RSX::storeGet(u32 get) {
+    std::atomic_ref<u32>(gcm.ctrl->get.val).store(Helpers::bswap<u32>(get), std::memory_order_release);
 }
 
 u32 RSX::fetch32() {
-    const u32 addr = gcm.ctrl->get;
-    u32 data = ps3->mem.read<u32>(ioToEa(addr));
-    gcm.ctrl->get = gcm.ctrl->get + 4;  // Didn't overload += in BEField
+    const u32 addr = loadGet();
+    u32 data = ps3->mem.readShared<u32>(ioToEa(addr));
+    storeGet(addr + 4);
     return data;
 }
 
@@ -85,76 +117,242 @@ u32 RSX::offsetAndLocationToAddress(u32 offset, u8 location) {
     else return ioToEa(offset);
 }
 
-void RSX::compileProgram() {
-    RSXCache::CachedShader cached_shader;
-    // Hash the vertex and fragment shaders
-    const u64 hash_vertex = cache.computeHash((u8*)&vertex_shader_data[vertex_shader_start_idx * 4], 512 * 4 - vertex_shader_start_idx * 4);
-    const u64 hash_fragment = cache.computeHash(fragment_shader_program.getData(ps3->mem), fragment_shader_program.getSize(ps3->mem));
+// Returns whether the program is ready to draw with.
+// Shaders that weren't cached are decompiled on the shader workers. If GPU.SkipDrawsWhileCompiling is enabled, draws using a program
+// that isn't ready are skipped instead of waiting for it, and if the driver supports GL_KHR_parallel_shader_compile linking doesn't stall either
+bool RSX::compileProgram() {
+    // Hash the vertex and fragment shaders, if they changed since the last draw
+    invalidateWrittenPages();
+    if (vertex_program_dirty) {
+        hash_vertex = cache.computeHash((u8*)&vertex_shader_data[vertex_shader_start_idx * 4], 512 * 4 - vertex_shader_start_idx * 4);
+        vertex_program_dirty = false;
+    }
+    if (fragment_program_dirty) {
+        // Writes to the program set fragment_program_dirty again. Tracking starts before the copy,
+        // so that a write landing while we copy and hash is seen by the next draw instead of being lost
+        const u32 size = fragment_shader_program.getSize(ps3->mem);
+        ps3->mem.trackWrites(fragment_shader_program.addr, size);
+        u8* data = fragment_shader_program.getData(ps3->mem, size);
+        hash_fragment = cache.computeHash(data, size);
+        fragment_program_dirty = false;
+    }
 
     // Check if our shader program was cached first
     const u64 hash_program = cache.computeProgramHash(hash_vertex, hash_fragment);
-    if (!cache.getProgram(hash_program, program)) {
-        // Shader program wasn't cached, get vertex shader and fragment shader
-        if (!cache.getShader(hash_vertex, cached_shader)) {
-            // Shader wasn't cached, compile it and add it to the cache
-            auto vertex_shader = vertex_shader_decompiler.decompile(vertex_shader_data, vertex_shader_start_idx);
-            OpenGL::Shader new_shader;
-            if(!new_shader.create(vertex_shader, OpenGL::ShaderType::Vertex))
-                Helpers::panic("%s\nFailed to create vertex shader object", vertex_shader.c_str());
-            cache.cacheShader(hash_vertex, { new_shader });
-            vertex = new_shader;
-        }
-        else {
-            vertex = cached_shader.shader;
-        }
+    curr_program = cache.getProgram(hash_program);
+    if (!curr_program) {
+        auto it = pending_programs.find(hash_program);
+        if (it == pending_programs.end()) {
+            // Shader program wasn't cached, start decompiling the shaders we don't have yet.
+            // The jobs get their own copy of the decompilers and of the microcode, the FIFO keeps going while they run
+            OpenGL::Shader shader;
+            if (!pending_shaders.contains(hash_vertex) && !getCachedShader(hash_vertex, OpenGL::ShaderType::Vertex, shader)) {
+                std::vector<u32> data(vertex_shader_data, vertex_shader_data + 512 * 4);
+                pending_shaders[hash_vertex] = shader_workers.submit([decompiler = vertex_shader_decompiler, data, start = vertex_shader_start_idx]() mutable {
+                    return decompiler.decompile(data.data(), start);
+                });
+            }
 
-        if (!cache.getShader(hash_fragment, cached_shader)) {
-            // Shader wasn't cached, compile it and add it to the cache
-            auto fragment_shader = fragment_shader_decompiler.decompile(fragment_shader_program);
-            OpenGL::Shader new_shader;
-            if(!new_shader.create(fragment_shader, OpenGL::ShaderType::Fragment))
-                Helpers::panic("%s\nFailed to create fragment shader object", fragment_shader.c_str());
-            cache.cacheShader(hash_fragment, { new_shader });
-            fragment = new_shader;
-        }
-        else {
-            fragment = cached_shader.shader;
+            if (!pending_shaders.contains(hash_fragment) && !getCachedShader(hash_fragment, OpenGL::ShaderType::Fragment, shader)) {
+                // The copy of the decompiler takes the inputs and uniforms set up by the FIFO
+                pending_shaders[hash_fragment] = shader_workers.submit([decompiler = fragment_shader_decompiler, shader_program = fragment_shader_program]() mutable {
+                    return decompiler.decompile(shader_program);
+                });
+                fragment_shader_decompiler.uniforms = "";
+                fragment_shader_decompiler.uniform_names.clear();
+            }
+
+            it = pending_programs.emplace(hash_program, PendingProgram{ hash_vertex, hash_fragment }).first;
         }
-        
-        // Link and cache the shader program
-        OpenGL::Program new_program;
-        if (!new_program.create({ vertex, fragment })) {
-            //exit(0);
+
+        auto& pending = it->second;
+        const bool wait = !ps3->settings.gpu.skip_draws_while_compiling;
+        if (!pending.program.exists()) {
+            if (!getPendingShader(pending.hash_vertex, OpenGL::ShaderType::Vertex, wait, pending.vertex)) return false;
+            if (!getPendingShader(pending.hash_fragment, OpenGL::ShaderType::Fragment, wait, pending.fragment)) return false;
+            startLinking(pending.vertex, pending.fragment, pending.program);
         }
-        program = new_program;
-        program.use();
 
-        // Texture samplers
-        for (int i = 0; i < 16; i++) {
-            const int loc = glGetUniformLocation(program.handle(), std::format("tex{:d}", i).c_str());
-            glUniform1i(loc, i);
+        // Without the extension, querying anything about the program waits for the link to finish
+        if (!wait && parallel_shader_compile) {
+            GLint done;
+            glGetProgramiv(pending.program.handle(), GL_COMPLETION_STATUS_KHR, &done);
+            if (!done) return false;
         }
-        
-        // Vertex constants uniform buffer
-        const int block_idx = glGetUniformBlockIndex(program.handle(), "VertexConstants");
-        glUniformBlockBinding(program.handle(), block_idx, 10);
 
-        // Cache it
-        cache.cacheProgram(hash_program, new_program);
+        // Cache the shader program
+        if (finishLinking(pending.program))
+            shader_disk_cache.saveProgram(hash_program, pending.hash_vertex, pending.hash_fragment, pending.program);
+        RSXCache::CachedProgram new_program = { pending.program };
+        setupProgram(new_program);
+        curr_program = cache.cacheProgram(hash_program, new_program);
+        pending_programs.erase(it);
     }
     else {
-        program.use();
+        curr_program->program.use();
     }
     
     program_changed = last_program_hash != hash_program;
     last_program_hash = hash_program;
+    return true;
 }
 
-void RSX::setupVAO() {
-    log("Vertex configuration:\n");
+// Links every program in the game's shader cache, so that shaders seen in previous boots don't have to be compiled again when they are first used.
+// Program binaries the driver rejects are linked again from the cached GLSL
+void RSX::loadShaderCache() {
+    if (!ps3->settings.gpu.shader_disk_cache) return;
+
+    // Homebrew doesn't have a title ID, use the ELF path instead
+    std::string id = ps3->curr_game.id;
+    if (id.empty()) {
+        const auto elf_path = ps3->elf_path.generic_string();
+        id = std::format("{:016x}", XXH3_64bits(elf_path.data(), elf_path.size()));
+    }
+    shader_disk_cache.open(ps3->getCacheDir() / "Shaders" / id);
+
+    int n_loaded = 0;
+    int n_relinked = 0;
+    for (auto& [hash, entry] : shader_disk_cache.programs) {
+        OpenGL::Program new_program;
+        if (entry.driver_hash != shader_disk_cache.driver_hash || !new_program.createFromBinary(entry.binary.data(), entry.binary.size(), entry.format)) {
+            OpenGL::Shader vertex_shader, fragment_shader;
+            if (!getCachedShader(entry.hash_vertex, OpenGL::ShaderType::Vertex, vertex_shader) || !getCachedShader(entry.hash_fragment, OpenGL::ShaderType::Fragment, fragment_shader))
+                continue;
+            if (!linkProgram(vertex_shader, fragment_shader, new_program))
+                continue;
+            shader_disk_cache.saveProgram(hash, entry.hash_vertex, entry.hash_fragment, new_program);
+            n_relinked++;
+        }
+        RSXCache::CachedProgram cached = { new_program };
+        setupProgram(cached);
+        cache.cacheProgram(hash, cached);
+        n_loaded++;
+    }
+    shader_disk_cache.programs.clear();
+    log("Shader cache: loaded %d programs (%d relinked)\n", n_loaded, n_relinked);
+}
+
+// Looks for the shader in the in-memory cache first, then for its GLSL in the disk cache
+bool RSX::getCachedShader(u64 hash, OpenGL::ShaderType type, OpenGL::Shader& shader) {
+    RSXCache::CachedShader cached_shader;
+    if (cache.getShader(hash, cached_shader)) {
+        shader = cached_shader.shader;
+        return true;
+    }
+
+    std::string source;
+    if (!shader_disk_cache.getSource(hash, source)) return false;
+    shader = compileShader(hash, source, type);
+    return true;
+}
+
+OpenGL::Shader RSX::compileShader(u64 hash, const std::string& source, OpenGL::ShaderType type) {
+    OpenGL::Shader new_shader;
+    if (!new_shader.create(source, type))
+        Helpers::panic("%s\nFailed to create %s shader object", source.c_str(), type == OpenGL::ShaderType::Vertex ? "vertex" : "fragment");
+    cache.cacheShader(hash, { new_shader });
+    return new_shader;
+}
+
+// Gets a shader that is being decompiled on the shader workers, or was already compiled.
+// Returns false if the shader isn't ready and we don't want to wait for it
+bool RSX::getPendingShader(u64 hash, OpenGL::ShaderType type, bool wait, OpenGL::Shader& shader) {
+    auto it = pending_shaders.find(hash);
+    if (it == pending_shaders.end()) {
+        if (!getCachedShader(hash, type, shader))
+            Helpers::panic("RSX: shader %016llx is neither cached nor being decompiled\n", hash);
+        return true;
+    }
+
+    if (!wait && it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+    const std::string source = it->second.get();
+    pending_shaders.erase(it);
+    shader_disk_cache.saveSource(hash, source);
+    shader = compileShader(hash, source, type);
+    return true;
+}
+
+// Same as OpenGL::Program::create, but asks the driver to keep the program binary around for the shader cache
+bool RSX::linkProgram(OpenGL::Shader& vertex, OpenGL::Shader& fragment, OpenGL::Program& program) {
+    startLinking(vertex, fragment, program);
+    return finishLinking(program);
+}
+
+void RSX::startLinking(OpenGL::Shader& vertex, OpenGL::Shader& fragment, OpenGL::Program& program) {
+    program.m_handle = glCreateProgram();
+    glAttachShader(program.handle(), vertex.handle());
+    glAttachShader(program.handle(), fragment.handle());
+    glProgramParameteri(program.handle(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program.handle());
+}
+
+bool RSX::finishLinking(OpenGL::Program& program) {
+    GLint success;
+    glGetProgramiv(program.handle(), GL_LINK_STATUS, &success);
+    if (!success) {
+        char buf[4096];
+        glGetProgramInfoLog(program.handle(), 4096, nullptr, buf);
+        fprintf(stderr, "Failed to link program\nError: %s\n", buf);
+        glDeleteProgram(program.handle());
+        program.m_handle = 0;
+    }
+    return program.exists();
+}
+
+// Binds the texture samplers and uniform blocks of a newly linked (or loaded) program, and resolves the locations and offsets of
+// everything that is uploaded on draws
+void RSX::setupProgram(RSXCache::CachedProgram& cached) {
+    auto& program = cached.program;
+    if (!program.exists()) return;
+    const GLuint handle = program.handle();
+    program.use();
+
+    // Texture samplers
+    for (int i = 0; i < 16; i++) {
+        const int loc = glGetUniformLocation(handle, std::format("tex{:d}", i).c_str());
+        glUniform1i(loc, i);
+    }
     
-    u32 curr_offs = 0;
-    int vert_size = 0;
+    // Uniform buffers shared by every program
+    const GLuint vertex_consts_idx = glGetUniformBlockIndex(handle, "VertexConstants");
+    if (vertex_consts_idx != GL_INVALID_INDEX) glUniformBlockBinding(handle, vertex_consts_idx, VERTEX_CONSTANTS_BINDING);
+    const GLuint fragment_state_idx = glGetUniformBlockIndex(handle, "FragmentState");
+    if (fragment_state_idx != GL_INVALID_INDEX) glUniformBlockBinding(handle, fragment_state_idx, FRAGMENT_STATE_BINDING);
+
+    // Viewport transformation
+    cached.viewport_offs_loc  = glGetUniformLocation(handle, "viewport_offs");
+    cached.viewport_scale_loc = glGetUniformLocation(handle, "viewport_scale");
+    cached.surface_clip_loc   = glGetUniformLocation(handle, "surface_clip");
+
+    // Fragment constants patched by the FIFO live in a UBO owned by the program, find where each one of them ended up in it.
+    // The members are named uniform_<address of the constant>
+    const GLuint fragment_consts_idx = glGetUniformBlockIndex(handle, "FragmentConstants");
+    if (fragment_consts_idx == GL_INVALID_INDEX) return;
+
+    GLint size, n_uniforms;
+    glGetActiveUniformBlockiv(handle, fragment_consts_idx, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    glGetActiveUniformBlockiv(handle, fragment_consts_idx, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &n_uniforms);
+    std::vector<GLint> indices(n_uniforms);
+    std::vector<GLint> offsets(n_uniforms);
+    glGetActiveUniformBlockiv(handle, fragment_consts_idx, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+    glGetActiveUniformsiv(handle, n_uniforms, (const GLuint*)indices.data(), GL_UNIFORM_OFFSET, offsets.data());
+    for (int i = 0; i < n_uniforms; i++) {
+        char name[64];
+        glGetActiveUniformName(handle, indices[i], sizeof(name), nullptr, name);
+        const u32 addr = std::strtoul(name + std::strlen("uniform_"), nullptr, 16);
+        cached.fragment_constant_offsets[addr] = offsets[i];
+    }
+
+    glUniformBlockBinding(handle, fragment_consts_idx, FRAGMENT_CONSTANTS_BINDING);
+    std::vector<u8> zero(size, 0);
+    glGenBuffers(1, &cached.fragment_constants_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, cached.fragment_constants_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, size, zero.data(), GL_DYNAMIC_DRAW);
+}
+
+// Returns the size of a vertex as laid out by getVertices
+u32 RSX::getVertexSize() {
+    u32 vert_size = 0;
     for (auto& binding : vertex_array.bindings) {
         if (!binding.size) continue;
         vert_size += binding.size * binding.sizeOfComponent();
@@ -163,6 +361,14 @@ void RSX::setupVAO() {
         if (!binding.size) continue;
         vert_size += binding.size * binding.sizeOfComponent();
     }
+    return vert_size;
+}
+
+void RSX::setupVAO() {
+    log("Vertex configuration:\n");
+    
+    u32 curr_offs = 0;
+    const int vert_size = getVertexSize();
     
     for (auto& binding : vertex_array.bindings) {
         if (!binding.size) continue;
@@ -242,123 +448,123 @@ void RSX::setupVAO() {
     }
 }
 
+// Writes n_vertices vertices starting from start to ptr, with the attributes interleaved
 template <bool is_inline_array>
-void RSX::getVertices(u32 n_vertices, std::vector<u8>& vtx_buf, u32 start) {
-    auto fetch = [this]<typename T, bool inlined>(u32 addr, u32 size, u8* ptr) {
-        for (int i = 0; i < size; i++) {
-            if constexpr (!inlined) {
-                T data = ps3->mem.read<T>(addr + i * sizeof(T));
-                *(T*)ptr = data;
-            }
-            else {
-                *(T*)ptr = *(T*)&(((u8*)inline_array.data())[addr + i * sizeof(T)]);
-            }
-            
-            ptr += sizeof(T);
-        }
-    };
+void RSX::getVertices(u32 n_vertices, u8* ptr, u32 start) {
+    const u32 vert_size = getVertexSize();
+    u32 attrib_offs = 0;
     
-    int vert_size = 0;
     for (auto& binding : vertex_array.bindings) {
         if (!binding.size) continue;
-        vert_size += binding.size * binding.sizeOfComponent();
+        const auto n_components = binding.size;
+        const auto size_of_component = binding.sizeOfComponent();
+        const auto size_of_attrib = n_components * size_of_component;
+        const u32 addr = binding.offset + start * binding.stride;
+        
+        // Inline arrays were already byteswapped when they were fetched from the FIFO
+        const u8* src;
+        if constexpr (is_inline_array) {
+            // TODO: This shouldn't be necessary and might be the reason why graphics break in Minecraft
+            src = (const u8*)inline_array.data() + (addr - vertex_array.getBase());
+        }
+        else src = ps3->mem.getPtr(addr);
+        
+        VertexConverter::getConvertFunc(size_of_component, n_components, !is_inline_array)(src, binding.stride, ptr + attrib_offs, vert_size, n_vertices);
+        attrib_offs += size_of_attrib;
     }
+    
+    // Immediate attributes are the same for every vertex
     for (auto& binding : immediate_data.bindings) {
         if (!binding.size) continue;
-        vert_size += binding.size * binding.sizeOfComponent();
+        const auto size_of_attrib = binding.size * binding.sizeOfComponent();
+        for (u32 i = 0; i < n_vertices; i++)
+            std::memcpy(ptr + i * vert_size + attrib_offs, binding.data.data(), size_of_attrib);
+        attrib_offs += size_of_attrib;
     }
+}
+
+// Binds the quad index buffer, making sure it holds enough indices to draw n_vertices / 4 quads
+u32 RSX::bindQuadIndices(u32 n_vertices) {
+    const u32 n_quads = n_vertices / 4;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ibo);
     
-    u32 vtx_buf_offs = vtx_buf.size();
-    vtx_buf.resize(vtx_buf_offs + (vert_size * (n_vertices + start)));
-    
-    u8* ptr = &vtx_buf[vtx_buf_offs];
-    for (int i = start; i < n_vertices + start; i++) {
-        for (auto& binding : vertex_array.bindings) {
-            if (!binding.size) continue;
-            const auto n_components = binding.size;
-            const auto size_of_component = binding.sizeOfComponent();
-            const auto size_of_attrib = n_components * size_of_component;
-            u32 addr = binding.offset + i * binding.stride;
-            
-            // TODO: This shouldn't be necessary and might be the reason why graphics break in Minecraft
-            if (is_inline_array) addr -= vertex_array.getBase();
-            
-            switch (size_of_component) {
-            case sizeof(u8):
-                fetch.template operator()<u8, is_inline_array>(addr, n_components, ptr);
-                break;
-            case sizeof(u16):
-                fetch.template operator()<u16, is_inline_array>(addr, n_components, ptr);
-                break;
-            case sizeof(u32):
-                fetch.template operator()<u32, is_inline_array>(addr, n_components, ptr);
-                break;
-            case sizeof(u64):
-                fetch.template operator()<u64, is_inline_array>(addr, n_components, ptr);
-                break;
+    if (n_quads > quad_ibo_quads) {
+        quad_ibo_quads = std::max(n_quads, quad_ibo_quads * 2);
+        quad_index_array.clear();
+        quad_index_array.reserve(getQuadIndexCount(quad_ibo_quads));
+        for (int i = 0; i < quad_ibo_quads; i++) {
+            if (i > 0) {
+                quad_index_array.push_back(quad_index_array.back());
+                quad_index_array.push_back((i * 4) + 0);
             }
-            ptr += size_of_attrib;
-        }
-        
-        // TODO: This can be faster
-        for (auto& binding : immediate_data.bindings) {
-            if (!binding.size) continue;
-            const auto n_components = binding.size;
-            const auto size_of_component = binding.sizeOfComponent();
-            const auto size_of_attrib = n_components * size_of_component;
-            std::memcpy(ptr, binding.data.data(), size_of_attrib);
-            ptr += size_of_attrib;
+            
+            quad_index_array.push_back((i * 4) + 0);
+            quad_index_array.push_back((i * 4) + 1);
+            quad_index_array.push_back((i * 4) + 3);
+            quad_index_array.push_back((i * 4) + 2);
         }
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_index_array.size() * 4, quad_index_array.data(), GL_STATIC_DRAW);
     }
+    return getQuadIndexCount(n_quads);
 }
 
 void RSX::uploadVertexConstants() {
     // Viewport data
     if (viewport_offs_dirty || program_changed) {
         viewport_offs_dirty = false;
-        glUniform3f(glGetUniformLocation(program.handle(), "viewport_offs"), viewport_offs[0], viewport_offs[1], viewport_offs[2]);
+        glUniform3f(curr_program->viewport_offs_loc, viewport_offs[0], viewport_offs[1], viewport_offs[2]);
     }
     if (viewport_scale_dirty || program_changed) {
         viewport_scale_dirty = false;
-        glUniform3f(glGetUniformLocation(program.handle(), "viewport_scale"), viewport_scale[0], viewport_scale[1], viewport_scale[2]);
+        glUniform3f(curr_program->viewport_scale_loc, viewport_scale[0], viewport_scale[1], viewport_scale[2]);
     }
     if (surface_clip_dirty || program_changed) {
         surface_clip_dirty = false;
-        glUniform2i(glGetUniformLocation(program.handle(), "surface_clip"), surface_clip[0], surface_clip[1]);
+        glUniform2i(curr_program->surface_clip_loc, surface_clip[0], surface_clip[1]);
     }
 
-    if (!constants_dirty) return;
-    constants_dirty = false;
+    if (constants_dirty_begin >= constants_dirty_end) return;
     
-    // Constants
-    glBindBuffer(GL_UNIFORM_BUFFER, vertex_consts_ubo); // I don't think I need to rebind this here
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, 468 * 4 * sizeof(float), constants);
+    // Constants, only the ones that were written since the last upload
+    const u32 offs = constants_dirty_begin * 4 * sizeof(float);
+    const u32 size = (constants_dirty_end - constants_dirty_begin) * 4 * sizeof(float);
+    glBindBuffer(GL_UNIFORM_BUFFER, vertex_consts_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offs, size, &constants[constants_dirty_begin * 4]);
+    constants_dirty_begin = 468;
+    constants_dirty_end = 0;
 }
 
 void RSX::uploadFragmentUniforms() {
-    // Fragment uniforms
-    for (auto& i : fragment_uniforms) {
-        glUniform4f(glGetUniformLocation(program.handle(), i.name.c_str()), i.x, i.y, i.z, i.w);
+    // Fragment constants patched by the FIFO, each program has its own buffer for them
+    if (curr_program->fragment_constants_ubo) {
+        if (program_changed)
+            glBindBufferBase(GL_UNIFORM_BUFFER, FRAGMENT_CONSTANTS_BINDING, curr_program->fragment_constants_ubo);
+        
+        if (fragment_uniforms.size()) {
+            glBindBuffer(GL_UNIFORM_BUFFER, curr_program->fragment_constants_ubo);
+            for (auto& i : fragment_uniforms) {
+                auto it = curr_program->fragment_constant_offsets.find(i.addr);
+                if (it == curr_program->fragment_constant_offsets.end()) continue;
+                const float v[4] = { i.x, i.y, i.z, i.w };
+                glBufferSubData(GL_UNIFORM_BUFFER, it->second, sizeof(v), v);
+            }
+        }
     }
     fragment_uniforms.clear();
 
-    for (int i = 0; i < 16; i++) {
-        glUniform1i(glGetUniformLocation(program.handle(), std::format("flip_tex{:d}", i).c_str()), should_flip_textures[i] ? GL_TRUE : GL_FALSE);
+    // Texture flip flags are shared by every program, only upload them when they change
+    std::array<s32, 16> flip_tex;
+    for (int i = 0; i < 16; i++) flip_tex[i] = should_flip_textures[i];
+    if (flip_tex != uploaded_flip_tex) {
+        uploaded_flip_tex = flip_tex;
+        glBindBuffer(GL_UNIFORM_BUFFER, fragment_state_ubo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(flip_tex), flip_tex.data());
     }
 }
 
 void RSX::uploadTexture() {
-    auto get_bytes_per_pixel = [this](u32 raw_fmt) -> u32 {
-        switch (raw_fmt) {
-        case CELL_GCM_TEXTURE_B8:       return 1;
-        case CELL_GCM_TEXTURE_R5G6B5:   return 2;
-        case CELL_GCM_TEXTURE_G8B8:     return 2;
-        default:                        return 4;
-        }
-    };
-    
-    auto get_pitch = [this, get_bytes_per_pixel](Texture& texture, u32 raw_fmt) -> u32 {
-        return texture.tex_pitch / get_bytes_per_pixel(raw_fmt);
+    auto get_pitch = [this](Texture& texture, u32 raw_fmt) -> u32 {
+        return texture.tex_pitch / getTextureBytesPerPixel(raw_fmt);
     };
     
     auto swizzle = [this](Texture& texture, bool should_flip_tex) {
@@ -394,6 +600,8 @@ void RSX::uploadTexture() {
         tex_swizzle_b = GL_BLUE;
     };
 
+    invalidateWrittenPages();
+    
     for (int i = 0; i < 16; i++) {
         auto& texture = textures[i];
         if (!texture.addr) continue;
@@ -402,9 +610,8 @@ void RSX::uploadTexture() {
         auto& last_tex = last_textures[i];
         bool& should_flip_tex = should_flip_textures[i];
         
-        // Don't do anything if the current texture is the same as the last one
-        // TODO: This will break if a game uploads a different texture but with the same format, width and height to the same address as the previous texture.
-        // I'm unsure how common that is. Probably make this toggleable in the future in case some games break
+        // Don't do anything if the current texture is the same as the last one.
+        // Writes to the texture's pages reset last_tex (see invalidateWrittenPages)
         if (texture == last_tex) {
            continue;
         }
@@ -426,16 +633,29 @@ void RSX::uploadTexture() {
         should_flip_tex = false;
         
         // Texture cache
-        const u64 hash = cache.computeTextureHash(ps3->mem.getPtr(texture.addr), texture.width, texture.height, 4);    // TODO: don't hardcode
-        if (!cache.getTexture(hash, cached_texture)) {
+        const RSXCache::TextureKey key = { texture.addr, texture.tex_pitch, texture.width, texture.height, texture.format };
+        RSXCache::CachedTexture* cached = cache.getTexture(key);
+        if (!cached || cached->stale) {
             const auto raw_fmt = getRawTextureFormat(texture.format);
             const auto fmt = getTexturePixelFormat(texture.format);
             const auto internal = getTextureInternalFormat(texture.format);
             const auto type = getTextureDataType(texture.format);
             
-            glGenTextures(1, &cached_texture.m_handle);
+            // Stale textures are uploaded again to the same GL texture
+            if (!cached) {
+                glGenTextures(1, &cached_texture.m_handle);
+                cached = cache.cacheTexture(key, cached_texture);
+            }
+            else log("Texture at 0x%08x was written, uploading it again\n", texture.addr);
+            
+            // Watch the texture's pages for writes. This is done before reading the texture so that writes racing with the upload aren't lost
+            const u32 size = getTextureSize(texture);
+            cached->stale = false;
+            cache.addTexturePages(key, size);
+            ps3->mem.trackWrites(texture.addr, size);
+            
             glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, cached_texture.m_handle);
+            glBindTexture(GL_TEXTURE_2D, cached->texture.m_handle);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -451,24 +671,24 @@ void RSX::uploadTexture() {
                 u8* unswizzled_tex = nullptr;
                 // Handle swizzling
                 if ((texture.format & CELL_GCM_TEXTURE_LN) == CELL_GCM_TEXTURE_SZ) {
-                    const u32 pixel_size = get_bytes_per_pixel(raw_fmt);
-                    unswizzled_tex = new u8[texture.width * texture.height * pixel_size];
-                    swizzleTexture(tex_ptr, unswizzled_tex, texture.width, texture.height, pixel_size);
+                    const u32 pixel_size = getTextureBytesPerPixel(raw_fmt);
+                    if (swizzle_buffer.size() < texture.width * texture.height * pixel_size)
+                        swizzle_buffer.resize(texture.width * texture.height * pixel_size);
+                    unswizzled_tex = swizzle_buffer.data();
+                    swizzler.unswizzle(tex_ptr, unswizzled_tex, texture.width, texture.height, pixel_size);
                 } else {
                     glPixelStorei(GL_UNPACK_ROW_LENGTH, get_pitch(texture, raw_fmt));
                 }
                 
                 glTexImage2D(GL_TEXTURE_2D, 0, internal, texture.width, texture.height, 0, fmt, type, (void*)(!unswizzled_tex ? tex_ptr : unswizzled_tex));
                 //checkGLError();
-                
-                delete[] unswizzled_tex;
             }
             else {
                 glCompressedTexImage2D(GL_TEXTURE_2D, 0, internal, texture.width, texture.height, 0, getCompressedTextureSize(texture.format, texture.width, texture.height), (void*)ps3->mem.getPtr(texture.addr));
             }
-            cache.cacheTexture(hash, cached_texture);
             //lodepng::encode(std::format("./{:08x}.png", texture.addr).c_str(), ps3->mem.getPtr(texture.addr), texture.width, texture.height);
         }
+        cached_texture = cached->texture;
         glActiveTexture(GL_TEXTURE0 + i);
         glPixelStorei(GL_UNPACK_SWAP_BYTES, GL_FALSE);
         
@@ -481,44 +701,76 @@ void RSX::uploadTexture() {
     //checkGLError();
 }
 
-void RSX::swizzleTexture(u8* src, u8* dst, u32 width, u32 height, u32 pixel_size) {
-    auto swizzle = [pixel_size](u32 x, u32 y, u32 z, u32 log2_width, u32 log2_height, u32 log2_depth) {
-        u32 offs = 0;
-
-        u32 shift_count = 0;
-        while (log2_width | log2_height | log2_depth) {
-            if (log2_width) {
-                offs |= (x & 0x01) << shift_count;
-                x >>= 1;
-                shift_count++;
-                log2_width--;
-            }
-            if (log2_height) {
-                offs |= (y & 0x01) << shift_count;
-                y >>= 1;
-                shift_count++;
-                log2_height--;
-            }
-            if (log2_depth) {
-                offs |= (z & 0x01) << shift_count;
-                z >>= 1;
-                shift_count++;
-                log2_depth--;
-            }
-        }
-
-        return offs * pixel_size;
-    };
-
-    const u32 log2_width = std::log2(width);
-    const u32 log2_height = std::log2(height);
+// Called by Memory when a page holding cached textures is written.
+// This runs on the thread that did the write, the RSX thread picks the page up in the next uploadTexture.
+void RSX::pageWritten(u64 page) {
+    {
+        std::lock_guard<std::mutex> lock(written_pages_mutex);
+        written_pages.push_back(page);
+        has_written_pages = true;
+    }
+    
+    // Might be the semaphore the RSX thread is waiting on
+    if (waiting_on_semaphore) {
+        std::lock_guard<std::mutex> lock(fifo_mutex);
+        semaphore_cv.notify_all();
+    }
+}
 
-    for (u32 y = 0; y < height; y++) {
-        for (u32 x = 0; x < width; x++) {
-            const u32 offs = swizzle(x, y, 0, log2_width, log2_height, 0);
-            std::memcpy(&dst[y * width * pixel_size + x * pixel_size], &src[offs], pixel_size);
+void RSX::invalidateWrittenPages() {
+    if (!has_written_pages.exchange(false)) return;
+    std::lock_guard<std::mutex> lock(written_pages_mutex);
+    for (auto page : written_pages) {
+        cache.invalidateTexturePage(page);
+
+        // The fragment program has to be hashed again
+        const u64 page_start = page << PAGE_SHIFT;
+        const u32 fragment_program_size = fragment_shader_program.getCopiedData().size();
+        if (fragment_shader_program.addr < page_start + PAGE_SIZE && page_start < (u64)fragment_shader_program.addr + fragment_program_size)
+            fragment_program_dirty = true;
+        
+        // Make uploadTexture look at units bound to textures in the page again
+        for (auto& last_tex : last_textures) {
+            if (!last_tex.addr) continue;
+            if (last_tex.addr < page_start + PAGE_SIZE && page_start < (u64)last_tex.addr + getTextureSize(last_tex))
+                last_tex.addr = 0;
         }
     }
+    written_pages.clear();
+}
+
+u32 RSX::getTextureBytesPerPixel(u32 raw_fmt) {
+    switch (raw_fmt) {
+    case CELL_GCM_TEXTURE_B8:                       return 1;
+    case CELL_GCM_TEXTURE_A1R5G5B5:                 return 2;
+    case CELL_GCM_TEXTURE_A4R4G4B4:                 return 2;
+    case CELL_GCM_TEXTURE_R5G6B5:                   return 2;
+    case CELL_GCM_TEXTURE_G8B8:                     return 2;
+    case CELL_GCM_TEXTURE_COMPRESSED_B8R8_G8R8:     return 2;
+    case CELL_GCM_TEXTURE_COMPRESSED_R8B8_R8G8:     return 2;
+    case CELL_GCM_TEXTURE_R6G5B5:                   return 2;
+    case CELL_GCM_TEXTURE_DEPTH16:                  return 2;
+    case CELL_GCM_TEXTURE_DEPTH16_FLOAT:            return 2;
+    case CELL_GCM_TEXTURE_X16:                      return 2;
+    case CELL_GCM_TEXTURE_R5G5B5A1:                 return 2;
+    case CELL_GCM_TEXTURE_COMPRESSED_HILO8:         return 2;
+    case CELL_GCM_TEXTURE_COMPRESSED_HILO_S8:       return 2;
+    case CELL_GCM_TEXTURE_D1R5G5B5:                 return 2;
+    case CELL_GCM_TEXTURE_W16_Z16_Y16_X16_FLOAT:    return 8;
+    case CELL_GCM_TEXTURE_W32_Z32_Y32_X32_FLOAT:    return 16;
+    default:                                        return 4;
+    }
+}
+
+// Returns the size in bytes of the texture data in memory
+u32 RSX::getTextureSize(Texture& texture) {
+    if (isCompressedFormat(texture.format))
+        return getCompressedTextureSize(texture.format, texture.width, texture.height);
+    
+    const u32 bpp = getTextureBytesPerPixel(getRawTextureFormat(texture.format));
+    if ((texture.format & CELL_GCM_TEXTURE_LN) == CELL_GCM_TEXTURE_SZ)
+        return texture.width * texture.height * bpp;
+    return std::max<u32>(texture.tex_pitch, texture.width * bpp) * texture.height;
 }
 
 void RSX::bindBuffer() {
@@ -551,15 +803,75 @@ void RSX::bindBuffer() {
     glActiveTexture(GL_TEXTURE0 + 0);
 }
 
-void RSX::setupForDrawing() {
-    compileProgram();
+// Returns false if the draw has to be skipped because its shaders aren't ready yet
+bool RSX::setupForDrawing() {
+    if (!compileProgram()) return false;
     setupVAO();
     uploadTexture();
     uploadVertexConstants();
     uploadFragmentUniforms();
     bindBuffer();
-    OpenGL::enableScissor();
-    OpenGL::setScissor(scissor_x, 720 - (scissor_y + scissor_height), scissor_width, scissor_height);
+    frame_draws++;
+    return true;
+}
+
+void RSX::flushRenderState() {
+    if (!render_state_dirty) return;
+    auto& rs = render_state;
+    auto& gs = gl_state;
+
+    if ((render_state_dirty & DIRTY_BLEND_ENABLE) && rs.blend_enable != gs.blend_enable) {
+        if (rs.blend_enable) OpenGL::enableBlend();
+        else OpenGL::disableBlend();
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_BLEND_FUNC) && (rs.blend_sfactor_rgb != gs.blend_sfactor_rgb || rs.blend_dfactor_rgb != gs.blend_dfactor_rgb || rs.blend_sfactor_a != gs.blend_sfactor_a || rs.blend_dfactor_a != gs.blend_dfactor_a)) {
+        glBlendFuncSeparate(rs.blend_sfactor_rgb, rs.blend_dfactor_rgb, rs.blend_sfactor_a, rs.blend_dfactor_a);
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_BLEND_COLOR) && rs.blend_color != gs.blend_color) {
+        glBlendColor(((rs.blend_color >> 0) & 0xff) / 255.0f, ((rs.blend_color >> 8) & 0xff) / 255.0f, ((rs.blend_color >> 16) & 0xff) / 255.0f, ((rs.blend_color >> 24) & 0xff) / 255.0f);
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_BLEND_EQUATION) && (rs.blend_equation_rgb != gs.blend_equation_rgb || rs.blend_equation_alpha != gs.blend_equation_alpha)) {
+        glBlendEquationSeparate(rs.blend_equation_rgb, rs.blend_equation_alpha);
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_DEPTH_TEST) && rs.depth_test != gs.depth_test) {
+        if (rs.depth_test) OpenGL::enableDepth();
+        else OpenGL::disableDepth();
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_DEPTH_FUNC) && rs.depth_func != gs.depth_func) {
+        glDepthFunc(rs.depth_func);
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_DEPTH_MASK) && rs.depth_mask != gs.depth_mask) {
+        glDepthMask(rs.depth_mask ? GL_TRUE : GL_FALSE);
+        frame_state_calls++;
+    }
+    if ((render_state_dirty & DIRTY_CULL_FACE) && rs.cull_face != gs.cull_face) {
+        if (rs.cull_face) {
+            //glEnable(GL_CULL_FACE);
+            glCullFace(GL_BACK);
+        }
+        else glDisable(GL_CULL_FACE);
+        frame_state_calls++;
+    }
+    if (render_state_dirty & DIRTY_SCISSOR) {
+        if (rs.scissor_test != gs.scissor_test) {
+            if (rs.scissor_test) OpenGL::enableScissor();
+            else OpenGL::disableScissor();
+            frame_state_calls++;
+        }
+        if (rs.scissor_x != gs.scissor_x || rs.scissor_y != gs.scissor_y || rs.scissor_width != gs.scissor_width || rs.scissor_height != gs.scissor_height) {
+            OpenGL::setScissor(rs.scissor_x, 720 - (rs.scissor_y + rs.scissor_height), rs.scissor_width, rs.scissor_height);
+            frame_state_calls++;
+        }
+    }
+
+    gl_state = render_state;
+    render_state_dirty = 0;
 }
 
 GLuint RSX::getTextureInternalFormat(u8 fmt) {
@@ -694,13 +1006,86 @@ GLuint RSX::getBlendFactor(u16 fact) {
 
 void RSX::putWritten(u64 unused) {
     //ps3->scheduler.push(std::bind(&RSX::runCommandList, this), 2500);
-    runCommandList();
-    
+    if (threaded) kick();
+    else runCommandList();
+}
+
+void RSX::flush() {
+    if (!threaded) {
+        runCommandList();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(fifo_mutex);
+    const u64 target = ++kick_count;
+    fifo_cv.notify_one();
+    // Don't wait on the RSX if it's waiting on us
+    idle_cv.wait(lock, [&]() { return done_count >= target || exit_thread || waiting_on_semaphore; });
+}
+
+void RSX::kick() {
+    {
+        std::lock_guard<std::mutex> lock(fifo_mutex);
+        kick_count++;
+    }
+    fifo_cv.notify_one();
+}
+
+void RSX::startThread(std::function<void(void)> const& make_context_current, std::function<void(void)> const& present) {
+    present_handler = present;
+    exit_thread = false;
+    threaded = true;
+    rsx_thread = std::thread(&RSX::rsxThread, this, make_context_current);
+}
+
+void RSX::stopThread() {
+    if (!rsx_thread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(fifo_mutex);
+        exit_thread = true;
+    }
+    fifo_cv.notify_one();
+    idle_cv.notify_all();
+
+    // We can end up here from the RSX thread if it crashed
+    if (rsx_thread.get_id() == std::this_thread::get_id())
+        rsx_thread.detach();
+    else
+        rsx_thread.join();
+}
+
+void RSX::rsxThread(std::function<void(void)> make_context_current) {
+    try {
+        make_context_current();
+        initGL();
+
+        std::unique_lock<std::mutex> lock(fifo_mutex);
+        const auto has_work = [this]() { return exit_thread || kick_count != done_count; };
+        while (true) {
+            // If the FIFO hanged on a jump to itself, the game might patch the jump without writing put, so retry every now and then.
+            // This replaces the retry in PlayStation3::step() for the non-threaded RSX
+            if (hanged) fifo_cv.wait_for(lock, std::chrono::milliseconds(1), has_work);
+            else fifo_cv.wait(lock, has_work);
+            if (exit_thread) break;
+
+            const u64 target = kick_count;
+            lock.unlock();
+            runCommandList();
+            lock.lock();
+            done_count = target;
+            idle_cv.notify_all();
+        }
+    }
+    catch (std::runtime_error e) {
+        printf("RSX thread crashed\n");
+        ps3->printCrashInfo(e);
+    }
 }
 
 void RSX::runCommandList() {
     log("Executing commands\n");
-    log("get: 0x%08x, put: 0x%08x\n", (u32)gcm.ctrl->get, (u32)gcm.ctrl->put);
+    log("get: 0x%08x, put: 0x%08x\n", loadGet(), loadPut());
 
     /*
     if (hanged)
@@ -719,7 +1104,7 @@ void RSX::runCommandList() {
 
     // Execute while get != put
     // We increment get as we fetch data from the FIFO
-    while (gcm.ctrl->get != gcm.ctrl->put) {
+    while (loadGet() != loadPut() && !exit_thread) {
         // Check if we timed out
         if (std::chrono::steady_clock::now() - start > timeout) {
             log("RSX timed out\n");
@@ -732,49 +1117,49 @@ void RSX::runCommandList() {
 
         if (cmd & 0xa0030003) {
             if ((cmd & 0xe0000003) == 0x20000000) { // jump
-                const u32 old_get = gcm.ctrl->get - 4;
-                gcm.ctrl->get = cmd & 0x1ffffffc;
-                log("0x%08x: Jump to 0x%08x (cmd: 0x%08x)\n", old_get, (u32)gcm.ctrl->get, cmd);
+                const u32 old_get = loadGet() - 4;
+                storeGet(cmd & 0x1ffffffc);
+                log("0x%08x: Jump to 0x%08x (cmd: 0x%08x)\n", old_get, loadGet(), cmd);
 
                 // Detect hangs
-                if (gcm.ctrl->get == last_jump_dst && old_get == last_jump_addr) {
+                if (loadGet() == last_jump_dst && old_get == last_jump_addr) {
                     log("RSX hanged, aborting...\n");
                     hanged = true;
                     //exit(0);
                     break;
                 }
                 last_jump_addr = old_get;
-                last_jump_dst = gcm.ctrl->get;
+                last_jump_dst = loadGet();
                 continue;
             }
 
             if ((cmd & 0xe0000003) == 0x00000001) { // jump
-                const u32 old_get = gcm.ctrl->get - 4;
-                gcm.ctrl->get = cmd & 0xfffffffc;
-                log("0x%08x: Jump to 0x%08x\n", old_get, (u32)gcm.ctrl->get);
+                const u32 old_get = loadGet() - 4;
+                storeGet(cmd & 0xfffffffc);
+                log("0x%08x: Jump to 0x%08x\n", old_get, loadGet());
                 
                 // Detect hangs
-                if (gcm.ctrl->get == last_jump_dst && old_get == last_jump_addr) {
+                if (loadGet() == last_jump_dst && old_get == last_jump_addr) {
                     log("RSX hanged, aborting...\n");
                     hanged = true;
                     exit(0);
                     break;
                 }
                 last_jump_addr = old_get;
-                last_jump_dst = gcm.ctrl->get;
+                last_jump_dst = loadGet();
                 continue;
             }
 
             if ((cmd & 0x00000003) == 0x00000002) { // call
-                call_stack.push(gcm.ctrl->get);
-                gcm.ctrl->get = cmd & 0x1ffffffc;
-                log("Call 0x%08x\n", (u32)gcm.ctrl->get);
+                call_stack.push(loadGet());
+                storeGet(cmd & 0x1ffffffc);
+                log("Call 0x%08x\n", loadGet());
                 continue;
             }
 
             if ((cmd & 0xffff0003) == 0x00020000) { // return
                 Helpers::debugAssert(call_stack.size(), "RSX: Tried to return but the call stack was empty\n");
-                gcm.ctrl->get = call_stack.top();
+                storeGet(call_stack.top());
                 call_stack.pop();
                 log("Return\n");
                 continue;
@@ -788,7 +1173,7 @@ void RSX::runCommandList() {
         bool incrementing = !(cmd & 0x40000000);    // CELL_GCM_METHOD_FLAG_NON_INCREMENT
         do {
             if (command_names.contains(cmd_num) && cmd_num)
-                log("0x%08x: %s\n", (u32)gcm.ctrl->get - 4, command_names[cmd_num].c_str());
+                log("0x%08x: %s\n", loadGet() - 4, command_names[cmd_num].c_str());
             doCmd(cmd_num, args);
             if (incrementing) cmd_num += 4;
         } while (!args.empty());
@@ -800,7 +1185,7 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
 
     case NV406E_SET_REFERENCE: {
         log("ref: 0x%08x\n", args[0]);
-        gcm.ctrl->ref = args[0];
+        std::atomic_ref<u32>(gcm.ctrl->ref.val).store(Helpers::bswap<u32>(args[0]), std::memory_order_release);
         args.pop_front();
         break;
     }
@@ -814,20 +1199,31 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
 
     case NV4097_BACK_END_WRITE_SEMAPHORE_RELEASE: {
         const u32 val = (args[0] & 0xff00ff00) | ((args[0] & 0xff) << 16) | ((args[0] >> 16) & 0xff);
-        ps3->mem.write<u32>(gcm.label_addr + semaphore_offset, val);
+        releaseSemaphore(val);
         args.pop_front();
         break;
     }
 
     case NV406E_SEMAPHORE_RELEASE:
     case NV4097_TEXTURE_READ_SEMAPHORE_RELEASE: {
-        ps3->mem.write<u32>(gcm.label_addr + semaphore_offset, args[0]);
+        releaseSemaphore(args[0]);
         args.pop_front();
         break;
     }
 
     case NV406E_SEMAPHORE_ACQUIRE: {
-        const auto sema = ps3->mem.read<u32>(gcm.label_addr + semaphore_offset);
+        const u32 addr = gcm.label_addr + semaphore_offset;
+        auto sema = ps3->mem.readShared<u32>(addr);
+        // On the RSX thread we can actually wait for the PPU/SPUs to release the semaphore
+        if (threaded && sema != args[0]) {
+            {
+                std::lock_guard<std::mutex> lock(fifo_mutex);
+                waiting_on_semaphore = true;
+            }
+            idle_cv.notify_all();
+            sema = waitForSemaphore(addr, args[0]);
+            waiting_on_semaphore = false;
+        }
         if (sema != args[0]) {
             //Helpers::panic("Could not acquire semaphore\n");
         }
@@ -901,72 +1297,63 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     }
 
     case NV4097_SET_BLEND_ENABLE: {
-        if (args[0]) {
-            log("Enabled blending\n");
-            OpenGL::enableBlend();
-        }
-        else {
-            log("Disabled blending\n");
-            OpenGL::disableBlend();
-        }
+        render_state.blend_enable = args[0];
+        render_state_dirty |= DIRTY_BLEND_ENABLE;
+        log("%s blending\n", args[0] ? "Enabled" : "Disabled");
         args.pop_front();
         break;
     }
 
     case NV4097_SET_BLEND_FUNC_SFACTOR: {
-        blend_sfactor_rgb = args[0] & 0xffff;
-        blend_sfactor_a = args[0] >> 16;
-        glBlendFuncSeparate(getBlendFactor(blend_sfactor_rgb), getBlendFactor(blend_dfactor_rgb), getBlendFactor(blend_sfactor_a), getBlendFactor(blend_dfactor_a));
-        
+        render_state.blend_sfactor_rgb = getBlendFactor(args[0] & 0xffff);
+        render_state.blend_sfactor_a = getBlendFactor(args[0] >> 16);
+        render_state_dirty |= DIRTY_BLEND_FUNC;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_BLEND_FUNC_DFACTOR: {
-        blend_dfactor_rgb = args[0] & 0xffff;
-        blend_dfactor_a = args[0] >> 16;
-        glBlendFuncSeparate(getBlendFactor(blend_sfactor_rgb), getBlendFactor(blend_dfactor_rgb), getBlendFactor(blend_sfactor_a), getBlendFactor(blend_dfactor_a));
-
+        render_state.blend_dfactor_rgb = getBlendFactor(args[0] & 0xffff);
+        render_state.blend_dfactor_a = getBlendFactor(args[0] >> 16);
+        render_state_dirty |= DIRTY_BLEND_FUNC;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_BLEND_COLOR: {
-        blend_color_r = (args[0] >> 0) & 0xff;
-        blend_color_g = (args[0] >> 8) & 0xff;
-        blend_color_b = (args[0] >> 16) & 0xff;
-        blend_color_a = (args[0] >> 24) & 0xff;
-
-        glBlendColor(blend_color_r / 255.0f, blend_color_g / 255.0f, blend_color_b / 255.0f, blend_color_a / 255.0f);
+        render_state.blend_color = args[0];
+        render_state_dirty |= DIRTY_BLEND_COLOR;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_BLEND_EQUATION: {
-        blend_equation_rgb = args[0] & 0xffff;
-        blend_equation_alpha = args[0] >> 16;
-
-        glBlendEquationSeparate(getBlendEquation(blend_equation_rgb), getBlendEquation(blend_equation_alpha));
+        render_state.blend_equation_rgb = getBlendEquation(args[0] & 0xffff);
+        render_state.blend_equation_alpha = getBlendEquation(args[0] >> 16);
+        render_state_dirty |= DIRTY_BLEND_EQUATION;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_SCISSOR_HORIZONTAL: {
-        scissor_x = args[0] & 0xffff;
-        scissor_width = args[0] >> 16;
+        render_state.scissor_x = args[0] & 0xffff;
+        render_state.scissor_width = args[0] >> 16;
+        render_state_dirty |= DIRTY_SCISSOR;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_SCISSOR_VERTICAL: {
-        scissor_y = args[0] & 0xffff;
-        scissor_height = args[0] >> 16;
+        render_state.scissor_y = args[0] & 0xffff;
+        render_state.scissor_height = args[0] >> 16;
+        render_state_dirty |= DIRTY_SCISSOR;
         args.pop_front();
         break;
     }
 
     case NV4097_SET_SHADER_PROGRAM: {
         fragment_shader_program.addr = offsetAndLocationToAddress(args[0] & ~3, (args[0] & 3) - 1);
+        fragment_program_dirty = true;
         log("Fragment shader: address: 0x%08x\n", fragment_shader_program.addr);
         args.pop_front();
         break;
@@ -997,35 +1384,24 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     }
 
     case NV4097_SET_DEPTH_FUNC: {
-        glDepthFunc(args[0]);
+        render_state.depth_func = args[0];
+        render_state_dirty |= DIRTY_DEPTH_FUNC;
         args.pop_front();
         break;
     }
             
     case NV4097_SET_DEPTH_MASK: {
-        depth_mask = args[0];
-        
-        if (args[0]) {
-            log("Enabled depth mask\n");
-            glDepthMask(GL_TRUE);
-        }
-        else {
-            log("Disabled depth mask\n");
-            glDepthMask(GL_FALSE);
-        }
+        render_state.depth_mask = args[0];
+        render_state_dirty |= DIRTY_DEPTH_MASK;
+        log("%s depth mask\n", args[0] ? "Enabled" : "Disabled");
         args.pop_front();
         break;
     }
             
     case NV4097_SET_DEPTH_TEST_ENABLE: {
-        if (args[0]) {
-            log("Enabled depth test\n");
-            OpenGL::enableDepth();
-        }
-        else {
-            log("Disabled depth test\n");
-            OpenGL::disableDepth();
-        }
+        render_state.depth_test = args[0];
+        render_state_dirty |= DIRTY_DEPTH_TEST;
+        log("%s depth test\n", args[0] ? "Enabled" : "Disabled");
         args.pop_front();
         break;
     }
@@ -1034,6 +1410,7 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         for (int i = 0; i < args.size(); i++)
             vertex_shader_data[vertex_shader_load_idx * 4 + i] = args[i];
         vertex_shader_load_idx += args.size() / 4;
+        vertex_program_dirty = true;
         log("Vertex shader: uploading %d words (%d instructions)\n", args.size(), args.size() / 4);
         args.clear();
         break;
@@ -1095,6 +1472,7 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         const u32 prim = args[0];
         log("Primitive: 0x%0x\n", prim);
         has_drawn_this_frame = true;
+        if (prim) flushRenderState();
 
         if (prim == 0) {   // End
             //vertex_array.bindings.clear();
@@ -1103,14 +1481,20 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
             int n_verts = 0;
             if (has_immediate_data) {
                 // Construct vertex buffer from immediate data (this is slow)
-                std::vector<u8> buffer;
+                u32 buffer_size = 0;
+                for (auto& binding : immediate_data.bindings) {
+                    if (binding.n_verts > 0) buffer_size += binding.data.size();
+                }
+                u32 base;
+                u8* buffer = vertex_stream.map(buffer_size, 16, base);
+                u32 buffer_offs = 0;
                 for (auto& binding : immediate_data.bindings) {
                     if (binding.n_verts > 0) {    // Binding is active
                         if (binding.n_verts > n_verts) n_verts = binding.n_verts;
                         
-                        const u32 old_size = buffer.size();
-                        buffer.resize(old_size + binding.data.size());
-                        std::memcpy(&buffer[old_size], binding.data.data(), binding.data.size());
+                        const u32 old_size = base + buffer_offs;
+                        std::memcpy(&buffer[buffer_offs], binding.data.data(), binding.data.size());
+                        buffer_offs += binding.data.size();
                         
                         // Setup VAO attribute
                         switch (binding.type) {
@@ -1138,37 +1522,24 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
                         vao.enableAttribute(binding.index);
                     }
                 }
+                vertex_stream.unmap(buffer_size);
                 
                 // We don't use setupForDrawing() because we setup the VAO differently above. Can't use setupVAO()
-                compileProgram();
-                uploadTexture();
-                uploadVertexConstants();
-                uploadFragmentUniforms();
-                bindBuffer();
-                OpenGL::setScissor(scissor_x, 720 - (scissor_y + scissor_height), scissor_width, scissor_height);
-                
-                // Hack for quads
-                if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
-                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ibo);
-                    quad_index_array.clear();
-                    for (int i = 0; i < n_verts / 4; i++) {
-                        if (i > 0) {
-                            quad_index_array.push_back(quad_index_array.back());
-                            quad_index_array.push_back((i * 4) + 0);
-                        }
-                        
-                        quad_index_array.push_back((i * 4) + 0);
-                        quad_index_array.push_back((i * 4) + 1);
-                        quad_index_array.push_back((i * 4) + 3);
-                        quad_index_array.push_back((i * 4) + 2);
+                if (compileProgram()) {
+                    uploadTexture();
+                    uploadVertexConstants();
+                    uploadFragmentUniforms();
+                    bindBuffer();
+                    frame_draws++;
+                    
+                    // Hack for quads
+                    if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
+                        const u32 n_indices = bindQuadIndices(n_verts);
+                        glDrawElements(getPrimitive(primitive), n_indices, GL_UNSIGNED_INT, 0);
+                    }
+                    else {
+                        glDrawArrays(getPrimitive(primitive), 0, n_verts);
                     }
-                    glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_index_array.size() * 4, quad_index_array.data(), GL_STATIC_DRAW);
-                    glBufferData(GL_ARRAY_BUFFER, buffer.size(), (void*)buffer.data(), GL_STATIC_DRAW);
-                    glDrawElements(getPrimitive(primitive), quad_index_array.size(), GL_UNSIGNED_INT, 0);
-                }
-                else {
-                    glBufferData(GL_ARRAY_BUFFER, buffer.size(), (void*)buffer.data(), GL_STATIC_DRAW);
-                    glDrawArrays(getPrimitive(primitive), 0, n_verts);
                 }
                 
                 has_immediate_data = false;
@@ -1176,58 +1547,47 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
             
             // Inlined array
             if (inline_array.size()) {
-                setupForDrawing();
-                
-                // Find how many vertices worth of data we have
-                u32 highest = 0;
-                AttributeBinding* highest_binding = nullptr;
-                for (auto& binding : vertex_array.bindings) {
-                    if (!binding.size) continue;
-                    if (binding.offset > highest) {
-                        highest = binding.offset;
-                        highest_binding = &binding;
-                    }
-                }
-                
-                if (!highest_binding) {
-                    Helpers::panic("VERTEX ARRAY WITH NO ATTRIBUTE BINDINGS!\n");
-                }
-                
-                const auto n_bytes = inline_array.size() * sizeof(u32);
-                const auto attrib_size = highest_binding->sizeOfComponent() * highest_binding->size;
-                u32 n_vertices = 0;
-                for (u32 i = highest_binding->offset - vertex_array.getBase(); i + attrib_size <= n_bytes; i += highest_binding->stride)
-                    n_vertices++;
-                log("Drawing inline array: %d vertices\n", n_vertices);
-                
-                // Gather vertices and draw
-                std::vector<u8> vtx_buf;
-                getVertices<true>(n_vertices, vtx_buf, 0);
-                
-                // Hack for quads
-                if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
-                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ibo);
-                    quad_index_array.clear();
-                    for (int i = 0; i < n_vertices / 4; i++) {
-                        if (i > 0) {
-                            quad_index_array.push_back(quad_index_array.back());
-                            quad_index_array.push_back((i * 4) + 0);
+                if (setupForDrawing()) {
+                    // Find how many vertices worth of data we have
+                    u32 highest = 0;
+                    AttributeBinding* highest_binding = nullptr;
+                    for (auto& binding : vertex_array.bindings) {
+                        if (!binding.size) continue;
+                        if (binding.offset > highest) {
+                            highest = binding.offset;
+                            highest_binding = &binding;
                         }
-                        
-                        quad_index_array.push_back((i * 4) + 0);
-                        quad_index_array.push_back((i * 4) + 1);
-                        quad_index_array.push_back((i * 4) + 3);
-                        quad_index_array.push_back((i * 4) + 2);
                     }
-                    glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_index_array.size() * 4, quad_index_array.data(), GL_STATIC_DRAW);
-                    glBufferData(GL_ARRAY_BUFFER, vtx_buf.size(), (void*)vtx_buf.data(), GL_STATIC_DRAW);
-                    glDrawElements(getPrimitive(primitive), quad_index_array.size(), GL_UNSIGNED_INT, 0);
-                }
-                else {
-                    glBufferData(GL_ARRAY_BUFFER, vtx_buf.size(), (void*)vtx_buf.data(), GL_STATIC_DRAW);
-                    glDrawArrays(getPrimitive(primitive), 0, n_vertices);
+                    
+                    if (!highest_binding) {
+                        Helpers::panic("VERTEX ARRAY WITH NO ATTRIBUTE BINDINGS!\n");
+                    }
+                    
+                    const auto n_bytes = inline_array.size() * sizeof(u32);
+                    const auto attrib_size = highest_binding->sizeOfComponent() * highest_binding->size;
+                    u32 n_vertices = 0;
+                    for (u32 i = highest_binding->offset - vertex_array.getBase(); i + attrib_size <= n_bytes; i += highest_binding->stride)
+                        n_vertices++;
+                    log("Drawing inline array: %d vertices\n", n_vertices);
+                    
+                    // Gather vertices and draw
+                    const u32 vert_size = getVertexSize();
+                    u32 offs;
+                    u8* vtx_buf = vertex_stream.map(n_vertices * vert_size, vert_size, offs);
+                    getVertices<true>(n_vertices, vtx_buf, 0);
+                    vertex_stream.unmap(n_vertices * vert_size);
+                    const u32 base_vertex = offs / vert_size;
+                    
+                    // Hack for quads
+                    if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
+                        const u32 n_indices = bindQuadIndices(n_vertices);
+                        glDrawElementsBaseVertex(getPrimitive(primitive), n_indices, GL_UNSIGNED_INT, 0, base_vertex);
+                    }
+                    else {
+                        glDrawArrays(getPrimitive(primitive), base_vertex, n_vertices);
+                    }
                 }
-                
+                    
                 inline_array.clear();
             }
             
@@ -1243,41 +1603,37 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     }
 
     case NV4097_DRAW_ARRAYS: {
-        setupForDrawing();
+        if (!setupForDrawing()) {
+            args.clear();
+            break;
+        }
 
-        std::vector<u8> vtx_buf;
-        int n_verts = 0;
+        // Count the vertices first so that they can be written straight to the vertex stream buffer
+        u32 n_verts = 0;
+        for (auto& j : args)
+            n_verts += (j >> 24) + 1;
+        
+        const u32 vert_size = getVertexSize();
+        u32 offs;
+        u8* vtx_buf = vertex_stream.map(n_verts * vert_size, vert_size ? vert_size : 1, offs);
         for (auto& j : args) {
             const u32 first = j & 0xffffff;
             const u32 count = (j >> 24) + 1;
-            n_verts += count;
 
             log("Draw Arrays: first: %d count: %d\n", first, count);
             getVertices(count, vtx_buf, first);
+            vtx_buf += count * vert_size;
         }
+        vertex_stream.unmap(n_verts * vert_size);
+        const u32 base_vertex = vert_size ? offs / vert_size : 0;
 
         // Hack for quads
         if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ibo);
-            quad_index_array.clear();
-            for (int i = 0; i < n_verts / 4; i++) {
-                if (i > 0) {
-                    quad_index_array.push_back(quad_index_array.back());
-                    quad_index_array.push_back((i * 4) + 0);
-                }
-                
-                quad_index_array.push_back((i * 4) + 0);
-                quad_index_array.push_back((i * 4) + 1);
-                quad_index_array.push_back((i * 4) + 3);
-                quad_index_array.push_back((i * 4) + 2);
-            }
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_index_array.size() * 4, quad_index_array.data(), GL_STATIC_DRAW);
-            glBufferData(GL_ARRAY_BUFFER, vtx_buf.size(), (void*)vtx_buf.data(), GL_STATIC_DRAW);
-            glDrawElements(getPrimitive(primitive), quad_index_array.size(), GL_UNSIGNED_INT, 0);
+            const u32 n_indices = bindQuadIndices(n_verts);
+            glDrawElementsBaseVertex(getPrimitive(primitive), n_indices, GL_UNSIGNED_INT, 0, base_vertex);
         }
         else {
-            glBufferData(GL_ARRAY_BUFFER, vtx_buf.size(), (void*)vtx_buf.data(), GL_STATIC_DRAW);
-            glDrawArrays(getPrimitive(primitive), 0, n_verts);
+            glDrawArrays(getPrimitive(primitive), base_vertex, n_verts);
         }
 
         args.clear();
@@ -1310,9 +1666,23 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     }
 
     case NV4097_DRAW_INDEX_ARRAY: {
-        setupForDrawing();
+        if (!setupForDrawing()) {
+            args.clear();
+            break;
+        }
 
-        std::vector<u32> indices;
+        u32 n_indices = 0;
+        for (auto& j : args)
+            n_indices += (j >> 24) + 1;
+        
+        // Quads are drawn as a triangle strip, gather their indices in a scratch buffer first and convert them below
+        const bool is_quads = primitive == CELL_GCM_PRIMITIVE_QUADS;
+        if (is_quads) quad_indices.resize(n_indices);
+        
+        u32 index_offs;
+        const u32 n_out_indices = is_quads ? getQuadIndexCount(n_indices / 4) : n_indices;
+        u32* out = (u32*)index_stream.map(n_out_indices * sizeof(u32), sizeof(u32), index_offs);
+        u32* indices = is_quads ? quad_indices.data() : out;
         u32 highest_index = 0;
 
         for (auto& j : args) {
@@ -1321,15 +1691,15 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
             log("Draw Index Array: first: %d count: %d\n", first, count);
             if (index_array.type == 1) {
                 for (int i = first; i < first + count; i++) {
-                    const u16 index = ps3->mem.read<u16>(index_array.addr + i * 2);
-                    indices.push_back(index);
+                    const u16 index = ps3->mem.readShared<u16>(index_array.addr + i * 2);
+                    *indices++ = index;
                     if (index > highest_index) highest_index = index;
                 }
             }
             else {
                 for (int i = first; i < first + count; i++) {
-                    const u32 index = ps3->mem.read<u32>(index_array.addr + i * 4);
-                    indices.push_back(index);
+                    const u32 index = ps3->mem.readShared<u32>(index_array.addr + i * 4);
+                    *indices++ = index;
                     if (index > highest_index) highest_index = index;
                 }
             }
@@ -1339,51 +1709,46 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         log("Vertex buffer: %d vertices\n", n_vertices);
 
         // Hack for quads
-        if (primitive == CELL_GCM_PRIMITIVE_QUADS) {
-            auto quad_indices = indices;
-            indices.clear();
-            
-            for (int i = 0; i < quad_indices.size(); i += 4) {
+        // The stream buffer is write-only, so the index repeated to join the quads is taken from the scratch buffer
+        if (is_quads) {
+            for (int i = 0; i + 3 < n_indices; i += 4) {
                 const u32 v0 = quad_indices[i + 0];
                 const u32 v1 = quad_indices[i + 1];
                 const u32 v2 = quad_indices[i + 2];
                 const u32 v3 = quad_indices[i + 3];
                 
                 if (i > 0) {
-                    indices.push_back(indices.back());
-                    indices.push_back(v0);
+                    *out++ = quad_indices[i - 2];   // v2 of the previous quad
+                    *out++ = v0;
                 }
                 
-                indices.push_back(v0);
-                indices.push_back(v1);
-                indices.push_back(v3);
-                indices.push_back(v2);
+                *out++ = v0;
+                *out++ = v1;
+                *out++ = v3;
+                *out++ = v2;
             }
         }
+        index_stream.unmap(n_out_indices * sizeof(u32));
         
         // Draw
-        std::vector<u8> vtx_buf;
+        const u32 vert_size = getVertexSize();
+        u32 offs;
+        u8* vtx_buf = vertex_stream.map(n_vertices * vert_size, vert_size ? vert_size : 1, offs);
         getVertices(n_vertices, vtx_buf);
+        vertex_stream.unmap(n_vertices * vert_size);
+        const u32 base_vertex = vert_size ? offs / vert_size : 0;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * 4, indices.data(), GL_STATIC_DRAW);
-        glBufferData(GL_ARRAY_BUFFER, vtx_buf.size(), (void*)vtx_buf.data(), GL_STATIC_DRAW);
-        glDrawElements(getPrimitive(primitive), indices.size(), GL_UNSIGNED_INT, 0);
+        index_stream.bind();
+        glDrawElementsBaseVertex(getPrimitive(primitive), n_out_indices, GL_UNSIGNED_INT, (void*)(uintptr_t)index_offs, base_vertex);
 
         args.clear();
         break;
     }
             
     case NV4097_SET_CULL_FACE_ENABLE: {
-        if (args[0]) {
-            log("Enabled cull face\n");
-            //glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
-        } else {
-            log("Disabled cull face\n");
-            glDisable(GL_CULL_FACE);
-        }
-        
+        render_state.cull_face = args[0];
+        render_state_dirty |= DIRTY_CULL_FACE;
+        log("%s cull face\n", args[0] ? "Enabled" : "Disabled");
         args.pop_front();
         break;
     }
@@ -1700,9 +2065,10 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         if (args[0] & 0xf0)
             OpenGL::clearColor();
         if (args[0] & 1) {
+            // Depth clears ignore the depth mask, restore whatever GL had before
             glDepthMask(GL_TRUE);
             OpenGL::clearDepth();
-            glDepthMask(depth_mask ? GL_TRUE : GL_FALSE);
+            if (!gl_state.depth_mask) glDepthMask(GL_FALSE);
         }
         if (args[0] & 2)
             OpenGL::clearStencil();
@@ -1723,6 +2089,7 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     case NV4097_SET_TRANSFORM_PROGRAM_START: {
         // This is the index of the first vertex shader instruction
         vertex_shader_start_idx = args[0];
+        vertex_program_dirty = true;
         log("Vertex shader start: %d\n", vertex_shader_start_idx);
 
         args.pop_front();
@@ -1732,7 +2099,8 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     case NV4097_SET_TRANSFORM_CONSTANT_LOAD: {
         const u32 start = args[0];
         for (int i = 1; i < args.size(); i++) constants[start * 4 + i - 1] = args[i];
-        constants_dirty = true;
+        constants_dirty_begin = std::min(constants_dirty_begin, start);
+        constants_dirty_end = std::min(std::max<u32>(constants_dirty_end, start + (args.size() - 1 + 3) / 4), 468u);
 
         log("Upload %d transform constants starting at %d\n", args.size() - 1, args[0]);
         for (int i = 1; i < args.size(); i++) {
@@ -1779,8 +2147,8 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
             v[i] = reinterpret_cast<float&>(swapped);
             log("Uploaded float 0x%08x\n", args[i]);
         }
-        const auto name = fragment_shader_decompiler.addUniform(addr);
-        fragment_uniforms.push_back({ name, v[0], v[1], v[2], v[3] });
+        fragment_shader_decompiler.addUniform(addr);
+        fragment_uniforms.push_back({ addr, v[0], v[1], v[2], v[3] });
 
         args.clear();
         break;
@@ -1794,11 +2162,13 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
 
     case GCM_FLIP_COMMAND: {
         const u32 buf_id = args[0];
-        log("Flip %d\n", buf_id);
+        log("Flip %d (%d draws, %d render state calls)\n", buf_id, frame_draws, frame_state_calls);
+        frame_draws = 0;
+        frame_state_calls = 0;
 
         // Hack: For speed, dont do anything if we didnt draw this frame
         if (!has_drawn_this_frame) {
-            ps3->flip();
+            flip();
             args.pop_front();
             break;
         }
@@ -1815,6 +2185,8 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         
         // Reset state
         OpenGL::disableScissor();
+        gl_state.scissor_test = false;
+        render_state_dirty |= DIRTY_SCISSOR;
         for (auto& binding : vertex_array.bindings) {
             binding.size = 0;
         }
@@ -1823,7 +2195,7 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
         // Probably not right
         last_flip_time = std::chrono::system_clock::now().time_since_epoch().count() * 8;
 
-        ps3->flip();
+        flip();
         args.pop_front();
         break;
     }
@@ -1847,6 +2219,52 @@ void RSX::doCmd(u32 cmd_num, std::deque<u32>& args) {
     }
 }
 
+void RSX::releaseSemaphore(u32 val) {
+    // Everything the commands before this one read from guest memory was already copied to GL objects,
+    // so the guest only needs to see our previous writes before it sees the semaphore
+    ps3->mem.writeShared<u32>(gcm.label_addr + semaphore_offset, val);
+}
+
+// Blocks until the semaphore at addr holds val. Returns the last value read
+u32 RSX::waitForSemaphore(u32 addr, u32 val) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::unique_lock<std::mutex> lock(fifo_mutex);
+    u32 sema = ps3->mem.readShared<u32>(addr);
+    while (sema != val && !exit_thread) {
+        // Stores to the semaphore's page wake us up through pageWritten. Read it again after tracking the page,
+        // the store might have happened in between.
+        // We also wake up every now and then, in case it was written without reporting it (i.e. through getPtr)
+        ps3->mem.trackWrites(addr, sizeof(u32));
+        sema = ps3->mem.readShared<u32>(addr);
+        if (sema == val) break;
+        
+        if (std::chrono::steady_clock::now() > deadline) {
+            log("Timed out waiting for semaphore 0x%08x (value: 0x%08x, expected: 0x%08x)\n", addr, sema, val);
+            break;
+        }
+        semaphore_cv.wait_for(lock, std::chrono::milliseconds(1));
+        sema = ps3->mem.readShared<u32>(addr);
+    }
+    return sema;
+}
+
+void RSX::flip() {
+    if (!threaded) {
+        ps3->flip();
+        return;
+    }
+
+    // Wait for the GPU to finish the frame before telling the guest the flip happened, it will reuse the buffers right after.
+    // This also keeps the RSX thread from getting more than one frame ahead of the GPU
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    present_handler();
+    glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+    glDeleteSync(fence);
+
+    // The flip handlers are guest code, let the emulator thread run them
+    pending_flips++;
+}
+
 void RSX::checkGLError() {
     GLenum err;
     while ((err = glGetError()) != GL_NO_ERROR) {
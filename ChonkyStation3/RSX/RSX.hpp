@@ -4,15 +4,26 @@
 #include <logger.hpp>
 #include <opengl.hpp>
 
+#include <array>
 #include <unordered_map>
 #include <stack>
 #include <deque>
 #include <chrono>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include <VertexShaderDecompiler.hpp>
 #include <FragmentShaderDecompiler.hpp>
 #include <FragmentShader.hpp>
 #include <RSXCache.hpp>
+#include <ShaderDiskCache.hpp>
+#include <TextureSwizzler.hpp>
+#include <VertexConverter.hpp>
+#include <ShaderWorkerPool.hpp>
+#include <StreamBuffer.hpp>
 #include <Modules/CellGcmSys.hpp>
 
 
@@ -27,6 +38,8 @@ public:
     VertexShaderDecompiler vertex_shader_decompiler;
     FragmentShaderDecompiler fragment_shader_decompiler;
     RSXCache cache;
+    ShaderDiskCache shader_disk_cache;
+    ShaderWorkerPool shader_workers;
 
     PlayStation3* ps3;
     MAKE_LOG_FUNCTION(log, rsx);
@@ -118,31 +131,67 @@ public:
 
     void putWritten(u64 unused);
     void runCommandList();
+    void flush();   // Runs the FIFO up to put. If the RSX is threaded, waits for the RSX thread to get there instead
     void doCmd(u32 cmd_num, std::deque<u32>& args);
     u32 fetch32();
+    u32 loadPut();
+    u32 loadGet();
+    void storeGet(u32 get);
     u32 offsetAndLocationToAddress(u32 offset, u8 location);
+    void releaseSemaphore(u32 val);
+    u32 waitForSemaphore(u32 addr, u32 val);
+    void flip();
+
+    // RSX thread
+    // The FIFO is consumed on its own host thread, which owns the GL context. Writing put only wakes it up.
+    // Flips are presented on the RSX thread, then the guest flip handlers are run by the emulator thread (see pending_flips).
+    bool threaded = false;
+    void startThread(std::function<void(void)> const& make_context_current, std::function<void(void)> const& present);
+    void stopThread();
+    std::atomic<int> pending_flips = 0;
+    std::thread rsx_thread;
+    std::mutex fifo_mutex;
+    std::condition_variable fifo_cv;    // Signalled when put is written
+    std::condition_variable idle_cv;    // Signalled when the RSX thread is done with a kick
+    std::condition_variable semaphore_cv;   // Signalled when a page is written while the RSX thread waits on a semaphore
+    u64 kick_count = 0;
+    u64 done_count = 0;
+    std::atomic<bool> exit_thread = false;
+    std::atomic<bool> waiting_on_semaphore = false;
+    std::function<void(void)> present_handler;
+    void rsxThread(std::function<void(void)> make_context_current);
+    void kick();
 
     std::stack<u32> call_stack;
-    bool hanged = false;
+    std::atomic<bool> hanged = false;
     bool flipped = false;
-    s64 last_flip_time = 0;
+    std::atomic<s64> last_flip_time = 0;
 
     OpenGL::Vector<float, 4> clear_color;
     u32 vertex_shader_data [512 * 4];   // 512 instructions, 1 qword each
     u32 vertex_shader_load_idx = 0;
     u32 vertex_shader_start_idx = 0;
     FragmentShader fragment_shader_program;
+    // The shaders are only hashed again when these are set. The vertex program is only written through the FIFO,
+    // the fragment program lives in guest memory and its pages are write-tracked
+    bool vertex_program_dirty = true;
+    bool fragment_program_dirty = true;
+    u64 hash_vertex = 0;
+    u64 hash_fragment = 0;
     std::vector<u32> quad_index_array;
+    std::vector<u32> quad_indices;  // Scratch buffer for indexed quad draws
 
     u32* constants = new u32[468 * 4]; // 468 * sizeof(vec4) / sizeof(float)
-    bool constants_dirty = true;
+    // Range of vertex constants (in vec4s) written since they were last uploaded
+    u32 constants_dirty_begin = 0;
+    u32 constants_dirty_end = 468;
     
     u64 last_program_hash = 0;
     bool program_changed = false;
     bool has_drawn_this_frame = false;
     
     struct FragmentUniform {
-        std::string name;
+        u32 addr;   // Address of the constant in the fragment program
         float x;
         float y;
         float z;
@@ -173,31 +222,59 @@ public:
     u16 point_y = 0;
     u32 dma_report = 0;
     u32 primitive = 0;
-    u16 blend_sfactor_rgb = CELL_GCM_ONE;
-    u16 blend_sfactor_a = CELL_GCM_ONE;
-    u16 blend_dfactor_rgb = CELL_GCM_ONE;
-    u16 blend_dfactor_a = CELL_GCM_ONE;
-    u8 blend_color_r = 0;
-    u8 blend_color_g = 0;
-    u8 blend_color_b = 0;
-    u8 blend_color_a = 0;
-    u16 blend_equation_rgb = 0;
-    u16 blend_equation_alpha = 0;
     u32 vertex_shader_load_addr = 0;
     u32 color_target = 0;
     u32 surface_a_offset = 0;
     u32 surface_a_location = 0;
-    u32 scissor_x = 0;
-    u32 scissor_y = 0;
-    u32 scissor_width = 1280;
-    u32 scissor_height = 720;
     float viewport_offs[4];
     float viewport_scale[4];
     s32 surface_clip[2];
     bool viewport_offs_dirty = true;
     bool viewport_scale_dirty = true;
     bool surface_clip_dirty = true;
-    bool depth_mask = true;
+
+    // Fixed function state. doCmd only records it in render_state and marks it dirty, flushRenderState applies the dirty state
+    // once per SET_BEGIN_END and skips whatever GL already has (gl_state), since games set the same state again for every draw
+    struct RenderState {
+        bool blend_enable = false;
+        GLenum blend_sfactor_rgb = GL_ONE;
+        GLenum blend_sfactor_a = GL_ONE;
+        GLenum blend_dfactor_rgb = GL_ZERO;
+        GLenum blend_dfactor_a = GL_ZERO;
+        u32 blend_color = 0;    // RGBA8
+        GLenum blend_equation_rgb = GL_FUNC_ADD;
+        GLenum blend_equation_alpha = GL_FUNC_ADD;
+        bool depth_test = false;
+        GLenum depth_func = GL_LEQUAL;
+        bool depth_mask = true;
+        bool cull_face = false;
+        bool scissor_test = true;   // Draws are always scissored, the flip blit isn't
+        u32 scissor_x = 0;
+        u32 scissor_y = 0;
+        u32 scissor_width = 1280;
+        u32 scissor_height = 720;
+    };
+
+    enum RenderStateDirty : u32 {
+        DIRTY_BLEND_ENABLE      = 1 << 0,
+        DIRTY_BLEND_FUNC        = 1 << 1,
+        DIRTY_BLEND_COLOR       = 1 << 2,
+        DIRTY_BLEND_EQUATION    = 1 << 3,
+        DIRTY_DEPTH_TEST        = 1 << 4,
+        DIRTY_DEPTH_FUNC        = 1 << 5,
+        DIRTY_DEPTH_MASK        = 1 << 6,
+        DIRTY_CULL_FACE         = 1 << 7,
+        DIRTY_SCISSOR           = 1 << 8,
+    };
+
+    RenderState render_state;
+    RenderState gl_state;   // What GL currently has
+    u32 render_state_dirty = DIRTY_SCISSOR;
+    void flushRenderState();
+
+    // Counted per frame and logged on flip, to check how many state changes actually reach the driver
+    u32 frame_draws = 0;
+    u32 frame_state_calls = 0;
 
     static constexpr GLuint swizzle_map[] = {
         GL_ALPHA,
@@ -227,16 +304,31 @@ public:
     bool has_immediate_data = false;
 
     OpenGL::VertexArray vao;
-    OpenGL::VertexBuffer vbo;
-    OpenGL::Shader vertex, fragment;
-    OpenGL::Program program;
+    RSXCache::CachedProgram* curr_program = nullptr;
     OpenGL::Texture tex;
     OpenGL::Framebuffer fb;
     OpenGL::Texture depth_tex;
     GLuint vertex_consts_ubo;
+    GLuint fragment_state_ubo;
+    std::array<s32, 16> uploaded_flip_tex = {};     // flip_tex flags currently in fragment_state_ubo
+
+    // Uniform buffer binding points
+    static constexpr GLuint VERTEX_CONSTANTS_BINDING = 10;
+    static constexpr GLuint FRAGMENT_STATE_BINDING = 11;
+    static constexpr GLuint FRAGMENT_CONSTANTS_BINDING = 12;
+
+    // Vertices and indices are written straight into these every draw
+    static constexpr u32 VERTEX_STREAM_SIZE = 32_MB;
+    static constexpr u32 INDEX_STREAM_SIZE = 8_MB;
+    StreamBuffer vertex_stream;
+    StreamBuffer index_stream;
 
-    GLuint ibo;
+    // Indices for drawing quads as a triangle strip. The indices for n quads are a prefix of the ones for more quads,
+    // so the buffer is only regenerated when a draw needs more quads than it holds.
     GLuint quad_ibo;
+    u32 quad_ibo_quads = 0;
+    u32 bindQuadIndices(u32 n_vertices);    // Returns the number of indices to draw
+    static u32 getQuadIndexCount(u32 n_quads) { return n_quads ? n_quads * 6 - 2 : 0; }
 
     void checkGLError();
 
@@ -317,15 +409,44 @@ public:
     };
     IndexArray index_array;
 
-    void compileProgram();
+    bool compileProgram();
+    void loadShaderCache();
+    bool getCachedShader(u64 hash, OpenGL::ShaderType type, OpenGL::Shader& shader);
+    bool getPendingShader(u64 hash, OpenGL::ShaderType type, bool wait, OpenGL::Shader& shader);
+    OpenGL::Shader compileShader(u64 hash, const std::string& source, OpenGL::ShaderType type);
+    bool linkProgram(OpenGL::Shader& vertex, OpenGL::Shader& fragment, OpenGL::Program& program);
+    void startLinking(OpenGL::Shader& vertex, OpenGL::Shader& fragment, OpenGL::Program& program);
+    bool finishLinking(OpenGL::Program& program);
+    void setupProgram(RSXCache::CachedProgram& cached);
+
+    // Programs that weren't cached are decompiled on the shader workers and linked in the background (see compileProgram)
+    struct PendingProgram {
+        u64 hash_vertex;
+        u64 hash_fragment;
+        OpenGL::Shader vertex;
+        OpenGL::Shader fragment;
+        OpenGL::Program program;    // Exists once linking started
+    };
+    std::unordered_map<u64, PendingProgram> pending_programs;
+    std::unordered_map<u64, std::shared_future<std::string>> pending_shaders;   // Shader hash -> GLSL being decompiled
+    bool parallel_shader_compile = false;   // The driver supports GL_KHR_parallel_shader_compile (or the ARB version)
     void setupVAO();
-    template<bool is_inline_array = false> void getVertices(u32 n_vertices, std::vector<u8>& vtx_buf, u32 start = 0);
+    u32 getVertexSize();
+    template<bool is_inline_array = false> void getVertices(u32 n_vertices, u8* ptr, u32 start = 0);
     void uploadVertexConstants();
     void uploadFragmentUniforms();
     void uploadTexture();
-    void swizzleTexture(u8* src, u8* dst, u32 width, u32 height, u32 pixel_size);
+    void pageWritten(u64 page);
+    void invalidateWrittenPages();
+    std::vector<u64> written_pages;     // Written by pageWritten, consumed by invalidateWrittenPages
+    std::mutex written_pages_mutex;
+    std::atomic<bool> has_written_pages = false;
+    u32 getTextureBytesPerPixel(u32 raw_fmt);
+    u32 getTextureSize(Texture& texture);
+    TextureSwizzler swizzler;
+    std::vector<u8> swizzle_buffer;     // Reused by uploadTexture so that texture conversion doesn't allocate
     void bindBuffer();
-    void setupForDrawing();
+    bool setupForDrawing();
 
     u32 getRawTextureFormat(u8 fmt) { return fmt & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN); }
     GLuint getTexturePixelFormat(u8 fmt);
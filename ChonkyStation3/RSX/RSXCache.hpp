@@ -3,8 +3,11 @@
 #include <common.hpp>
 #include <logger.hpp>
 #include <opengl.hpp>
+#include <MemoryConstants.hpp>
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 #include <xxhash.h>
 
@@ -29,6 +32,16 @@ public:
     struct CachedShader {
         OpenGL::Shader shader;
     };
+
+    // Everything a draw needs from a program is resolved once when the program is linked (see RSX::setupProgram), so that draws don't look anything up by name
+    struct CachedProgram {
+        OpenGL::Program program;
+        GLint viewport_offs_loc = -1;
+        GLint viewport_scale_loc = -1;
+        GLint surface_clip_loc = -1;
+        GLuint fragment_constants_ubo = 0;                      // 0 if the fragment shader has no patched constants
+        std::unordered_map<u32, u32> fragment_constant_offsets; // Address of the constant in the fragment program -> offset in the UBO
+    };
     
     bool getShader(u64 hash, CachedShader& shader) {
         if (shader_cache.contains(hash)) {
@@ -39,13 +52,10 @@ public:
         return false;
     }
 
-    bool getProgram(u64 hash, OpenGL::Program& program) {
-        if (program_cache.contains(hash)) {
-            program = program_cache[hash];
-            //log("Got cached program: %016x\n", hash);
-            return true;
-        }
-        return false;
+    // Returns nullptr if the program isn't cached
+    CachedProgram* getProgram(u64 hash) {
+        auto it = program_cache.find(hash);
+        return it != program_cache.end() ? &it->second : nullptr;
     }
 
     void cacheShader(u64 hash, CachedShader shader) {
@@ -53,9 +63,9 @@ public:
         log("Cached new shader: %016x\n", hash);
     }
 
-    void cacheProgram(u64 hash, OpenGL::Program& program) {
-        program_cache[hash] = program;
+    CachedProgram* cacheProgram(u64 hash, CachedProgram& program) {
         log("Cached new program: %016x\n", hash);
+        return &(program_cache[hash] = program);
     }
 
     u64 computeHash(u8* ptr, size_t size) {
@@ -67,23 +77,60 @@ public:
         return computeHash((u8*)&hashes[0], sizeof(u64) * 2);
     }
 
-    u64 computeTextureHash(u8* ptr, u64 width, u64 height, u64 n_components) {
-        const size_t size = width * height * n_components;
-        return computeHash(ptr, size);
+    // Textures are cached by descriptor, so switching between cached textures doesn't hash their contents.
+    // RSX write-tracks the pages of every uploaded texture, a write to any of them marks the texture stale
+    // and it's uploaded again the next time it's used.
+    struct TextureKey {
+        u32 addr;
+        u32 pitch;
+        u16 width;
+        u16 height;
+        u8 format;
+
+        bool operator==(const TextureKey& other) const {
+            return addr == other.addr && pitch == other.pitch && width == other.width && height == other.height && format == other.format;
+        }
+    };
+
+    struct TextureKeyHash {
+        size_t operator()(const TextureKey& key) const {
+            const u64 a = ((u64)key.addr << 32) | key.pitch;
+            const u64 b = ((u64)key.width << 24) | ((u64)key.height << 8) | key.format;
+            return std::hash<u64>()(a ^ (b * 0x9e3779b97f4a7c15));
+        }
+    };
+
+    struct CachedTexture {
+        OpenGL::Texture texture;
+        bool stale = false;
+    };
+
+    // Returns nullptr if the texture isn't cached
+    CachedTexture* getTexture(const TextureKey& key) {
+        auto it = texture_cache.find(key);
+        return it != texture_cache.end() ? &it->second : nullptr;
     }
 
-    bool getTexture(u64 hash, OpenGL::Texture& texture) {
-        if (texture_cache.contains(hash)) {
-            texture = texture_cache[hash];
-            //log("Got cached texture: %016x\n", hash);
-            return true;
+    CachedTexture* cacheTexture(const TextureKey& key, OpenGL::Texture& texture) {
+        log("Cached new texture: 0x%08x (%dx%d)\n", key.addr, key.width, key.height);
+        return &(texture_cache[key] = { texture, false });
+    }
+
+    // Records which pages the texture was read from, so that writes to them can mark it stale
+    void addTexturePages(const TextureKey& key, u32 size) {
+        for (u64 page = key.addr >> PAGE_SHIFT; page <= ((u64)key.addr + size - 1) >> PAGE_SHIFT; page++) {
+            auto& keys = texture_pages[page];
+            if (std::find(keys.begin(), keys.end(), key) == keys.end())
+                keys.push_back(key);
         }
-        return false;
     }
 
-    void cacheTexture(u64 hash, OpenGL::Texture& texture) {
-        texture_cache[hash] = texture;
-        log("Cached new texture: %016x\n", hash);
+    void invalidateTexturePage(u64 page) {
+        auto it = texture_pages.find(page);
+        if (it == texture_pages.end()) return;
+        for (auto& key : it->second)
+            texture_cache[key].stale = true;
+        texture_pages.erase(it);
     }
 
     bool getFramebuffer(u32 addr, OpenGL::Texture& framebuffer) {
@@ -105,7 +152,8 @@ private:
 
     // TODO: Might change this to an std::vector of "CachedShader" structs or something
     std::unordered_map<u64, CachedShader> shader_cache;
-    std::unordered_map<u64, OpenGL::Program> program_cache;
-    std::unordered_map<u64, OpenGL::Texture> texture_cache;
+    std::unordered_map<u64, CachedProgram> program_cache;
+    std::unordered_map<TextureKey, CachedTexture, TextureKeyHash> texture_cache;
+    std::unordered_map<u64, std::vector<TextureKey>> texture_pages;     // Page -> textures using it
     std::unordered_map<u32, OpenGL::Texture> framebuffer_cache;
 };
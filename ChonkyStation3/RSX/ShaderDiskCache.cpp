@@ -0,0 +1,138 @@
+#include "ShaderDiskCache.hpp"
+
+
+void ShaderDiskCache::open(const fs::path& dir) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+        log("Could not create %s (%s), the shader disk cache is disabled\n", dir.generic_string().c_str(), ec.message().c_str());
+        return;
+    }
+    this->dir = dir;
+
+    // Program binaries are only valid for the driver that produced them
+    const std::string driver = std::format("{}|{}|{}", (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    driver_hash = XXH3_64bits(driver.data(), driver.size());
+
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const auto& entry = *it;
+        std::error_code file_ec;
+        if (!entry.is_regular_file(file_ec)) continue;
+        const auto& path = entry.path();
+        const auto stem = path.stem().generic_string();
+        u64 hash;
+        if (std::from_chars(stem.data(), stem.data() + stem.size(), hash, 16).ec != std::errc()) continue;
+
+        if (path.extension() == ".glsl")
+            loadSource(path, hash);
+        else if (path.extension() == ".prog")
+            loadProgram(path, hash);
+    }
+    if (ec) {
+        log("Could not read %s (%s), the shader disk cache is disabled\n", dir.generic_string().c_str(), ec.message().c_str());
+        this->dir.clear();     // What was already loaded stays usable, we just stop writing to it
+        return;
+    }
+
+    log("Loaded %d shaders and %d programs from %s\n", sources.size(), programs.size(), dir.generic_string().c_str());
+}
+
+bool ShaderDiskCache::getSource(u64 hash, std::string& source) {
+    auto it = sources.find(hash);
+    if (it == sources.end()) return false;
+    source = it->second;
+    return true;
+}
+
+void ShaderDiskCache::saveSource(u64 hash, const std::string& source) {
+    if (!isOpen()) return;
+    sources[hash] = source;
+
+    const SourceHeader header = { SOURCE_MAGIC, VERSION, (u32)source.size() };
+    writeFile(dir / std::format("{:016x}.glsl", hash), &header, sizeof(SourceHeader), source.data(), source.size());
+}
+
+void ShaderDiskCache::saveProgram(u64 hash, u64 hash_vertex, u64 hash_fragment, OpenGL::Program& program) {
+    if (!isOpen()) return;
+
+    GLint size = 0;
+    glGetProgramiv(program.handle(), GL_PROGRAM_BINARY_LENGTH, &size);
+    if (!size) return;  // The driver doesn't give out binaries for this program
+
+    std::vector<u8> binary(size);
+    GLenum format;
+    glGetProgramBinary(program.handle(), size, &size, &format, binary.data());
+
+    const ProgramHeader header = { PROGRAM_MAGIC, VERSION, driver_hash, hash_vertex, hash_fragment, format, (u32)size };
+    writeFile(dir / std::format("{:016x}.prog", hash), &header, sizeof(ProgramHeader), binary.data(), size);
+}
+
+void ShaderDiskCache::loadSource(const fs::path& path, u64 hash) {
+    FILE* file = std::fopen(path.generic_string().c_str(), "rb");
+    if (!file) return;
+
+    SourceHeader header;
+    std::string source;
+    bool ok = std::fread(&header, sizeof(SourceHeader), 1, file) == 1 && header.magic == SOURCE_MAGIC && header.version == VERSION;
+    if (ok) {
+        source.resize(header.size);
+        ok = std::fread(source.data(), 1, header.size, file) == header.size;
+    }
+    std::fclose(file);
+
+    // Entries from an older version of the decompiler (or broken ones) are dropped, the shader will be decompiled again
+    if (!ok) {
+        log("Removing outdated cached shader %s\n", path.generic_string().c_str());
+        std::error_code ec;
+        fs::remove(path, ec);
+        return;
+    }
+    sources[hash] = std::move(source);
+}
+
+void ShaderDiskCache::loadProgram(const fs::path& path, u64 hash) {
+    FILE* file = std::fopen(path.generic_string().c_str(), "rb");
+    if (!file) return;
+
+    ProgramHeader header;
+    ProgramEntry program;
+    bool ok = std::fread(&header, sizeof(ProgramHeader), 1, file) == 1 && header.magic == PROGRAM_MAGIC && header.version == VERSION;
+    if (ok) {
+        program = { header.hash_vertex, header.hash_fragment, header.driver_hash, header.format, std::vector<u8>(header.size) };
+        ok = std::fread(program.binary.data(), 1, header.size, file) == header.size;
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        log("Removing outdated cached program %s\n", path.generic_string().c_str());
+        std::error_code ec;
+        fs::remove(path, ec);
+        return;
+    }
+    programs[hash] = std::move(program);
+}
+
+void ShaderDiskCache::writeFile(const fs::path& path, const void* header, size_t header_size, const void* data, size_t size) {
+    // Write to a temporary file first so that we never leave a broken entry behind
+    const fs::path tmp_path = fs::path(path).replace_extension(".tmp");
+    FILE* file = std::fopen(tmp_path.generic_string().c_str(), "wb");
+    if (!file) {
+        log("Could not write %s\n", path.generic_string().c_str());
+        return;
+    }
+
+    const bool ok = std::fwrite(header, header_size, 1, file) == 1 && (!size || std::fwrite(data, size, 1, file) == 1);
+    std::fclose(file);
+    std::error_code ec;
+    if (!ok) {
+        fs::remove(tmp_path, ec);
+        return;
+    }
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        // Most likely the cache directory went away or became read-only, stop trying to write to it
+        log("Could not write %s (%s), the shader disk cache is disabled\n", path.generic_string().c_str(), ec.message().c_str());
+        fs::remove(tmp_path, ec);
+        dir.clear();
+    }
+}
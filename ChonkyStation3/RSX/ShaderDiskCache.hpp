@@ -0,0 +1,72 @@
+#pragma once
+
+#include <common.hpp>
+#include <logger.hpp>
+#include <opengl.hpp>
+
+#include <charconv>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <xxhash.h>
+
+
+// Persists the shaders of a game across boots, so that a shader doesn't have to be decompiled, compiled and linked again the first time it's used.
+// Decompiled GLSL is keyed by the hash of the microcode and doesn't depend on the driver.
+// Linked programs are keyed by program hash and store the binary returned by the driver along with a hash of the driver string,
+// if the driver changed or rejects the binary the program is linked again from the cached GLSL.
+class ShaderDiskCache {
+public:
+    // Bump this whenever the output of the shader decompilers changes, entries with a different version are ignored
+    static constexpr u32 VERSION = 2;
+
+    struct ProgramEntry {
+        u64 hash_vertex;
+        u64 hash_fragment;
+        u64 driver_hash;
+        u32 format;
+        std::vector<u8> binary;
+    };
+
+    // Loads every entry in dir. Has to be called on the thread that owns the GL context (it reads the driver string).
+    // Filesystem errors are logged and leave the cache disabled
+    void open(const fs::path& dir);
+    bool isOpen() { return !dir.empty(); }
+
+    bool getSource(u64 hash, std::string& source);
+    void saveSource(u64 hash, const std::string& source);
+    void saveProgram(u64 hash, u64 hash_vertex, u64 hash_fragment, OpenGL::Program& program);
+
+    std::unordered_map<u64, ProgramEntry> programs;    // Programs found by open, RSX links them and then clears this
+    u64 driver_hash = 0;
+
+private:
+    MAKE_LOG_FUNCTION(log, rsx_cache);
+
+    static constexpr u32 SOURCE_MAGIC  = 0x48534343;   // CCSH
+    static constexpr u32 PROGRAM_MAGIC = 0x50534343;   // CCSP
+
+    struct SourceHeader {
+        u32 magic;
+        u32 version;
+        u32 size;
+    };
+
+    struct ProgramHeader {
+        u32 magic;
+        u32 version;
+        u64 driver_hash;
+        u64 hash_vertex;
+        u64 hash_fragment;
+        u32 format;
+        u32 size;
+    };
+
+    fs::path dir;
+    std::unordered_map<u64, std::string> sources;
+
+    void loadSource(const fs::path& path, u64 hash);
+    void loadProgram(const fs::path& path, u64 hash);
+    void writeFile(const fs::path& path, const void* header, size_t header_size, const void* data, size_t size);
+};
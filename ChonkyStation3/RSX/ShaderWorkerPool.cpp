@@ -0,0 +1,47 @@
+#include "ShaderWorkerPool.hpp"
+
+
+ShaderWorkerPool::~ShaderWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exit = true;
+    }
+    cv.notify_all();
+    for (auto& thread : workers) thread.join();
+}
+
+std::shared_future<std::string> ShaderWorkerPool::submit(std::function<std::string(void)> const& job) {
+    // The workers are only started once we actually need them
+    if (workers.empty()) start();
+
+    std::packaged_task<std::string(void)> task(job);
+    auto future = task.get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(task));
+    }
+    cv.notify_one();
+    return future;
+}
+
+void ShaderWorkerPool::start() {
+    // Leave some host threads to the PPU, SPUs and RSX
+    const u32 n_workers = std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u);
+    for (u32 i = 0; i < n_workers; i++)
+        workers.emplace_back(&ShaderWorkerPool::worker, this);
+}
+
+void ShaderWorkerPool::worker() {
+    while (true) {
+        std::packaged_task<std::string(void)> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this]() { return exit || !jobs.empty(); });
+            if (exit) return;
+            task = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        // Exceptions (i.e. Helpers::panic) are stored in the future and rethrown on the RSX thread
+        task();
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <common.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+
+// Host threads that decompile shaders in the background, so that the RSX thread doesn't stall on them.
+// A job returns the GLSL source, its future is polled (or waited on) by RSX::compileProgram.
+// Jobs must not touch RSX state: they get a copy of the decompiler and of the microcode.
+class ShaderWorkerPool {
+public:
+    ~ShaderWorkerPool();
+
+    std::shared_future<std::string> submit(std::function<std::string(void)> const& job);
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::packaged_task<std::string(void)>> jobs;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool exit = false;
+
+    void start();
+    void worker();
+};
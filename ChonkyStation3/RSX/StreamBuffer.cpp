@@ -0,0 +1,77 @@
+#include "StreamBuffer.hpp"
+
+
+void StreamBuffer::create(GLenum target, u32 size) {
+    this->target = target;
+    this->size = size;
+    segment_size = size / SEGMENTS;
+
+    glGenBuffers(1, &handle);
+    bind();
+    persistent = GLAD_GL_VERSION_4_4 && glBufferStorage;
+    if (persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, size, nullptr, flags);
+        mapping = (u8*)glMapBufferRange(target, 0, size, flags);
+        if (!mapping) Helpers::panic("StreamBuffer: failed to map buffer\n");
+    }
+    else {
+        glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+    }
+}
+
+u8* StreamBuffer::map(u32 size, u32 alignment, u32& offset) {
+    if (size > this->size)
+        Helpers::panic("StreamBuffer: tried to map 0x%x bytes (buffer size is 0x%x)\n", size, this->size);
+
+    pos = (pos + alignment - 1) / alignment * alignment;
+    const bool wrap = pos + size > this->size;
+
+    if (!persistent) {
+        bind();
+        if (wrap) {
+            // Orphan the old storage, the driver keeps it around until the GPU is done with it
+            glBufferData(target, this->size, nullptr, GL_STREAM_DRAW);
+            pos = 0;
+        }
+        offset = pos;
+        if (!size) return nullptr;
+        return (u8*)glMapBufferRange(target, pos, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+
+    // Every draw that used the segments before pos was issued before this call, fence them
+    fenceSegments(std::min(pos / segment_size, SEGMENTS));
+    if (wrap) {
+        fenceSegments(SEGMENTS);
+        pos = 0;
+        fenced_segment = 0;
+    }
+
+    // Wait for the GPU to be done with the segments we are about to write to
+    if (size) {
+        for (u32 segment = pos / segment_size; segment <= std::min((pos + size - 1) / segment_size, SEGMENTS - 1); segment++)
+            waitSegment(segment);
+    }
+
+    offset = pos;
+    return mapping + pos;
+}
+
+void StreamBuffer::unmap(u32 size) {
+    if (!persistent && size) glUnmapBuffer(target);
+    pos += size;
+}
+
+void StreamBuffer::fenceSegments(u32 end) {
+    for (; fenced_segment < end; fenced_segment++) {
+        if (fences[fenced_segment]) glDeleteSync(fences[fenced_segment]);
+        fences[fenced_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void StreamBuffer::waitSegment(u32 segment) {
+    if (!fences[segment]) return;
+    glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+    glDeleteSync(fences[segment]);
+    fences[segment] = 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <common.hpp>
+#include <opengl.hpp>
+
+#include <array>
+
+
+// Ring buffer for data that changes every draw (vertices, indices), so that we don't reallocate the buffer storage on every draw.
+// If the driver supports glBufferStorage (GL 4.4) the buffer is allocated once and stays persistently and coherently mapped.
+// The ring is split in segments, a fence is inserted once the draws using a segment have been issued and is waited on before the segment is reused.
+// Otherwise (GL 4.1) ranges are mapped unsynchronized and the buffer is orphaned when the ring wraps around.
+class StreamBuffer {
+public:
+    void create(GLenum target, u32 size);
+    void bind() { glBindBuffer(target, handle); }
+
+    // Returns a pointer to size bytes of the buffer, at an offset which is a multiple of alignment.
+    // The data has to be written before calling unmap, and before the next map call.
+    u8* map(u32 size, u32 alignment, u32& offset);
+    void unmap(u32 size);
+
+    GLuint handle = 0;
+
+private:
+    static constexpr u32 SEGMENTS = 3;
+
+    GLenum target;
+    u32 size = 0;
+    u32 segment_size = 0;
+    u32 pos = 0;
+    u32 fenced_segment = 0;     // First segment that was written to but isn't fenced yet
+    bool persistent = false;
+    u8* mapping = nullptr;
+    std::array<GLsync, SEGMENTS> fences = {};
+
+    void fenceSegments(u32 end);
+    void waitSegment(u32 segment);
+};
@@ -0,0 +1,72 @@
+#include "TextureSwizzler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+// Copies a swizzled texture to dst row by row. The offset of a texel is x_offs[x] + y_offs[y] (in texels),
+// runs of run_len texels are contiguous in the source.
+template<size_t size>
+static void unswizzleRows(const u8* src, u8* dst, u32 width, u32 height, const u32* x_offs, const u32* y_offs, u32 run_len) {
+    for (u32 y = 0; y < height; y++) {
+        const u8* row = src + (size_t)y_offs[y] * size;
+        for (u32 x = 0; x < width; x += run_len) {
+            std::memcpy(dst, row + (size_t)x_offs[x] * size, size * run_len);
+            dst += size * run_len;
+        }
+    }
+}
+
+void TextureSwizzler::unswizzle(const u8* src, u8* dst, u32 width, u32 height, u32 pixel_size) {
+    // Swizzled textures are stored in Morton order: the bits of x and y are interleaved starting from x,
+    // once the smaller dimension runs out of bits the remaining bits of the other one are on top.
+    // The x and y bits never overlap, so the offset is the sum of a per-column and a per-row offset.
+    const u32 log2_width = std::log2(width);
+    const u32 log2_height = std::log2(height);
+
+    // Position of each bit of x and y in the offset
+    u32 x_pos[32];
+    u32 y_pos[32];
+    u32 shift_count = 0;
+    for (u32 i = 0; i < std::max(log2_width, log2_height); i++) {
+        if (i < log2_width)  x_pos[i] = shift_count++;
+        if (i < log2_height) y_pos[i] = shift_count++;
+    }
+
+    auto build_offsets = [](std::vector<u32>& offs, u32 size, u32 log2_size, const u32* pos) {
+        offs.resize(size);
+        for (u32 i = 0; i < size; i++) {
+            u32 off = 0;
+            for (u32 bit = 0; bit < log2_size; bit++)
+                off |= ((i >> bit) & 1) << pos[bit];
+            offs[i] = off;
+        }
+    };
+    build_offsets(x_offs, width, log2_width, x_pos);
+    build_offsets(y_offs, height, log2_height, y_pos);
+
+    // Texels next to each other in a row are contiguous in the source as long as only x bits are below them:
+    // pairs of texels, or whole rows if the texture is 1 texel high
+    u32 run_len = 1;
+    if (width == (1u << log2_width)) {
+        if (log2_height == 0)   run_len = width;
+        else if (log2_width)    run_len = 2;
+    }
+
+    const u32* x = x_offs.data();
+    const u32* y = y_offs.data();
+    switch (pixel_size) {
+    case 1:  unswizzleRows<1> (src, dst, width, height, x, y, run_len); break;
+    case 2:  unswizzleRows<2> (src, dst, width, height, x, y, run_len); break;
+    case 4:  unswizzleRows<4> (src, dst, width, height, x, y, run_len); break;
+    case 8:  unswizzleRows<8> (src, dst, width, height, x, y, run_len); break;
+    case 16: unswizzleRows<16>(src, dst, width, height, x, y, run_len); break;
+    default: {
+        for (u32 row = 0; row < height; row++) {
+            for (u32 col = 0; col < width; col++)
+                std::memcpy(&dst[(row * width + col) * pixel_size], &src[(x[col] + y[row]) * pixel_size], pixel_size);
+        }
+    }
+    }
+}
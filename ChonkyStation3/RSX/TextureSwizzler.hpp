@@ -0,0 +1,17 @@
+#pragma once
+
+#include <common.hpp>
+
+#include <vector>
+
+
+// Converts swizzled textures to linear ones.
+// The offset tables are kept between calls so that converting a texture doesn't allocate.
+class TextureSwizzler {
+public:
+    void unswizzle(const u8* src, u8* dst, u32 width, u32 height, u32 pixel_size);
+
+private:
+    std::vector<u32> x_offs;
+    std::vector<u32> y_offs;
+};
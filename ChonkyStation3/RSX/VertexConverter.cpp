@@ -0,0 +1,86 @@
+#include "VertexConverter.hpp"
+#include <CPUFeatures.hpp>
+
+#include <cstring>
+
+// The SSSE3 versions are only picked if the host CPU supports it
+#ifdef CHONKYSTATION3_X64
+#include <tmmintrin.h>
+#define RSX_VERTEX_SSSE3
+static const bool has_ssse3 = CPUFeatures::hasSSSE3();
+#endif
+
+
+namespace VertexConverter {
+
+template<typename T, u32 n_components, bool swap>
+static void convertVertexAttribute(const u8* src, u32 src_stride, u8* dst, u32 dst_stride, u32 n) {
+    for (u32 i = 0; i < n; i++) {
+        T data[n_components];
+        std::memcpy(data, src, sizeof(data));
+        if constexpr (swap) {
+            for (auto& component : data) component = Helpers::bswap<T>(component);
+        }
+        std::memcpy(dst, data, sizeof(data));
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+#ifdef RSX_VERTEX_SSSE3
+template<typename T, u32 n_components>
+TARGET_SSSE3 static void convertVertexAttributeSSSE3(const u8* src, u32 src_stride, u8* dst, u32 dst_stride, u32 n) {
+    // Reverses the bytes of every sizeof(T)-byte lane
+    alignas(16) u8 mask_bytes[16];
+    for (int i = 0; i < 16; i++)
+        mask_bytes[i] = (i & ~(sizeof(T) - 1)) + (sizeof(T) - 1 - (i & (sizeof(T) - 1)));
+    const __m128i mask = _mm_load_si128((const __m128i*)mask_bytes);
+
+    constexpr u32 size = sizeof(T) * n_components;
+    for (u32 i = 0; i < n; i++) {
+        __m128i data;
+        if constexpr (size == 16) data = _mm_loadu_si128((const __m128i*)src);
+        else {
+            data = _mm_setzero_si128();
+            std::memcpy(&data, src, size);
+        }
+        data = _mm_shuffle_epi8(data, mask);
+        if constexpr (size == 16) _mm_storeu_si128((__m128i*)dst, data);
+        else std::memcpy(dst, &data, size);
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+#endif
+
+template<typename T>
+static ConvertFunc getConvertFunc(u32 n_components, bool swap, bool allow_simd) {
+#ifdef RSX_VERTEX_SSSE3
+    if (allow_simd && has_ssse3 && swap && sizeof(T) > 1) {
+        switch (n_components) {
+        case 1: return convertVertexAttributeSSSE3<T, 1>;
+        case 2: return convertVertexAttributeSSSE3<T, 2>;
+        case 3: return convertVertexAttributeSSSE3<T, 3>;
+        case 4: return convertVertexAttributeSSSE3<T, 4>;
+        }
+    }
+#endif
+    switch (n_components) {
+    case 1: return swap ? convertVertexAttribute<T, 1, true> : convertVertexAttribute<T, 1, false>;
+    case 2: return swap ? convertVertexAttribute<T, 2, true> : convertVertexAttribute<T, 2, false>;
+    case 3: return swap ? convertVertexAttribute<T, 3, true> : convertVertexAttribute<T, 3, false>;
+    case 4: return swap ? convertVertexAttribute<T, 4, true> : convertVertexAttribute<T, 4, false>;
+    default: Helpers::panic("Unimplemented vertex attribute with %d components\n", n_components);
+    }
+}
+
+ConvertFunc getConvertFunc(u32 size_of_component, u32 n_components, bool swap, bool allow_simd) {
+    switch (size_of_component) {
+    case sizeof(u8):  return getConvertFunc<u8> (n_components, swap, allow_simd);
+    case sizeof(u16): return getConvertFunc<u16>(n_components, swap, allow_simd);
+    case sizeof(u32): return getConvertFunc<u32>(n_components, swap, allow_simd);
+    default: Helpers::panic("Unimplemented vertex component size %d\n", size_of_component);
+    }
+}
+
+}   // End namespace VertexConverter
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <common.hpp>
+
+
+// Vertex attribute conversion.
+// Attributes are converted one stream at a time: every component of every vertex is byteswapped from src (guest layout, src_stride apart)
+// to dst (dst_stride apart). The functions are specialized on component size and count, with an SSSE3 (pshufb) version on x86-64 CPUs that have it.
+namespace VertexConverter {
+
+using ConvertFunc = void (*)(const u8* src, u32 src_stride, u8* dst, u32 dst_stride, u32 n);
+
+// Components that aren't swapped are only copied. allow_simd = false always returns the scalar version
+ConvertFunc getConvertFunc(u32 size_of_component, u32 n_components, bool swap, bool allow_simd = true);
+
+}   // End namespace VertexConverter
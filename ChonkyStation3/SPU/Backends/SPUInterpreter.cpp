@@ -1,5 +1,6 @@
 #include "SPUInterpreter.hpp"
 #include <PlayStation3.hpp>
+#include <CPUFeatures.hpp>
 
 
 //#define SPURS_TRACE
@@ -11,6 +12,38 @@ MAKE_LOG_FUNCTION(logSpurs, cellSpurs)
 
 #endif
 
+// SSE2 is always available on x86-64. shufb also has an SSE4.1 version, used if the host CPU supports it
+#if defined(__SSE2__) || defined(_M_X64)
+#define SPU_SSE2
+#include <immintrin.h>
+
+static inline __m128i loadVec(const v128& v) { return _mm_loadu_si128((const __m128i*)&v); }
+static inline __m128 loadVecF(const v128& v) { return _mm_loadu_ps(v.f); }
+static inline void storeVec(v128& v, __m128i val) { _mm_storeu_si128((__m128i*)&v, val); }
+static inline void storeVecF(v128& v, __m128 val) { _mm_storeu_ps(v.f, val); }
+#endif
+
+#ifdef CHONKYSTATION3_X64
+#define SPU_SSE41
+static const bool has_sse41 = CPUFeatures::hasSSE41();
+
+TARGET_SSE41 static void shufbSSE41(v128& rt, const v128& ra, const v128& rb, const v128& rc) {
+    const __m128i ctrl = loadVec(rc);
+    // Byte i selects byte 31 - (ctrl & 0x1f) of rb:ra, which is byte 15 - (ctrl & 0xf) of either ra or rb
+    const __m128i idx = _mm_and_si128(_mm_xor_si128(ctrl, _mm_set1_epi8(0x0f)), _mm_set1_epi8(0x0f));
+    const __m128i from_ra = _mm_shuffle_epi8(loadVec(ra), idx);
+    const __m128i from_rb = _mm_shuffle_epi8(loadVec(rb), idx);
+    const __m128i use_rb = _mm_cmpeq_epi8(_mm_and_si128(ctrl, _mm_set1_epi8(0x10)), _mm_set1_epi8(0x10));
+    const __m128i res = _mm_blendv_epi8(from_ra, from_rb, use_rb);
+    // Special cases: 10xxxxxx -> 0x00, 110xxxxx -> 0xff, 111xxxxx -> 0x80
+    const __m128i special = _mm_cmplt_epi8(ctrl, _mm_setzero_si128());
+    const __m128i bit6 = _mm_cmpeq_epi8(_mm_and_si128(ctrl, _mm_set1_epi8(0x40)), _mm_set1_epi8(0x40));
+    const __m128i bit5 = _mm_cmpeq_epi8(_mm_and_si128(ctrl, _mm_set1_epi8(0x20)), _mm_set1_epi8(0x20));
+    const __m128i special_val = _mm_andnot_si128(_mm_and_si128(bit5, _mm_set1_epi8(0x7f)), bit6);
+    storeVec(rt, _mm_blendv_epi8(res, special_val, special));
+}
+#endif
+
 #define UNIMPL_INSTR(name)                                                      \
 void SPUInterpreter::name(const SPUInstruction& instr) {                        \
     Helpers::panic("Unimplemented instruction %s @ 0x%08x\n", #name, state.pc); \
@@ -227,7 +260,7 @@ int SPUInterpreter::step() {
     if (!enabled) return 0;
     
     int cycles = 0;
-    const int limit = ps3->thread_manager.getCurrentThread()->id == ps3->thread_manager.idle_thread_id ? 40960 : 1280;
+    const int limit = cyclesPerStep();
     should_break = false;
     
     while (!should_break) {
@@ -282,6 +315,7 @@ void SPUInterpreter::unimpl(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::stop(const SPUInstruction& instr) {
+    auto lock = ps3->spu_thread_manager.lock();
     ps3->spu_thread_manager.getCurrentThread()->stop(instr.raw & 0x3ffff);
     state.pc -= 4;
     should_break = true;
@@ -294,30 +328,42 @@ void SPUInterpreter::sync(const SPUInstruction& instr) {}
 void SPUInterpreter::dsync(const SPUInstruction& instr) {}
 
 void SPUInterpreter::rdch(const SPUInstruction& instr) {
+    auto lock = ps3->spu_thread_manager.lock();
     clr(state.gprs[instr.rt0]);
     state.gprs[instr.rt0].w[3] = ps3->spu_thread_manager.getCurrentThread()->readChannel(instr.ch);
     // Check if the channel read caused the SPU thread to stall (i.e. when reading the event stat channel)
     // If it did stall, decrease pc so that when the thread wakes up it executes this instruction again and reads the actual value.
     if (ps3->spu_thread_manager.getCurrentThread() == nullptr)         state.pc -= 4;
     else if (!ps3->spu_thread_manager.getCurrentThread()->isRunning()) state.pc -= 4;
-    should_break = true;
+    // On host threads there is no other SPU thread to switch to, only break if this one stalled
+    if (!on_host_thread || !ps3->spu_thread_manager.getCurrentThread()->isRunning())
+        should_break = true;
 }
 
 void SPUInterpreter::rchcnt(const SPUInstruction& instr) {
+    auto lock = ps3->spu_thread_manager.lock();
     clr(state.gprs[instr.rt0]);
     state.gprs[instr.rt0].w[3] = ps3->spu_thread_manager.getCurrentThread()->readChannelCount(instr.ch);
 }
 
 void SPUInterpreter::sf(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_sub_epi32(loadVec(state.gprs[instr.rb]), loadVec(state.gprs[instr.ra])));
+#else
     state.gprs[instr.rt0].w[0] = state.gprs[instr.rb].w[0] - state.gprs[instr.ra].w[0];
     state.gprs[instr.rt0].w[1] = state.gprs[instr.rb].w[1] - state.gprs[instr.ra].w[1];
     state.gprs[instr.rt0].w[2] = state.gprs[instr.rb].w[2] - state.gprs[instr.ra].w[2];
     state.gprs[instr.rt0].w[3] = state.gprs[instr.rb].w[3] - state.gprs[instr.ra].w[3];
+#endif
 }
 
 void SPUInterpreter::or_(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_or_si128(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] | state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] | state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::bg(const SPUInstruction& instr) {
@@ -328,13 +374,21 @@ void SPUInterpreter::bg(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::sfh(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_sub_epi16(loadVec(state.gprs[instr.rb]), loadVec(state.gprs[instr.ra])));
+#else
     for (int i = 0; i < 8; i++)
         state.gprs[instr.rt0].h[i] = state.gprs[instr.rb].h[i] - state.gprs[instr.ra].h[i];
+#endif
 }
 
 void SPUInterpreter::nor(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_xor_si128(_mm_or_si128(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])), _mm_set1_epi32(-1)));
+#else
     state.gprs[instr.rt0].dw[0] = ~(state.gprs[instr.ra].dw[0] | state.gprs[instr.rb].dw[0]);
     state.gprs[instr.rt0].dw[1] = ~(state.gprs[instr.ra].dw[1] | state.gprs[instr.rb].dw[1]);
+#endif
 }
 
 void SPUInterpreter::rot(const SPUInstruction& instr) {
@@ -411,15 +465,23 @@ void SPUInterpreter::rothmi(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::a(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_add_epi32(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].w[0] = state.gprs[instr.ra].w[0] + state.gprs[instr.rb].w[0];
     state.gprs[instr.rt0].w[1] = state.gprs[instr.ra].w[1] + state.gprs[instr.rb].w[1];
     state.gprs[instr.rt0].w[2] = state.gprs[instr.ra].w[2] + state.gprs[instr.rb].w[2];
     state.gprs[instr.rt0].w[3] = state.gprs[instr.ra].w[3] + state.gprs[instr.rb].w[3];
+#endif
 }
 
 void SPUInterpreter::and_(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_and_si128(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] & state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] & state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::cg(const SPUInstruction& instr) {
@@ -430,22 +492,32 @@ void SPUInterpreter::cg(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::ah(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_add_epi16(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     for (int i = 0; i < 8; i++)
         state.gprs[instr.rt0].h[i] = state.gprs[instr.ra].h[i] + state.gprs[instr.rb].h[i];
+#endif
 }
 
 void SPUInterpreter::nand(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_xor_si128(_mm_and_si128(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])), _mm_set1_epi32(-1)));
+#else
     state.gprs[instr.rt0].dw[0] = ~(state.gprs[instr.ra].dw[0] & state.gprs[instr.rb].dw[0]);
     state.gprs[instr.rt0].dw[1] = ~(state.gprs[instr.ra].dw[1] & state.gprs[instr.rb].dw[1]);
+#endif
 }
 
 void SPUInterpreter::wrch(const SPUInstruction& instr) {
+    auto lock = ps3->spu_thread_manager.lock();
     ps3->spu_thread_manager.getCurrentThread()->writeChannel(instr.ch, state.gprs[instr.rt0].w[3]);
     
     // Read rdch for explanation
     if (ps3->spu_thread_manager.getCurrentThread() == nullptr)         state.pc -= 4;
     else if (!ps3->spu_thread_manager.getCurrentThread()->isRunning()) state.pc -= 4;
-    should_break = true;
+    if (!on_host_thread || !ps3->spu_thread_manager.getCurrentThread()->isRunning())
+        should_break = true;
 }
 
 void SPUInterpreter::biz(const SPUInstruction& instr) {
@@ -765,20 +837,32 @@ void SPUInterpreter::shlqbyi(const SPUInstruction& instr) {
 void SPUInterpreter::nop(const SPUInstruction& instr) {}
 
 void SPUInterpreter::cgt(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_cmpgt_epi32(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].w[0] = ((s32)state.gprs[instr.ra].w[0] > (s32)state.gprs[instr.rb].w[0]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = ((s32)state.gprs[instr.ra].w[1] > (s32)state.gprs[instr.rb].w[1]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = ((s32)state.gprs[instr.ra].w[2] > (s32)state.gprs[instr.rb].w[2]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = ((s32)state.gprs[instr.ra].w[3] > (s32)state.gprs[instr.rb].w[3]) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::xor_(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_xor_si128(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] ^ state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] ^ state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::eqv(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_xor_si128(loadVec(state.gprs[instr.ra]), _mm_xor_si128(loadVec(state.gprs[instr.rb]), _mm_set1_epi32(-1))));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] ^ ~state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] ^ ~state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::sumb(const SPUInstruction& instr) {
@@ -819,60 +903,99 @@ void SPUInterpreter::xsbh(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::clgt(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    const __m128i sign = _mm_set1_epi32(0x80000000);
+    storeVec(state.gprs[instr.rt0], _mm_cmpgt_epi32(_mm_xor_si128(loadVec(state.gprs[instr.ra]), sign), _mm_xor_si128(loadVec(state.gprs[instr.rb]), sign)));
+#else
     state.gprs[instr.rt0].w[0] = (state.gprs[instr.ra].w[0] > state.gprs[instr.rb].w[0]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = (state.gprs[instr.ra].w[1] > state.gprs[instr.rb].w[1]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = (state.gprs[instr.ra].w[2] > state.gprs[instr.rb].w[2]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = (state.gprs[instr.ra].w[3] > state.gprs[instr.rb].w[3]) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::andc(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_andnot_si128(loadVec(state.gprs[instr.rb]), loadVec(state.gprs[instr.ra])));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] & ~state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] & ~state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::fcgt(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt0], _mm_cmpgt_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].w[0] = (state.gprs[instr.ra].f[0] > state.gprs[instr.rb].f[0]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = (state.gprs[instr.ra].f[1] > state.gprs[instr.rb].f[1]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = (state.gprs[instr.ra].f[2] > state.gprs[instr.rb].f[2]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = (state.gprs[instr.ra].f[3] > state.gprs[instr.rb].f[3]) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::fa(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt0], _mm_add_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].f[0] = state.gprs[instr.ra].f[0] + state.gprs[instr.rb].f[0];
     state.gprs[instr.rt0].f[1] = state.gprs[instr.ra].f[1] + state.gprs[instr.rb].f[1];
     state.gprs[instr.rt0].f[2] = state.gprs[instr.ra].f[2] + state.gprs[instr.rb].f[2];
     state.gprs[instr.rt0].f[3] = state.gprs[instr.ra].f[3] + state.gprs[instr.rb].f[3];
+#endif
 }
 
 void SPUInterpreter::fs(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt0], _mm_sub_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].f[0] = state.gprs[instr.ra].f[0] - state.gprs[instr.rb].f[0];
     state.gprs[instr.rt0].f[1] = state.gprs[instr.ra].f[1] - state.gprs[instr.rb].f[1];
     state.gprs[instr.rt0].f[2] = state.gprs[instr.ra].f[2] - state.gprs[instr.rb].f[2];
     state.gprs[instr.rt0].f[3] = state.gprs[instr.ra].f[3] - state.gprs[instr.rb].f[3];
+#endif
 }
 
 void SPUInterpreter::fm(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt0], _mm_mul_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].f[0] = state.gprs[instr.ra].f[0] * state.gprs[instr.rb].f[0];
     state.gprs[instr.rt0].f[1] = state.gprs[instr.ra].f[1] * state.gprs[instr.rb].f[1];
     state.gprs[instr.rt0].f[2] = state.gprs[instr.ra].f[2] * state.gprs[instr.rb].f[2];
     state.gprs[instr.rt0].f[3] = state.gprs[instr.ra].f[3] * state.gprs[instr.rb].f[3];
+#endif
 }
 
 void SPUInterpreter::clgth(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    const __m128i sign = _mm_set1_epi16(0x8000);
+    storeVec(state.gprs[instr.rt0], _mm_cmpgt_epi16(_mm_xor_si128(loadVec(state.gprs[instr.ra]), sign), _mm_xor_si128(loadVec(state.gprs[instr.rb]), sign)));
+#else
     for (int i = 0; i < 8; i++)
         state.gprs[instr.rt0].h[i] = (state.gprs[instr.ra].h[i] > state.gprs[instr.rb].h[i]) ? 0xffff : 0;
+#endif
 }
 
 void SPUInterpreter::orc(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_or_si128(loadVec(state.gprs[instr.ra]), _mm_xor_si128(loadVec(state.gprs[instr.rb]), _mm_set1_epi32(-1))));
+#else
     state.gprs[instr.rt0].dw[0] = state.gprs[instr.ra].dw[0] | ~state.gprs[instr.rb].dw[0];
     state.gprs[instr.rt0].dw[1] = state.gprs[instr.ra].dw[1] | ~state.gprs[instr.rb].dw[1];
+#endif
 }
 
 void SPUInterpreter::fcmgt(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    storeVecF(state.gprs[instr.rt0], _mm_cmpgt_ps(_mm_and_ps(loadVecF(state.gprs[instr.ra]), abs_mask), _mm_and_ps(loadVecF(state.gprs[instr.rb]), abs_mask)));
+#else
     state.gprs[instr.rt0].w[0] = (std::abs(state.gprs[instr.ra].f[0]) > std::abs(state.gprs[instr.rb].f[0])) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = (std::abs(state.gprs[instr.ra].f[1]) > std::abs(state.gprs[instr.rb].f[1])) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = (std::abs(state.gprs[instr.ra].f[2]) > std::abs(state.gprs[instr.rb].f[2])) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = (std::abs(state.gprs[instr.ra].f[3]) > std::abs(state.gprs[instr.rb].f[3])) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::dfa(const SPUInstruction& instr) {
@@ -891,15 +1014,24 @@ void SPUInterpreter::dfm(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::clgtb(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    const __m128i sign = _mm_set1_epi8(0x80);
+    storeVec(state.gprs[instr.rt0], _mm_cmpgt_epi8(_mm_xor_si128(loadVec(state.gprs[instr.ra]), sign), _mm_xor_si128(loadVec(state.gprs[instr.rb]), sign)));
+#else
     for (int i = 0; i < 16; i++)
         state.gprs[instr.rt0].b[i] = (state.gprs[instr.ra].b[i] > state.gprs[instr.rb].b[i]) ? 0xff : 0;
+#endif
 }
 
 void SPUInterpreter::ceq(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_cmpeq_epi32(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].w[0] = (state.gprs[instr.ra].w[0] == state.gprs[instr.rb].w[0]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = (state.gprs[instr.ra].w[1] == state.gprs[instr.rb].w[1]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = (state.gprs[instr.ra].w[2] == state.gprs[instr.rb].w[2]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = (state.gprs[instr.ra].w[3] == state.gprs[instr.rb].w[3]) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::mpyhhu(const SPUInstruction& instr) {
@@ -946,17 +1078,27 @@ void SPUInterpreter::fscrwr(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::fceq(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt0], _mm_cmpeq_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])));
+#else
     state.gprs[instr.rt0].w[0] = (state.gprs[instr.ra].f[0] == state.gprs[instr.rb].f[0]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[1] = (state.gprs[instr.ra].f[1] == state.gprs[instr.rb].f[1]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[2] = (state.gprs[instr.ra].f[2] == state.gprs[instr.rb].f[2]) ? 0xffffffff : 0;
     state.gprs[instr.rt0].w[3] = (state.gprs[instr.ra].f[3] == state.gprs[instr.rb].f[3]) ? 0xffffffff : 0;
+#endif
 }
 
 void SPUInterpreter::mpy(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    // Clearing the high halfwords makes pmaddwd a signed 16x16 -> 32 bit multiply
+    const __m128i lo_mask = _mm_set1_epi32(0xffff);
+    storeVec(state.gprs[instr.rt0], _mm_madd_epi16(_mm_and_si128(loadVec(state.gprs[instr.ra]), lo_mask), _mm_and_si128(loadVec(state.gprs[instr.rb]), lo_mask)));
+#else
     state.gprs[instr.rt0].w[0] = (s32)(s16)(state.gprs[instr.ra].w[0] & 0xffff) * (s32)(s16)(state.gprs[instr.rb].w[0] & 0xffff);
     state.gprs[instr.rt0].w[1] = (s32)(s16)(state.gprs[instr.ra].w[1] & 0xffff) * (s32)(s16)(state.gprs[instr.rb].w[1] & 0xffff);
     state.gprs[instr.rt0].w[2] = (s32)(s16)(state.gprs[instr.ra].w[2] & 0xffff) * (s32)(s16)(state.gprs[instr.rb].w[2] & 0xffff);
     state.gprs[instr.rt0].w[3] = (s32)(s16)(state.gprs[instr.ra].w[3] & 0xffff) * (s32)(s16)(state.gprs[instr.rb].w[3] & 0xffff);
+#endif
 }
 
 void SPUInterpreter::mpyh(const SPUInstruction& instr) {
@@ -981,8 +1123,12 @@ void SPUInterpreter::mpys(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::ceqh(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_cmpeq_epi16(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     for (int i = 0; i < 8; i++)
         state.gprs[instr.rt0].h[i] = (state.gprs[instr.ra].h[i] == state.gprs[instr.rb].h[i]) ? 0xffff : 0;
+#endif
 }
 
 void SPUInterpreter::mpyu(const SPUInstruction& instr) {
@@ -993,8 +1139,12 @@ void SPUInterpreter::mpyu(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::ceqb(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt0], _mm_cmpeq_epi8(loadVec(state.gprs[instr.ra]), loadVec(state.gprs[instr.rb])));
+#else
     for (int i = 0; i < 16; i++)
         state.gprs[instr.rt0].b[i] = (state.gprs[instr.ra].b[i] == state.gprs[instr.rb].b[i]) ? 0xff : 0;
+#endif
 }
 
 void SPUInterpreter::fi(const SPUInstruction& instr) {
@@ -1332,11 +1482,21 @@ void SPUInterpreter::ila(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::selb(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVec(state.gprs[instr.rt], _mm_or_si128(_mm_andnot_si128(loadVec(state.gprs[instr.rc]), loadVec(state.gprs[instr.ra])), _mm_and_si128(loadVec(state.gprs[instr.rb]), loadVec(state.gprs[instr.rc]))));
+#else
     state.gprs[instr.rt].dw[0] = (state.gprs[instr.ra].dw[0] & ~state.gprs[instr.rc].dw[0]) | (state.gprs[instr.rb].dw[0] & state.gprs[instr.rc].dw[0]);
     state.gprs[instr.rt].dw[1] = (state.gprs[instr.ra].dw[1] & ~state.gprs[instr.rc].dw[1]) | (state.gprs[instr.rb].dw[1] & state.gprs[instr.rc].dw[1]);
+#endif
 }
 
 void SPUInterpreter::shufb(const SPUInstruction& instr) {
+#ifdef SPU_SSE41
+    if (has_sse41) {
+        shufbSSE41(state.gprs[instr.rt], state.gprs[instr.ra], state.gprs[instr.rb], state.gprs[instr.rc]);
+        return;
+    }
+#endif
     u8 src[32];
     for (int i = 0; i < 16; i++) src[i +  0] = state.gprs[instr.rb].b[i];
     for (int i = 0; i < 16; i++) src[i + 16] = state.gprs[instr.ra].b[i];
@@ -1358,24 +1518,36 @@ void SPUInterpreter::mpya(const SPUInstruction& instr) {
 }
 
 void SPUInterpreter::fnms(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt], _mm_sub_ps(loadVecF(state.gprs[instr.rc]), _mm_mul_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb]))));
+#else
     state.gprs[instr.rt].f[0] = state.gprs[instr.rc].f[0] - state.gprs[instr.ra].f[0] * state.gprs[instr.rb].f[0];
     state.gprs[instr.rt].f[1] = state.gprs[instr.rc].f[1] - state.gprs[instr.ra].f[1] * state.gprs[instr.rb].f[1];
     state.gprs[instr.rt].f[2] = state.gprs[instr.rc].f[2] - state.gprs[instr.ra].f[2] * state.gprs[instr.rb].f[2];
     state.gprs[instr.rt].f[3] = state.gprs[instr.rc].f[3] - state.gprs[instr.ra].f[3] * state.gprs[instr.rb].f[3];
+#endif
 }
 
 void SPUInterpreter::fma(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt], _mm_add_ps(_mm_mul_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])), loadVecF(state.gprs[instr.rc])));
+#else
     state.gprs[instr.rt].f[0] = state.gprs[instr.ra].f[0] * state.gprs[instr.rb].f[0] + state.gprs[instr.rc].f[0];
     state.gprs[instr.rt].f[1] = state.gprs[instr.ra].f[1] * state.gprs[instr.rb].f[1] + state.gprs[instr.rc].f[1];
     state.gprs[instr.rt].f[2] = state.gprs[instr.ra].f[2] * state.gprs[instr.rb].f[2] + state.gprs[instr.rc].f[2];
     state.gprs[instr.rt].f[3] = state.gprs[instr.ra].f[3] * state.gprs[instr.rb].f[3] + state.gprs[instr.rc].f[3];
+#endif
 }
 
 void SPUInterpreter::fms(const SPUInstruction& instr) {
+#ifdef SPU_SSE2
+    storeVecF(state.gprs[instr.rt], _mm_sub_ps(_mm_mul_ps(loadVecF(state.gprs[instr.ra]), loadVecF(state.gprs[instr.rb])), loadVecF(state.gprs[instr.rc])));
+#else
     state.gprs[instr.rt].f[0] = state.gprs[instr.ra].f[0] * state.gprs[instr.rb].f[0] - state.gprs[instr.rc].f[0];
     state.gprs[instr.rt].f[1] = state.gprs[instr.ra].f[1] * state.gprs[instr.rb].f[1] - state.gprs[instr.rc].f[1];
     state.gprs[instr.rt].f[2] = state.gprs[instr.ra].f[2] * state.gprs[instr.rb].f[2] - state.gprs[instr.rc].f[2];
     state.gprs[instr.rt].f[3] = state.gprs[instr.ra].f[3] * state.gprs[instr.rb].f[3] - state.gprs[instr.rc].f[3];
+#endif
 }
 
 //UNIMPL_INSTR(stop);
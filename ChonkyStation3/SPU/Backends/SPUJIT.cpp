@@ -0,0 +1,379 @@
+#include "SPUJIT.hpp"
+#include <PlayStation3.hpp>
+
+#ifdef CHONKYSTATION3_SPU_JIT
+
+#include <bit>
+
+#include <xxhash.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+
+// Opcodes of the natively emitted SSE instructions (op xmm0, xmm1)
+static constexpr u8 PADDD[]     = { 0x66, 0x0f, 0xfe };
+static constexpr u8 PADDW[]     = { 0x66, 0x0f, 0xfd };
+static constexpr u8 PSUBD[]     = { 0x66, 0x0f, 0xfa };
+static constexpr u8 PSUBW[]     = { 0x66, 0x0f, 0xf9 };
+static constexpr u8 PAND[]      = { 0x66, 0x0f, 0xdb };
+static constexpr u8 PANDN[]     = { 0x66, 0x0f, 0xdf };
+static constexpr u8 POR[]       = { 0x66, 0x0f, 0xeb };
+static constexpr u8 PXOR[]      = { 0x66, 0x0f, 0xef };
+static constexpr u8 PCMPEQD[]   = { 0x66, 0x0f, 0x76 };
+static constexpr u8 PCMPEQW[]   = { 0x66, 0x0f, 0x75 };
+static constexpr u8 PCMPEQB[]   = { 0x66, 0x0f, 0x74 };
+static constexpr u8 PCMPGTD[]   = { 0x66, 0x0f, 0x66 };
+static constexpr u8 ADDPS[]     = { 0x0f, 0x58 };
+static constexpr u8 SUBPS[]     = { 0x0f, 0x5c };
+static constexpr u8 MULPS[]     = { 0x0f, 0x59 };
+
+SPUJIT::SPUJIT(PlayStation3* ps3, bool compare) : SPUInterpreter(ps3), compare(compare) {
+#ifdef _WIN32
+    code_buffer = (u8*)VirtualAlloc(nullptr, CODE_BUFFER_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+    if (!code_buffer)
+        Helpers::panic("SPUJIT: failed to allocate code buffer\n");
+#else
+    code_buffer = (u8*)mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code_buffer == MAP_FAILED)
+        Helpers::panic("SPUJIT: failed to allocate code buffer\n");
+#endif
+    code_ptr = code_buffer;
+}
+
+SPUJIT::~SPUJIT() {
+#ifdef _WIN32
+    VirtualFree(code_buffer, 0, MEM_RELEASE);
+#else
+    munmap(code_buffer, CODE_BUFFER_SIZE);
+#endif
+}
+
+int SPUJIT::step() {
+    if (!enabled) return 0;
+
+    int cycles = 0;
+    const int limit = cyclesPerStep();
+    should_break = false;
+    depth++;
+
+    while (!should_break) {
+        BlockFunc func = getCode(state.pc);
+        if (!func) {
+            // The code buffer is full and can't be flushed right now, interpret a single instruction
+            const SPUInstruction instr = { .raw = read<u32>(state.pc) };
+            (this->*instr_table[(instr.raw >> (32 - INSTR_BITS)) & INSTR_MASK])(instr);
+            state.pc += 4;
+            cycles++;
+        }
+        else cycles += func();
+
+        if (cycles > limit) should_break = true;
+    }
+
+    depth--;
+    return cycles;
+}
+
+SPUJIT::BlockFunc SPUJIT::getCode(u32 addr) {
+    // Skip the hash if none of the pages of the block we found last time were written since
+    LSCache* cache = getLSCache();
+    if (cache) {
+        auto it = cache->checked.find(addr);
+        if (it != cache->checked.end()) {
+            const auto& checked = it->second;
+            if (cache->page_gens[addr >> LS_PAGE_SHIFT] == checked.first_gen && cache->page_gens[checked.last_page] == checked.last_gen)
+                return checked.code;
+        }
+    }
+
+    // Look for a block with the same contents as the code currently in LS
+    auto& versions = blocks[addr];
+    u32 hashed_size = 0;
+    u64 hash = 0;
+    for (auto& block : versions) {
+        if (block.size != hashed_size) {
+            hash = XXH3_64bits(&ls[addr], block.size);
+            hashed_size = block.size;
+        }
+        if (block.hash == hash) {
+            setChecked(cache, addr, block);
+            return block.code;
+        }
+    }
+
+    Block block = decodeBlock(addr);
+    // Worst case is 3 calls per instruction in compare mode
+    const size_t max_size = block.entries.size() * 128 + 64;
+    if (code_ptr + max_size > code_buffer + CODE_BUFFER_SIZE) {
+        // We can't throw away the code buffer while one of the blocks in it is still running
+        if (depth > 1) return nullptr;
+        flush();
+    }
+
+    auto& new_versions = blocks[addr];
+    // Drop the oldest version, unless it could be one of the blocks that are currently running
+    if (new_versions.size() >= MAX_BLOCK_VERSIONS && depth == 1) {
+        const BlockFunc evicted = new_versions.front().code;
+        for (auto& [cache_ls, other] : ls_caches) {
+            auto it = other.checked.find(addr);
+            if (it != other.checked.end() && it->second.code == evicted)
+                other.checked.erase(it);
+        }
+        new_versions.erase(new_versions.begin());
+    }
+    new_versions.push_back(std::move(block));
+
+    // Entries are referenced by the generated code, compile the block once it's in its final place
+    Block& new_block = new_versions.back();
+    new_block.code = compile(new_block);
+    setChecked(cache, addr, new_block);
+    return new_block.code;
+}
+
+SPUJIT::LSCache* SPUJIT::getLSCache() {
+    // Writes to this LS aren't tracked, blocks have to be hashed every time
+    if (!ls_dirty) return nullptr;
+
+    if (ls != cached_ls) {
+        cached_ls = ls;
+        ls_cache = &ls_caches[ls];
+    }
+    if (ls_dirty->load(std::memory_order_relaxed)) {
+        u64 dirty = ls_dirty->exchange(0, std::memory_order_acquire);
+        while (dirty) {
+            ls_cache->page_gens[std::countr_zero(dirty)]++;
+            dirty &= dirty - 1;
+        }
+    }
+    return ls_cache;
+}
+
+void SPUJIT::setChecked(LSCache* cache, u32 addr, const Block& block) {
+    if (!cache) return;
+    const u32 last_page = (addr + block.size - 1) >> LS_PAGE_SHIFT;
+    cache->checked[addr] = { block.code, last_page, cache->page_gens[addr >> LS_PAGE_SHIFT], cache->page_gens[last_page] };
+}
+
+SPUJIT::Block SPUJIT::decodeBlock(u32 addr) {
+    Block block;
+    block.start = addr;
+    block.entries.reserve(16);
+
+    u32 pc = addr;
+    while (block.entries.size() < MAX_BLOCK_SIZE && pc < 256_KB) {
+        const SPUInstruction instr = { .raw = read<u32>(pc) };
+        const Handler handler = instr_table[(instr.raw >> (32 - INSTR_BITS)) & INSTR_MASK];
+        block.entries.push_back({ handler, instr });
+        pc += 4;
+
+        if (isBlockEnd(handler)) break;
+    }
+    block.size = pc - addr;
+    block.hash = XXH3_64bits(&ls[addr], block.size);
+    return block;
+}
+
+bool SPUJIT::isBlockEnd(Handler handler) {
+    return     handler == &SPUInterpreter::stop   || handler == &SPUInterpreter::stopd
+            || handler == &SPUInterpreter::br     || handler == &SPUInterpreter::bra
+            || handler == &SPUInterpreter::brsl   || handler == &SPUInterpreter::brasl
+            || handler == &SPUInterpreter::brz    || handler == &SPUInterpreter::brnz
+            || handler == &SPUInterpreter::brhz   || handler == &SPUInterpreter::brhnz
+            || handler == &SPUInterpreter::bi     || handler == &SPUInterpreter::bisl
+            || handler == &SPUInterpreter::biz    || handler == &SPUInterpreter::binz
+            || handler == &SPUInterpreter::bihz   || handler == &SPUInterpreter::bihnz
+            || handler == &SPUInterpreter::iret   || handler == &SPUInterpreter::bisled
+            || handler == &SPUInterpreter::heq    || handler == &SPUInterpreter::heqi
+            || handler == &SPUInterpreter::hgt    || handler == &SPUInterpreter::hgti
+            || handler == &SPUInterpreter::hlgt   || handler == &SPUInterpreter::hlgti
+            || handler == &SPUInterpreter::unimpl;
+}
+
+SPUJIT::BlockFunc SPUJIT::compile(Block& block) {
+    BlockFunc func = (BlockFunc)code_ptr;
+
+    // Prologue
+    emit8(0x53);    // push rbx
+#ifdef _WIN32
+    // Shadow space
+    emit8(0x48); emit8(0x83); emit8(0xec); emit8(0x20);     // sub rsp, 32
+#endif
+    emit8(0x48); emit8(0xbb); emit64((u64)&state);          // mov rbx, &state
+
+    u32 pending_pc = 0;
+    auto flushPC = [&]() {
+        if (pending_pc) {
+            emitAddPC(pending_pc);
+            pending_pc = 0;
+        }
+    };
+
+    for (int i = 0; i < block.entries.size(); i++) {
+        const Entry* entry = &block.entries[i];
+        u8* native_start = code_ptr;
+
+        if (compare) {
+            flushPC();
+            emitCall((void*)&SPUJIT::compareBefore, entry);
+        }
+
+        if (compileNative(*entry)) {
+            pending_pc += 4;
+            if (compare) {
+                flushPC();
+                emitCall((void*)&SPUJIT::compareAfter, entry);
+            }
+            continue;
+        }
+
+        // Not natively implemented, fall back to the interpreter
+        code_ptr = native_start;
+        flushPC();
+        emitCall((void*)&SPUJIT::callHandler, entry);
+
+        // Exit early if the handler asked to (channel stalls, context switches...)
+        emit8(0x84); emit8(0xc0);   // test al, al
+        emit8(0x74); u8* jz = code_ptr; emit8(0);   // jz skip
+        emit8(0xb8); emit32(i + 1); // mov eax, executed instructions
+        emitEpilogue();
+        *jz = code_ptr - jz - 1;
+    }
+
+    flushPC();
+    emit8(0xb8); emit32(block.entries.size());  // mov eax, executed instructions
+    emitEpilogue();
+
+    log("Compiled block 0x%05x (%d instructions, %d bytes, hash 0x%016llx)\n", block.start, block.entries.size(), (u32)(code_ptr - (u8*)func), block.hash);
+    return func;
+}
+
+// Emits host code for simple vector instructions. Returns false if the instruction has to go through the interpreter
+bool SPUJIT::compileNative(const Entry& entry) {
+    const Handler handler = entry.handler;
+    const SPUInstruction& instr = entry.instr;
+
+    // RR form
+    if (handler == &SPUInterpreter::a)          emitVectorOp(PADDD,   3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::ah)    emitVectorOp(PADDW,   3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::sf)    emitVectorOp(PSUBD,   3, instr.rt0, instr.rb, instr.ra);
+    else if (handler == &SPUInterpreter::sfh)   emitVectorOp(PSUBW,   3, instr.rt0, instr.rb, instr.ra);
+    else if (handler == &SPUInterpreter::and_)  emitVectorOp(PAND,    3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::andc)  emitVectorOp(PANDN,   3, instr.rt0, instr.rb, instr.ra);
+    else if (handler == &SPUInterpreter::or_)   emitVectorOp(POR,     3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::xor_)  emitVectorOp(PXOR,    3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::ceq)   emitVectorOp(PCMPEQD, 3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::ceqh)  emitVectorOp(PCMPEQW, 3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::ceqb)  emitVectorOp(PCMPEQB, 3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::cgt)   emitVectorOp(PCMPGTD, 3, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::fa)    emitVectorOp(ADDPS,   2, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::fs)    emitVectorOp(SUBPS,   2, instr.rt0, instr.ra, instr.rb);
+    else if (handler == &SPUInterpreter::fm)    emitVectorOp(MULPS,   2, instr.rt0, instr.ra, instr.rb);
+    // Immediate loads
+    else if (handler == &SPUInterpreter::il)    emitBroadcast(instr.rt0, (s32)(s16)instr.i16);
+    else if (handler == &SPUInterpreter::ilhu)  emitBroadcast(instr.rt0, instr.i16 << 16);
+    else if (handler == &SPUInterpreter::ilh)   emitBroadcast(instr.rt0, instr.i16 | (instr.i16 << 16));
+    else if (handler == &SPUInterpreter::ila)   emitBroadcast(instr.rt0, instr.i18);
+    else if (handler == &SPUInterpreter::lnop || handler == &SPUInterpreter::nop) {}
+    else return false;
+
+    return true;
+}
+
+u8 SPUJIT::callHandler(SPUJIT* jit, const Entry* entry) {
+    (jit->*entry->handler)(entry->instr);
+    jit->state.pc += 4;
+    return jit->should_break;
+}
+
+// Runs the instruction through the interpreter and saves the result, then restores the state so the JIT code can run
+void SPUJIT::compareBefore(SPUJIT* jit, const Entry* entry) {
+    jit->saved_state = jit->state;
+    (jit->*entry->handler)(entry->instr);
+    jit->state.pc += 4;
+    jit->expected_state = jit->state;
+    jit->state = jit->saved_state;
+}
+
+void SPUJIT::compareAfter(SPUJIT* jit, const Entry* entry) {
+    const auto& jit_state = jit->state;
+    const auto& expected = jit->expected_state;
+    const u32 pc = jit_state.pc - 4;
+
+    for (int i = 0; i < 128; i++) {
+        if (std::memcmp(&jit_state.gprs[i], &expected.gprs[i], sizeof(SPUTypes::GPR))) {
+            Helpers::panic("SPUJIT: r%d mismatch after 0x%08x @ 0x%05x (jit: { 0x%08x, 0x%08x, 0x%08x, 0x%08x }, interpreter: { 0x%08x, 0x%08x, 0x%08x, 0x%08x })\n", i, entry->instr.raw, pc,
+                jit_state.gprs[i].w[3], jit_state.gprs[i].w[2], jit_state.gprs[i].w[1], jit_state.gprs[i].w[0],
+                expected.gprs[i].w[3], expected.gprs[i].w[2], expected.gprs[i].w[1], expected.gprs[i].w[0]);
+        }
+    }
+    if (jit_state.pc != expected.pc)
+        Helpers::panic("SPUJIT: pc mismatch after 0x%08x @ 0x%05x (jit: 0x%05x, interpreter: 0x%05x)\n", entry->instr.raw, pc, jit_state.pc, expected.pc);
+}
+
+void SPUJIT::flush() {
+    log("Code buffer full, flushing\n");
+    blocks.clear();
+    // Keep the page generations, getCode might still be holding on to one of the caches
+    for (auto& [cache_ls, cache] : ls_caches)
+        cache.checked.clear();
+    code_ptr = code_buffer;
+}
+
+void SPUJIT::emitLoadGPR(u8 xmm, int gpr) {
+    emit8(0xf3); emit8(0x0f); emit8(0x6f); emit8(0x83 | (xmm << 3));
+    emit32(offsetof(SPUTypes::State, gprs) + gpr * sizeof(SPUTypes::GPR));
+}
+
+void SPUJIT::emitStoreXMM0(int gpr) {
+    emit8(0xf3); emit8(0x0f); emit8(0x7f); emit8(0x83);
+    emit32(offsetof(SPUTypes::State, gprs) + gpr * sizeof(SPUTypes::GPR));
+}
+
+void SPUJIT::emitBroadcast(int gpr, u32 val) {
+    for (int i = 0; i < 4; i++) {
+        emit8(0xc7); emit8(0x83);   // mov dword [rbx + disp], val
+        emit32(offsetof(SPUTypes::State, gprs) + gpr * sizeof(SPUTypes::GPR) + i * sizeof(u32));
+        emit32(val);
+    }
+}
+
+void SPUJIT::emitVectorOp(const u8* opc, int len, int dst, int src0, int src1) {
+    emitLoadGPR(0, src0);
+    emitLoadGPR(1, src1);
+    for (int i = 0; i < len; i++)
+        emit8(opc[i]);
+    emit8(0xc1);    // xmm0, xmm1
+    emitStoreXMM0(dst);
+}
+
+void SPUJIT::emitAddPC(u32 val) {
+    emit8(0x81); emit8(0x83);
+    emit32(offsetof(SPUTypes::State, pc));
+    emit32(val);
+}
+
+void SPUJIT::emitCall(void* func, const Entry* entry) {
+#ifdef _WIN32
+    emit8(0x48); emit8(0xb9); emit64((u64)this);    // mov rcx, this
+    emit8(0x48); emit8(0xba); emit64((u64)entry);   // mov rdx, entry
+#else
+    emit8(0x48); emit8(0xbf); emit64((u64)this);    // mov rdi, this
+    emit8(0x48); emit8(0xbe); emit64((u64)entry);   // mov rsi, entry
+#endif
+    emit8(0x48); emit8(0xb8); emit64((u64)func);    // mov rax, func
+    emit8(0xff); emit8(0xd0);                       // call rax
+}
+
+void SPUJIT::emitEpilogue() {
+#ifdef _WIN32
+    emit8(0x48); emit8(0x83); emit8(0xc4); emit8(0x20);     // add rsp, 32
+#endif
+    emit8(0x5b);    // pop rbx
+    emit8(0xc3);    // ret
+}
+
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SPU/Backends/SPUInterpreter.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHONKYSTATION3_SPU_JIT
+#endif
+
+#ifdef CHONKYSTATION3_SPU_JIT
+
+// Circular dependency
+class PlayStation3;
+
+using namespace SPUTypes;
+
+// x86-64 recompiler for SPU local store code.
+// Blocks are decoded with the interpreter's instr_table and compiled to host code which works directly on the SPU state.
+// Every SPU thread has its own local store and programs overlay code at the same addresses, so blocks are keyed by
+// LS address plus a hash of the block's contents. Threads running the same program share blocks.
+// The hash is only computed again once one of the LS pages a block was found in has been written to (see ls_dirty).
+// Simple vector instructions are emitted natively, everything else is a call to the interpreter handler.
+// In compare mode every natively emitted instruction is also run through the interpreter and the resulting states are compared.
+class SPUJIT : public SPUInterpreter {
+public:
+    SPUJIT(PlayStation3* ps3, bool compare = false);
+    ~SPUJIT();
+    int step() override;
+
+    static constexpr size_t CODE_BUFFER_SIZE = 32_MB;
+    static constexpr size_t MAX_BLOCK_SIZE = 256;
+    static constexpr size_t MAX_BLOCK_VERSIONS = 16;    // Max number of blocks with different contents at the same LS address
+
+    using Handler = void (SPUInterpreter::*)(const SPUInstruction&);
+    using BlockFunc = u32 (*)();    // Returns the number of instructions executed
+
+    struct Entry {
+        Handler handler;
+        SPUInstruction instr;
+    };
+
+    struct Block {
+        u32 start;
+        u32 size;   // In bytes
+        u64 hash;
+        std::vector<Entry> entries;
+        BlockFunc code;
+    };
+    std::unordered_map<u32, std::vector<Block>> blocks;
+
+    // Block last found at each address of a local store, along with the generation of the pages it spans at that time.
+    // The generation of a page goes up every time the page is written, the block has to be hashed again then.
+    // The dirty bits of an SPU thread are consumed here, so only one SPU backend may run a given thread
+    struct LSCache {
+        struct CheckedBlock {
+            BlockFunc code;
+            u32 last_page;
+            u32 first_gen;
+            u32 last_gen;
+        };
+        u32 page_gens[256_KB >> LS_PAGE_SHIFT] = {};
+        std::unordered_map<u32, CheckedBlock> checked;
+    };
+    std::unordered_map<const u8*, LSCache> ls_caches;
+
+private:
+    MAKE_LOG_FUNCTION(log, spu_jit);
+
+    bool compare;
+    int depth = 0;  // Nested step() calls
+    SPUTypes::State saved_state;
+    SPUTypes::State expected_state;
+
+    u8* code_buffer = nullptr;
+    u8* code_ptr = nullptr;
+
+    const u8* cached_ls = nullptr;
+    LSCache* ls_cache = nullptr;    // ls_caches[cached_ls]
+
+    BlockFunc getCode(u32 addr);
+    LSCache* getLSCache();
+    void setChecked(LSCache* cache, u32 addr, const Block& block);
+    Block decodeBlock(u32 addr);
+    bool isBlockEnd(Handler handler);
+    BlockFunc compile(Block& block);
+    bool compileNative(const Entry& entry);
+    void flush();
+
+    // Called from the generated code
+    static u8 callHandler(SPUJIT* jit, const Entry* entry);
+    static void compareBefore(SPUJIT* jit, const Entry* entry);
+    static void compareAfter(SPUJIT* jit, const Entry* entry);
+
+    // Emitter
+    void emit8(u8 val) { *code_ptr++ = val; }
+    void emit32(u32 val) { std::memcpy(code_ptr, &val, 4); code_ptr += 4; }
+    void emit64(u64 val) { std::memcpy(code_ptr, &val, 8); code_ptr += 8; }
+    void emitLoadGPR(u8 xmm, int gpr);      // movdqu xmm, [rbx + gprs[gpr]]
+    void emitStoreXMM0(int gpr);            // movdqu [rbx + gprs[gpr]], xmm0
+    void emitBroadcast(int gpr, u32 val);   // Sets all 4 words of gprs[gpr] to val
+    void emitVectorOp(const u8* opc, int len, int dst, int src0, int src1); // dst = op(src0, src1)
+    void emitAddPC(u32 val);                // add dword [rbx + pc], val
+    void emitCall(void* func, const Entry* entry);
+    void emitEpilogue();
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "SPU.hpp"
+#include <PlayStation3.hpp>
 
 
 int SPU::step() {
@@ -20,6 +21,12 @@ void SPU::printState() {
     }
 }
 
+int SPU::cyclesPerStep() {
+    // Host threads don't have to give control back to the PPU, only to sync their state and check if they should stop
+    if (on_host_thread) return 40960;
+    return ps3->thread_manager.getCurrentThread()->id == ps3->thread_manager.idle_thread_id ? 40960 : 1280;
+}
+
 template<typename T>
 T SPU::read(u64 addr) {
     return Helpers::bswap<T>(*(T*)(&ls[addr]));
@@ -33,6 +40,7 @@ template<typename T>
 void SPU::write(u64 addr, T data) {
     data = Helpers::bswap<T>(data);
     std::memcpy(&ls[addr], &data, sizeof(T));
+    SPUTypes::markLSWritten(ls_dirty, addr, sizeof(T));
 }
 template void SPU::write(u64 addr, u8  data);
 template void SPU::write(u64 addr, u16 data);
@@ -17,11 +17,14 @@ public:
     virtual int step(); // Returns number of cycles executed
 
     bool enabled = false;
+    bool on_host_thread = false;    // Running a single SPU thread on its own host thread instead of being interleaved with the PPU
     SPUTypes::State state;
     u8* ls;
+    std::atomic<u64>* ls_dirty = nullptr;   // Dirty LS pages of the thread that owns ls, null if writes to it aren't tracked
 
     void clr(SPUTypes::GPR& gpr);   // Clears a register
     void printState();
+    int cyclesPerStep();    // How many instructions step() should run before returning
 
     template<typename T> T read(u64 addr);
     template<typename T> void write(u64 addr, T data);
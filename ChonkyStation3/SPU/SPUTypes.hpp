@@ -2,11 +2,29 @@
 
 #include <BitField.hpp>
 
+#include <atomic>
+
 
 namespace SPUTypes {
 
 using GPR = v128;
 
+// Local store pages written since the SPU JIT last looked at them, one bit per LS_PAGE_SIZE bytes.
+// Every write to LS that doesn't go through SPU::write has to call markLSWritten (DMA, loading images...)
+static constexpr u32 LS_PAGE_SHIFT = 12;
+static constexpr u32 LS_PAGE_SIZE = 1 << LS_PAGE_SHIFT;
+
+inline void markLSWritten(std::atomic<u64>* dirty, u32 addr, u32 size) {
+    if (!dirty || !size) return;
+    addr &= 0x3ffff;
+    const u32 first = addr >> LS_PAGE_SHIFT;
+    const u32 last = (addr + size - 1) >> LS_PAGE_SHIFT;
+    const u64 mask = (last < 64) ? ((~0ULL << first) & (~0ULL >> (63 - last))) : ~0ULL;    // Wraps around the end of LS
+    // Most stores hit pages that are already dirty, avoid the locked op for them
+    if ((dirty->load(std::memory_order_relaxed) & mask) != mask)
+        dirty->fetch_or(mask, std::memory_order_release);
+}
+
 struct State {
     GPR gprs[128] = { 0 };
     u32 pc = 0;
@@ -1,49 +1,125 @@
 #include "Scheduler.hpp"
 
 
+Scheduler::Scheduler() {
+    for (u32 i = 0; i < schedulerMaxEntries; i++)
+        free_slots[i] = schedulerMaxEntries - 1 - i;
+    n_free = schedulerMaxEntries;
+}
+
 void Scheduler::tick(u64 cycles) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
     time += cycles;
+    if (time < next_event_time) return;
 
-    while (events.size() && time >= events.top().time) {
-        auto event = events.top();
-        events.pop();
-        event.func();
-    }
+    // Handlers are called without holding the lock, they will often push new events
+    EventType type;
+    u64 payload;
+    while (popDue(time, type, payload))
+        handlers[(size_t)type](payload);
 }
 
 // Returns whether or not there was a next event
 bool Scheduler::tickToNextEvent(u64& elapsed) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    if (events.empty()) return false;
-    
-    elapsed = events.top().time - time;
-    time = events.top().time;
-    auto event = events.top();
-    events.pop();
-
-    //printf("Skipped to event \"%s\"\n", event.name.c_str());
-    event.func();
+    EventType type;
+    u64 payload;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!n_events) return false;
+
+        const u64 event_time = events[heap[0]].time;
+        elapsed = event_time - time;
+        time = event_time;
+    }
+
+    if (!popDue(time, type, payload)) return true;  // Another thread got to it first
+    handlers[(size_t)type](payload);
     return true;
 }
 
-void Scheduler::push(std::function<void(void)> func, u64 time, std::string name) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    Helpers::debugAssert(events.size() < schedulerMaxEntries, "Scheduler: queued more than %d scheduler events\n", schedulerMaxEntries);
+void Scheduler::setHandler(EventType type, Handler const& handler) {
+    handlers[(size_t)type] = handler;
+}
+
+Scheduler::Handle Scheduler::push(EventType type, u64 time, u64 payload) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Helpers::debugAssert(n_free, "Scheduler: queued more than %d scheduler events\n", schedulerMaxEntries);
+
+    const u32 slot = free_slots[--n_free];
+    Event& event = events[slot];
+    event.time = this->time + time;
+    event.payload = payload;
+    event.order = next_order++;
+    event.type = type;
+
+    setHeap(n_events, slot);
+    siftUp(n_events++);
+    next_event_time = events[heap[0]].time;
+    return ((u64)event.generation << 32) | slot;
+}
+
+void Scheduler::cancel(Handle handle) {
+    const u32 slot = handle & 0xffffffff;
+    const u32 generation = handle >> 32;
+    if (slot >= schedulerMaxEntries) return;
 
-    Event event = { func, this->time + time, next_event_id++, name };
-    events.push(event);
+    std::lock_guard<std::mutex> lock(mutex);
+    // The event already fired or was cancelled
+    if (events[slot].generation != generation) return;
+    removeAt(events[slot].heap_idx);
 }
 
-void Scheduler::deleteAllEventsOfName(std::string name) {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    auto eventList = events.get_container();
+void Scheduler::siftUp(u32 idx) {
+    const u32 slot = heap[idx];
+    while (idx) {
+        const u32 parent = (idx - 1) / 2;
+        if (!before(slot, heap[parent])) break;
+        setHeap(idx, heap[parent]);
+        idx = parent;
+    }
+    setHeap(idx, slot);
+}
 
-    for (int i = 0; i < events.size(); i++) {
-        for (auto& i : eventList) {
-            if (i.name == name) events.remove(i);
-        }
+void Scheduler::siftDown(u32 idx) {
+    const u32 slot = heap[idx];
+    while (true) {
+        const u32 left = idx * 2 + 1;
+        if (left >= n_events) break;
+        const u32 right = left + 1;
+        const u32 child = (right < n_events && before(heap[right], heap[left])) ? right : left;
+        if (!before(heap[child], slot)) break;
+        setHeap(idx, heap[child]);
+        idx = child;
     }
+    setHeap(idx, slot);
+}
+
+void Scheduler::removeAt(u32 idx) {
+    const u32 slot = heap[idx];
+    // Invalidate any handle to this event and give the slot back
+    events[slot].generation++;
+    if (!events[slot].generation) events[slot].generation++;
+    free_slots[n_free++] = slot;
+
+    // Move the last event in the hole and restore the heap
+    if (idx != --n_events) {
+        setHeap(idx, heap[n_events]);
+        if (idx && before(heap[idx], heap[(idx - 1) / 2]))
+            siftUp(idx);
+        else
+            siftDown(idx);
+    }
+    next_event_time = n_events ? events[heap[0]].time : UINT64_MAX;
+}
+
+bool Scheduler::popDue(u64 until, EventType& type, u64& payload) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!n_events || events[heap[0]].time > until) return false;
+
+    const Event& event = events[heap[0]];
+    type = event.type;
+    payload = event.payload;
+    removeAt(0);
+    return true;
 }
 
 u64 Scheduler::uSecondsToCycles(double us) {
@@ -2,8 +2,8 @@
 
 #include <common.hpp>
 
-#include <queue>
-#include <set>
+#include <array>
+#include <atomic>
 #include <functional>
 #include <mutex>
 
@@ -12,65 +12,64 @@
 
 static constexpr auto schedulerMaxEntries = 128;
 
-// https://stackoverflow.com/questions/19467485/how-to-remove-element-not-at-top-from-priority-queue
-template<typename T>
-class pqueue : public std::priority_queue<T, std::vector<T>, std::greater<T>> {
-public:
-    std::vector<T>& get_container() {
-        return this->c;
-    }
-
-    bool remove(const T& value) {
-        auto it = std::find(this->c.begin(), this->c.end(), value);
-
-        if (it == this->c.end()) {
-            return false;
-        }
-
-        if (it == this->c.begin()) {
-            // Deque the top element
-            this->pop();
-        }
-        else {
-            // Remove element and re-heap
-            this->c.erase(it);
-            std::make_heap(this->c.begin(), this->c.end(), this->comp);
-        }
-
-        return true;
-    }
-};
-
-static u64 next_event_id = 1;
-
+// Events live in a fixed pool and are ordered by an intrusive binary heap of pool indices.
+// An event is a type plus a 64-bit payload, the handler for each type is registered once with setHandler.
+// push returns a handle that can be used to cancel the event. Handles of events that already fired or were
+// cancelled are detected through the slot generation, so cancelling them is a no-op.
 class Scheduler {
 public:
+    Scheduler();
     u64 time = 0;
     void tick(u64 cycles);
     bool tickToNextEvent(u64& elapsed);
 
-    struct Event {
-        Event(std::function<void(void)> func, u64 time, u64 id, std::string name = "Unnamed") : func(func), time(time), id(id), name(name) {}
-        std::function<void(void)> func;
-        u64 time = 0;
-        std::string name = "Unnamed";
-        u64 id = 0;
-
-        bool operator>(const Event& other) const {
-            return time > other.time;
-        }
-
-        bool operator==(const Event& other) const {
-            return id == other.id;
-        }
+    enum class EventType : u8 {
+        ThreadReschedule,
+        ThreadWakeUp,           // Payload is the Thread*
+        ThreadTimeout,          // Payload is the Thread*
+        SPUThreadReschedule,
+        SPUThreadWakeUp,        // Payload is the SPUThread*
+        SPULocklineLost,        // Payload is the SPUThread*
+        SPUDMAStep,             // Payload is the SPUThread*
+        Breakpoint,
+        Count
     };
 
-    pqueue<Event> events;
-    void push(std::function<void(void)> func, u64 time, std::string name = "Unnamed event");
-    void deleteAllEventsOfName(std::string name);
+    using Handle = u64;     // Generation << 32 | slot. 0 is never a valid handle
+    using Handler = std::function<void(u64)>;
+
+    void setHandler(EventType type, Handler const& handler);
+    Handle push(EventType type, u64 time, u64 payload = 0);
+    void cancel(Handle handle);
 
     static u64 uSecondsToCycles(double us);
-    
+
 private:
-    std::recursive_mutex mutex;
+    struct Event {
+        u64 time;
+        u64 payload;
+        u64 order;          // Push order, events with the same time fire in the order they were pushed
+        u32 generation = 1;
+        u32 heap_idx;
+        EventType type;
+    };
+
+    std::array<Handler, (size_t)EventType::Count> handlers;
+    std::array<Event, schedulerMaxEntries> events;
+    std::array<u32, schedulerMaxEntries> heap;          // Indices into events
+    std::array<u32, schedulerMaxEntries> free_slots;
+    u32 n_events = 0;
+    u32 n_free = 0;
+    u64 next_order = 0;
+    std::atomic<u64> next_event_time = UINT64_MAX;      // Lets tick skip the lock when nothing is due
+    std::mutex mutex;
+
+    bool before(u32 a, u32 b) const {
+        return events[a].time < events[b].time || (events[a].time == events[b].time && events[a].order < events[b].order);
+    }
+    void setHeap(u32 idx, u32 slot) { heap[idx] = slot; events[slot].heap_idx = idx; }
+    void siftUp(u32 idx);
+    void siftDown(u32 idx);
+    void removeAt(u32 idx);
+    bool popDue(u64 until, EventType& type, u64& payload);
 };
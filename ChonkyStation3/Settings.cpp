@@ -44,6 +44,8 @@ void Settings::load() {
     if (   !cfg.contains("System")
         || !cfg.contains("LLEModules")
         || !cfg.contains("Filesystem")
+        || !cfg.contains("CPU")
+        || !cfg.contains("GPU")
         || !cfg.contains("Audio")
         || !cfg.contains("Debug")
        ) {
@@ -76,6 +78,14 @@ void Settings::load() {
         filesystem.dev_flash_mountpoint     = cfg["Filesystem"]["dev_flash_mountpoint"].as_string();
         filesystem.dev_usb000_mountpoint    = cfg["Filesystem"]["dev_usb000_mountpoint"].as_string();
         
+        cpu.ppu_backend = cfg["CPU"]["PPUBackend"].as_string();
+        cpu.spu_backend = cfg["CPU"]["SPUBackend"].as_string();
+        cpu.spu_host_threads = cfg["CPU"]["SPUHostThreads"].as_boolean();
+        
+        gpu.rsx_thread                  = cfg["GPU"]["RSXThread"].as_boolean();
+        gpu.shader_disk_cache           = cfg["GPU"]["ShaderDiskCache"].as_boolean();
+        gpu.skip_draws_while_compiling  = cfg["GPU"]["SkipDrawsWhileCompiling"].as_boolean();
+        
         audio.backend   = cfg["Audio"]["Backend"].as_string();
         
         debug.pause_on_start                    = cfg["Debug"]["PauseOnStart"].as_boolean();
@@ -83,6 +93,8 @@ void Settings::load() {
         debug.enable_spu_after_pc               = cfg["Debug"]["EnableSPUAfterPC"].as_string();
         debug.spu_thread_to_enable              = cfg["Debug"]["SPUThreadToEnable"].as_string();
         debug.dont_step_cellaudio_port_read_idx = cfg["Debug"]["DontStepCellAudioPortReadIdx"].as_boolean();
+        debug.ppu_jit_compare                   = cfg["Debug"]["PPUJITCompare"].as_boolean();
+        debug.spu_jit_compare                   = cfg["Debug"]["SPUJITCompare"].as_boolean();
     } catch (toml::type_error e) {
         broken_config();
     }
@@ -120,6 +132,14 @@ void Settings::save() {
     cfg["Filesystem"]["dev_flash_mountpoint"]   = filesystem.dev_flash_mountpoint;
     cfg["Filesystem"]["dev_usb000_mountpoint"]  = filesystem.dev_usb000_mountpoint;
     
+    cfg["CPU"]["PPUBackend"] = cpu.ppu_backend;
+    cfg["CPU"]["SPUBackend"] = cpu.spu_backend;
+    cfg["CPU"]["SPUHostThreads"] = cpu.spu_host_threads;
+    
+    cfg["GPU"]["RSXThread"]                 = gpu.rsx_thread;
+    cfg["GPU"]["ShaderDiskCache"]           = gpu.shader_disk_cache;
+    cfg["GPU"]["SkipDrawsWhileCompiling"]   = gpu.skip_draws_while_compiling;
+    
     cfg["Audio"]["Backend"] = audio.backend;
     
     cfg["Debug"]["PauseOnStart"]                    = debug.pause_on_start;
@@ -127,6 +147,8 @@ void Settings::save() {
     cfg["Debug"]["EnableSPUAfterPC"]                = debug.enable_spu_after_pc;
     cfg["Debug"]["SPUThreadToEnable"]               = debug.spu_thread_to_enable;
     cfg["Debug"]["DontStepCellAudioPortReadIdx"]    = debug.dont_step_cellaudio_port_read_idx;
+    cfg["Debug"]["PPUJITCompare"]                   = debug.ppu_jit_compare;
+    cfg["Debug"]["SPUJITCompare"]                   = debug.spu_jit_compare;
 
     file << toml::format(cfg);
     file.close();
@@ -67,6 +67,18 @@ public:
         std::string dev_usb000_mountpoint   = "./Filesystem/dev_usb000";
     } filesystem;
     
+    struct {
+        std::string ppu_backend = "CachedInterpreter";    // Interpreter, CachedInterpreter or JIT
+        std::string spu_backend = "Interpreter";          // Interpreter or JIT
+        bool spu_host_threads = false;                    // Run every SPU thread on its own host thread
+    } cpu;
+    
+    struct {
+        bool rsx_thread = false;                    // Run the RSX FIFO on its own host thread (experimental)
+        bool shader_disk_cache = true;              // Keep decompiled shaders and linked programs on disk across boots
+        bool skip_draws_while_compiling = false;    // Skip draws whose shaders are still being compiled instead of waiting for them
+    } gpu;
+    
     struct {
         std::string backend = "Null";
     } audio;
@@ -77,5 +89,7 @@ public:
         std::string enable_spu_after_pc = "";
         std::string spu_thread_to_enable = "";
         bool dont_step_cellaudio_port_read_idx = true;
+        bool ppu_jit_compare = false;
+        bool spu_jit_compare = false;
     } debug;
 };
@@ -116,6 +116,9 @@ static Logger lle_module            = Logger<true> ("[LLE    ][Module        ] "
 static Logger filesystem            = Logger<true> ("[Other  ][Filesystem    ] ");
 static Logger lv2_obj               = Logger<true> ("[Other  ][Lv2 Object    ] ");
 static Logger unimplemented         = Logger<true> ("[Other  ][Unimplemented ] ");
+static Logger ppu_cache             = Logger<false>("[Other  ][PPU Cache     ] ");
+static Logger ppu_jit               = Logger<false>("[Other  ][PPU JIT       ] ");
+static Logger spu_jit               = Logger<false>("[Other  ][SPU JIT       ] ");
 
 #undef true
 #undef false
@@ -0,0 +1,87 @@
+#include <Memory/Memory.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+// Runs 100k alloc/free cycles of random sizes on main memory while keeping a fixed number of allocations alive, then checks that
+// the blocks and the memory map are consistent and that everything coalesces back into one free area.
+// The time per cycle should stay about the same as the number of live allocations (the fragmentation) grows.
+
+static constexpr int CYCLES = 100000;
+
+static bool checkConsistency(Memory& mem) {
+    u64 prev = 0;
+    for (auto& [start, block] : mem.ram.blocks) {
+        if (start != block.start || start < prev) {
+            std::printf("Overlapping or misplaced block at 0x%llx\n", (unsigned long long)start);
+            return false;
+        }
+        prev = start + block.size;
+    }
+    prev = 0;
+    for (auto& [vaddr, entry] : mem.ram.map) {
+        if (vaddr != entry.vaddr || vaddr < prev) {
+            std::printf("Overlapping or misplaced map entry at 0x%llx\n", (unsigned long long)vaddr);
+            return false;
+        }
+        prev = vaddr + entry.size;
+    }
+    return true;
+}
+
+static bool run(size_t live_count, std::mt19937& rng) {
+    Memory mem;
+    const u64 available = mem.ram.getAvailableMem();
+    std::vector<u64> live;
+
+    auto alloc = [&]() {
+        const size_t size = (rng() % 4 + 1) * PAGE_SIZE - (rng() % PAGE_SIZE);
+        live.push_back(mem.alloc(size)->vaddr);
+    };
+    while (live.size() < live_count) alloc();
+
+    // Each cycle frees a random allocation and makes a new one of a different size
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < CYCLES; i++) {
+        const size_t idx = rng() % live.size();
+        auto [mapped, entry] = mem.isMapped(live[idx]);
+        if (!mapped) {
+            std::printf("0x%llx is not mapped anymore\n", (unsigned long long)live[idx]);
+            return false;
+        }
+        mem.free(entry);
+        live[idx] = live.back();
+        live.pop_back();
+        alloc();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("%5zu live allocations: %7.2f ms for %d cycles (%zu blocks, %zu map entries)\n", live_count, elapsed.count(), CYCLES, mem.ram.blocks.size(), mem.ram.map.size());
+
+    if (!checkConsistency(mem)) return false;
+
+    for (u64 vaddr : live)
+        mem.free(mem.isMapped(vaddr).second);
+    if (mem.ram.getAvailableMem() != available || !mem.ram.blocks.empty() || !mem.ram.map.empty()) {
+        std::printf("Memory leaked after freeing everything\n");
+        return false;
+    }
+    // Free areas have to be merged again, otherwise this doesn't fit
+    if (!mem.canAlloc(available)) {
+        std::printf("Could not allocate all of the memory after freeing everything\n");
+        return false;
+    }
+    mem.alloc(available);
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(0x4d454d);
+    for (size_t live_count : { 16, 128, 1024 }) {
+        if (!run(live_count, rng)) return 1;
+    }
+    std::printf("All allocations were consistent\n");
+    return 0;
+}
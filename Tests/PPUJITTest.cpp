@@ -0,0 +1,280 @@
+#include <PPU/Backends/PPUJIT.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+// Differential test of the PPU JIT against the cached interpreter.
+// Random straight-line programs made of the instructions the JIT emits natively (integer ops, compares, rlwinm, loads and stores)
+// are run on both backends from the same state, the registers, CR and memory have to match afterwards.
+// The data being loaded and stored spans a page boundary. Depending on the seed one page is in slowmem or has its writes tracked,
+// so that the fallback to the interpreter and stores crossing into the next page are covered too.
+// Pass a seed on the command line to replay a single failing program, or --benchmark to time a loop on both backends.
+
+#ifdef CHONKYSTATION3_PPU_JIT
+
+static constexpr u32 PROGRAM_SIZE = 200;
+static constexpr u32 DATA_SIZE = 4 * PAGE_SIZE;
+
+struct Machine {
+    Memory mem;
+    u32 code;
+    u32 data;
+    u32 boundary;   // Start of the third data page
+    int pages_written = 0;
+
+    Machine() {
+        code = mem.alloc(PAGE_SIZE)->vaddr;
+        data = mem.alloc(DATA_SIZE)->vaddr;
+        boundary = data + 2 * PAGE_SIZE;
+        mem.page_write_handler = [this](u64 page) { pages_written++; };   // Both machines allocate the same addresses
+    }
+};
+
+static u32 randomInstruction(std::mt19937& rng) {
+    Instruction instr = { .raw = 0 };
+    auto dst = [&]() { return 3 + rng() % 10; };   // r3-r12, r1 and r2 hold the data pointers
+    auto src = [&]() { return 1 + rng() % 12; };
+
+    switch (rng() % 14) {
+    case 0: {
+        static constexpr u32 opcs[] = { ADDI, ADDIS, ORI, ORIS, XORI, XORIS, ANDI, ANDIS };
+        instr.opc = opcs[rng() % 8];
+        if (instr.opc == ADDI || instr.opc == ADDIS) {
+            instr.rt = dst();
+            instr.ra = (rng() % 4 == 0) ? 0 : src();    // li/lis
+        } else {
+            instr.rs = src();
+            instr.ra = dst();
+        }
+        instr.si = rng();
+        break;
+    }
+    case 1: {
+        instr.opc = (rng() & 1) ? CMPI : CMPLI;
+        instr.ra = src();
+        instr.bf = rng() % 8;
+        instr.l = rng() & 1;
+        instr.si = (rng() & 1) ? rng() : rng() % 8;
+        break;
+    }
+    case 2: {
+        instr.opc = RLWINM;
+        instr.rs = src();
+        instr.ra = dst();
+        instr.sh = rng() % 32;
+        instr.mb_5 = rng() % 32;
+        instr.me_5 = rng() % 32;
+        instr.rc = rng() & 1;
+        break;
+    }
+    case 3:
+    case 4:
+    case 5: {
+        static constexpr u32 ops[] = { OR, AND, XOR, ADD, SUBF, NEG, EXTSW, EXTSH, EXTSB };
+        instr.opc = G_1F;
+        instr.g_1f_field = ops[rng() % 9];
+        if (instr.g_1f_field == ADD || instr.g_1f_field == SUBF || instr.g_1f_field == NEG) {
+            instr.rt = dst();
+            instr.ra = src();
+        } else {
+            instr.rs = src();
+            instr.ra = dst();
+        }
+        instr.rb = src();
+        instr.rc = rng() & 1;
+        break;
+    }
+    case 6: {
+        instr.opc = G_1F;
+        instr.g_1f_field = (rng() & 1) ? CMP : CMPL;
+        instr.ra = src();
+        instr.rb = src();
+        instr.bf = rng() % 8;
+        instr.l = rng() & 1;
+        break;
+    }
+    default: {
+        // Loads and stores, r1 for the normal forms and r2 for the update forms
+        static constexpr u32 opcs[] = { LBZ, LBZU, LHZ, LHZU, LWZ, LWZU, STB, STBU, STH, STHU, STW, STWU, G_3A, G_3E };
+        instr.opc = opcs[rng() % 14];
+        const bool is_ds = instr.opc == G_3A || instr.opc == G_3E;
+        const bool update = is_ds ? (rng() & 1) : (instr.opc & 1);
+        instr.rt = dst();
+        instr.ra = update ? 2 : 1;
+
+        // Offsets stay inside the two pages around the boundary, some of them close to it.
+        // Update forms move r2 around, their offsets are small so that it stays close to the boundary
+        s32 offs;
+        if (update) offs = (s32)(rng() % 256) - 128;
+        else if (rng() % 4 == 0) offs = (s32)(rng() % 16) - 8;
+        else offs = (s32)(rng() % 0x8000) - 0x4000;
+
+        if (is_ds) {
+            instr.ds = offs >> 2;
+            instr.g_3a_field = update;  // ld/ldu, std/stdu
+        }
+        else instr.d = offs;
+        break;
+    }
+    }
+    return instr.raw;
+}
+
+static void loadProgram(Machine& m, const std::vector<u32>& program) {
+    for (u32 i = 0; i < program.size(); i++)
+        m.mem.write<u32>(m.code + i * 4, program[i]);
+}
+
+static void randomizeState(PPUTypes::State& state, std::mt19937& rng) {
+    static constexpr u64 edges[] = { 0, 1, 0x7fffffff, 0x80000000, 0xffffffff, 0x8000000000000000, 0xffffffffffffffff };
+    for (auto& gpr : state.gprs) {
+        if (rng() % 4 == 0) gpr = edges[rng() % 7];
+        else gpr = ((u64)rng() << 32) | rng();
+    }
+    state.cr.raw = rng();
+}
+
+static bool compare(Machine& interpreter_machine, PPU& interpreter, Machine& jit_machine, PPU& jit, u32 seed) {
+    bool ok = true;
+    for (int i = 0; i < 32; i++) {
+        if (interpreter.state.gprs[i] != jit.state.gprs[i]) {
+            std::printf("seed %u: r%d mismatch (jit: 0x%016llx, interpreter: 0x%016llx)\n", seed, i, (unsigned long long)jit.state.gprs[i], (unsigned long long)interpreter.state.gprs[i]);
+            ok = false;
+        }
+    }
+    if (interpreter.state.cr.raw != jit.state.cr.raw) {
+        std::printf("seed %u: cr mismatch (jit: 0x%08x, interpreter: 0x%08x)\n", seed, jit.state.cr.raw, interpreter.state.cr.raw);
+        ok = false;
+    }
+    if (interpreter.state.pc != jit.state.pc) {
+        std::printf("seed %u: pc mismatch (jit: 0x%08llx, interpreter: 0x%08llx)\n", seed, (unsigned long long)jit.state.pc, (unsigned long long)interpreter.state.pc);
+        ok = false;
+    }
+    if (std::memcmp(interpreter_machine.mem.getPtr(interpreter_machine.data), jit_machine.mem.getPtr(jit_machine.data), DATA_SIZE)) {
+        std::printf("seed %u: memory mismatch\n", seed);
+        ok = false;
+    }
+    if (interpreter_machine.pages_written != jit_machine.pages_written) {
+        std::printf("seed %u: tracked page written %d times (interpreter: %d)\n", seed, jit_machine.pages_written, interpreter_machine.pages_written);
+        ok = false;
+    }
+    return ok;
+}
+
+static bool runProgram(u32 seed) {
+    std::mt19937 rng(seed);
+    std::vector<u32> program;
+    for (u32 i = 0; i < PROGRAM_SIZE - 1; i++)
+        program.push_back(randomInstruction(rng));
+    program.push_back(0x48000000);  // b 0
+
+    Machine interpreter_machine;
+    Machine jit_machine;
+    PPUCachedInterpreter interpreter(interpreter_machine.mem, nullptr);
+    PPUJIT jit(jit_machine.mem, nullptr);
+
+    randomizeState(interpreter.state, rng);
+    std::vector<u8> data(DATA_SIZE);
+    for (auto& b : data) b = rng();
+    const int mode = seed % 3;  // 0: fastmem, 1: the page below the boundary is in slowmem, 2: writes to the page above are tracked
+
+    for (Machine* m : { &interpreter_machine, &jit_machine }) {
+        loadProgram(*m, program);
+        std::memcpy(m->mem.getPtr(m->data), data.data(), DATA_SIZE);
+        if (mode == 1) m->mem.markAsSlowMem((m->boundary >> PAGE_SHIFT) - 1, true, true);
+        if (mode == 2) m->mem.trackWrites(m->boundary, PAGE_SIZE);
+    }
+    interpreter.state.gprs[1] = interpreter_machine.boundary;
+    interpreter.state.gprs[2] = interpreter_machine.boundary + 3;   // Misaligned, so that update forms cross the boundary
+    interpreter.state.pc = interpreter_machine.code;
+    jit.state = interpreter.state;
+
+    // Both backends run until they are spinning on the final branch
+    try {
+        interpreter.step();
+        jit.step();
+    }
+    catch (std::runtime_error& e) {
+        std::printf("seed %u: %s\n", seed, e.what());
+        return false;
+    }
+    return compare(interpreter_machine, interpreter, jit_machine, jit, seed);
+}
+
+// Checksum loop over 64 KB: lwz, stw, add, xor, rlwinm, cmplw and bdnz
+static void benchmark() {
+    constexpr u32 ITERATIONS = 4000000;
+    static constexpr u32 loop[] = {
+        0x80a30000,     // lwz r5, 0(r3)
+        0x54a6402e,     // rlwinm r6, r5, 8, 0, 23
+        0x7ce73278,     // xor r7, r7, r6
+        0x7d082a14,     // add r8, r8, r5
+        0x90e30000,     // stw r7, 0(r3)
+        0x38840004,     // addi r4, r4, 4
+        0x5484043a,     // rlwinm r4, r4, 0, 16, 29
+        0x7c6a2214,     // add r3, r10, r4
+        0x7c874040,     // cmplw cr1, r7, r8
+        0x4200ffdc,     // bdnz loop
+        0x48000000,     // b 0
+    };
+
+    auto run = [&](const char* name, auto& cpu, Machine& m) {
+        for (u32 i = 0; i < std::size(loop); i++)
+            m.mem.write<u32>(m.code + i * 4, loop[i]);
+        for (u32 i = 0; i < PAGE_SIZE; i += 4)
+            m.mem.write<u32>(m.data + i, i * 0x9e3779b9);
+        cpu.state.gprs[3] = m.data;
+        cpu.state.gprs[10] = m.data;
+        cpu.state.ctr = ITERATIONS;
+        cpu.state.pc = m.code;
+
+        const u32 end = m.code + (std::size(loop) - 1) * 4;
+        const auto start = std::chrono::steady_clock::now();
+        while (cpu.state.pc != end) cpu.step();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-18s %8.2f ms (%.2f ns per iteration), checksum 0x%016llx\n", name, elapsed.count(), elapsed.count() * 1e6 / ITERATIONS, (unsigned long long)(cpu.state.gprs[7] ^ cpu.state.gprs[8]));
+    };
+
+    Machine interpreter_machine;
+    Machine jit_machine;
+    PPUCachedInterpreter interpreter(interpreter_machine.mem, nullptr);
+    PPUJIT jit(jit_machine.mem, nullptr);
+    run("Cached interpreter", interpreter, interpreter_machine);
+    run("JIT", jit, jit_machine);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--benchmark")) {
+        benchmark();
+        return 0;
+    }
+    if (argc > 1) {
+        const u32 seed = std::strtoul(argv[1], nullptr, 0);
+        return runProgram(seed) ? 0 : 1;
+    }
+
+    constexpr u32 PROGRAMS = 300;
+    for (u32 seed = 1; seed <= PROGRAMS; seed++) {
+        if (!runProgram(seed)) {
+            std::printf("Failed, replay with: PPUJITTest %u\n", seed);
+            return 1;
+        }
+    }
+    std::printf("%u programs matched\n", PROGRAMS);
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("The PPU JIT is not available on this architecture, skipping\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,135 @@
+#include <Loaders/ELF/SELFToELF.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+// Checks the ELF cache of SELFToELF with a debug SELF written by the test (debug SELFs carry the plain ELF, so no keys are needed).
+// The SELF has an NPDRM header, so its license is part of the cache key like for retail SELFs.
+// A second decryption has to be a cache hit, changing the SELF or its license has to replace the cached ELF,
+// and a cache directory that can't be created has to fall back to decrypting outside of the cache.
+
+static int failed = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failed++;
+    }
+}
+
+static constexpr char CONTENT_ID[] = "UP0000-TEST00000_00-0000000000000000";
+static constexpr u64 SUP_HEADER_OFFSET  = 0x80;
+static constexpr u64 PROG_ID_OFFSET     = 0x100;
+static constexpr u64 ELF_OFFSET         = 0x200;
+
+static void writeFile(const fs::path& path, const std::string& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+}
+
+static std::string readFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void writeDebugSELF(const fs::path& path, const std::string& elf) {
+    std::vector<u8> self(ELF_OFFSET + elf.size(), 0);
+
+    SELFToELF::CFHeader header;
+    header.magic = 0x53434500;  // SCE\0
+    header.ver = 2;
+    header.attr = 0x8000;       // Debug
+    header.category = 1;
+    header.ext_header_size = sizeof(SELFToELF::ExtendedHeader);
+    header.file_offset = ELF_OFFSET;
+    header.file_size = elf.size();
+    std::memcpy(&self[0], &header, sizeof(header));
+
+    SELFToELF::ExtendedHeader ext_header;
+    ext_header.program_identification_header_offset = PROG_ID_OFFSET;
+    ext_header.supplemental_hdr_offset = SUP_HEADER_OFFSET;
+    std::memcpy(&self[sizeof(header)], &ext_header, sizeof(ext_header));
+
+    SELFToELF::SupplementalHeader sup_header = {};
+    sup_header.type = 3;    // NPDRM
+    sup_header.size = sizeof(sup_header);
+    std::memcpy(sup_header.npd.content_id, CONTENT_ID, sizeof(CONTENT_ID) - 1);
+    std::memcpy(&self[SUP_HEADER_OFFSET], &sup_header, sizeof(sup_header));
+
+    std::memcpy(&self[ELF_OFFSET], elf.data(), elf.size());
+    writeFile(path, std::string(self.begin(), self.end()));
+}
+
+static size_t countEntries(const fs::path& dir) {
+    return std::distance(fs::directory_iterator(dir), fs::directory_iterator());
+}
+
+int main() {
+    const fs::path root = fs::temp_directory_path() / "ChonkyStation3SELFCacheTest";
+    fs::remove_all(root);
+    const fs::path hdd0 = root / "dev_hdd0";
+    const fs::path cache_dir = root / "Cache" / "ELF";
+    const fs::path rap_path = hdd0 / "home" / "00000001" / "exdata" / (std::string(CONTENT_ID) + ".rap");
+    fs::create_directories(rap_path.parent_path());
+
+    Filesystem filesystem(nullptr);
+    filesystem.mount(Filesystem::Device::DEV_HDD0, hdd0);
+    SELFToELF self(filesystem, "/dev_hdd0/home/00000001", cache_dir);
+
+    const fs::path self_path = root / "EBOOT.BIN";
+    writeDebugSELF(self_path, "first ELF");
+
+    // Miss, the ELF is decrypted into the cache
+    fs::path first;
+    check(self.makeCachedELF(self_path, first) == 0, "first decryption failed");
+    check(first.parent_path() == cache_dir, "the ELF wasn't decrypted into the cache");
+    check(readFile(first) == "first ELF", "wrong contents after the first decryption");
+
+    // Hit, the cached file is used as is
+    writeFile(first, "cached ELF");
+    fs::path second;
+    check(self.makeCachedELF(self_path, second) == 0, "second decryption failed");
+    check(second == first, "the second decryption didn't use the cached ELF");
+    check(readFile(second) == "cached ELF", "the cached ELF was decrypted again");
+
+    // The SELF changed, the stale entry is replaced
+    writeDebugSELF(self_path, "second ELF");
+    fs::path changed_self;
+    check(self.makeCachedELF(self_path, changed_self) == 0, "decryption after changing the SELF failed");
+    check(changed_self != first, "changing the SELF didn't change the cache entry");
+    check(readFile(changed_self) == "second ELF", "wrong contents after changing the SELF");
+    check(!fs::exists(first) && countEntries(cache_dir) == 1, "the stale entry wasn't removed after changing the SELF");
+
+    // The license showed up or changed, same thing
+    writeFile(rap_path, std::string(16, '\x11'));
+    fs::path added_rap;
+    check(self.makeCachedELF(self_path, added_rap) == 0, "decryption after adding the license failed");
+    check(added_rap != changed_self, "adding the license didn't change the cache entry");
+    writeFile(rap_path, std::string(16, '\x22'));
+    fs::path changed_rap;
+    check(self.makeCachedELF(self_path, changed_rap) == 0, "decryption after changing the license failed");
+    check(changed_rap != added_rap, "changing the license didn't change the cache entry");
+    check(readFile(changed_rap) == "second ELF", "wrong contents after changing the license");
+    check(countEntries(cache_dir) == 1, "the stale entries weren't removed after changing the license");
+
+    // The cache directory can't be created (a file is in the way), the ELF is decrypted somewhere else
+    writeFile(root / "NotADirectory", "");
+    SELFToELF uncached(filesystem, "/dev_hdd0/home/00000001", root / "NotADirectory" / "ELF");
+    fs::path fallback;
+    check(uncached.makeCachedELF(self_path, fallback) == 0, "decryption without a cache failed");
+    check(readFile(fallback) == "second ELF", "wrong contents when decrypting without a cache");
+    fs::remove(fallback);
+
+    fs::remove_all(root);
+    if (failed) {
+        std::printf("%d checks failed\n", failed);
+        return 1;
+    }
+    std::printf("The ELF cache behaved as expected\n");
+    return 0;
+}
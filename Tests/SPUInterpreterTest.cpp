@@ -0,0 +1,144 @@
+#include <SPU/Backends/SPUInterpreter.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+// Checks the SIMD implementations of the SPU vector instructions against the scalar code they replaced.
+// The reference functions below are the interpreter's scalar fallbacks, one lane at a time.
+
+using namespace SPUTypes;
+
+using Handler = void (SPUInterpreter::*)(const SPUInstruction&);
+using Reference = void (*)(GPR& d, const GPR& a, const GPR& b, const GPR& c);
+
+struct TestCase {
+    const char* name;
+    Handler handler;
+    Reference reference;
+    bool rrr;       // RRR form (rt, ra, rb, rc), otherwise RR form (rt0, ra, rb)
+    bool fp;        // Float result, NaN lanes only have to be NaN in both
+};
+
+static constexpr u32 RA = 1, RB = 2, RC = 3, RT = 4;
+
+static const TestCase tests[] = {
+    { "a",      &SPUInterpreter::a,     [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = a.w[i] + b.w[i]; } },
+    { "sf",     &SPUInterpreter::sf,    [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = b.w[i] - a.w[i]; } },
+    { "ah",     &SPUInterpreter::ah,    [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 8; i++)  d.h[i] = a.h[i] + b.h[i]; } },
+    { "sfh",    &SPUInterpreter::sfh,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 8; i++)  d.h[i] = b.h[i] - a.h[i]; } },
+    { "and",    &SPUInterpreter::and_,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] & b.dw[i]; } },
+    { "or",     &SPUInterpreter::or_,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] | b.dw[i]; } },
+    { "xor",    &SPUInterpreter::xor_,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] ^ b.dw[i]; } },
+    { "nand",   &SPUInterpreter::nand,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = ~(a.dw[i] & b.dw[i]); } },
+    { "nor",    &SPUInterpreter::nor,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = ~(a.dw[i] | b.dw[i]); } },
+    { "eqv",    &SPUInterpreter::eqv,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] ^ ~b.dw[i]; } },
+    { "andc",   &SPUInterpreter::andc,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] & ~b.dw[i]; } },
+    { "orc",    &SPUInterpreter::orc,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = a.dw[i] | ~b.dw[i]; } },
+    { "ceq",    &SPUInterpreter::ceq,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (a.w[i] == b.w[i]) ? 0xffffffff : 0; } },
+    { "ceqh",   &SPUInterpreter::ceqh,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 8; i++)  d.h[i] = (a.h[i] == b.h[i]) ? 0xffff : 0; } },
+    { "ceqb",   &SPUInterpreter::ceqb,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 16; i++) d.b[i] = (a.b[i] == b.b[i]) ? 0xff : 0; } },
+    { "cgt",    &SPUInterpreter::cgt,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = ((s32)a.w[i] > (s32)b.w[i]) ? 0xffffffff : 0; } },
+    { "clgt",   &SPUInterpreter::clgt,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (a.w[i] > b.w[i]) ? 0xffffffff : 0; } },
+    { "clgth",  &SPUInterpreter::clgth, [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 8; i++)  d.h[i] = (a.h[i] > b.h[i]) ? 0xffff : 0; } },
+    { "clgtb",  &SPUInterpreter::clgtb, [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 16; i++) d.b[i] = (a.b[i] > b.b[i]) ? 0xff : 0; } },
+    { "mpy",    &SPUInterpreter::mpy,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (s32)(s16)(a.w[i] & 0xffff) * (s32)(s16)(b.w[i] & 0xffff); } },
+    { "fa",     &SPUInterpreter::fa,    [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = a.f[i] + b.f[i]; }, false, true },
+    { "fs",     &SPUInterpreter::fs,    [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = a.f[i] - b.f[i]; }, false, true },
+    { "fm",     &SPUInterpreter::fm,    [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = a.f[i] * b.f[i]; }, false, true },
+    { "fceq",   &SPUInterpreter::fceq,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (a.f[i] == b.f[i]) ? 0xffffffff : 0; } },
+    { "fcgt",   &SPUInterpreter::fcgt,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (a.f[i] > b.f[i]) ? 0xffffffff : 0; } },
+    { "fcmgt",  &SPUInterpreter::fcmgt, [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.w[i] = (std::abs(a.f[i]) > std::abs(b.f[i])) ? 0xffffffff : 0; } },
+    { "selb",   &SPUInterpreter::selb,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 2; i++)  d.dw[i] = (a.dw[i] & ~c.dw[i]) | (b.dw[i] & c.dw[i]); }, true },
+    { "fma",    &SPUInterpreter::fma,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = a.f[i] * b.f[i] + c.f[i]; }, true, true },
+    { "fms",    &SPUInterpreter::fms,   [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = a.f[i] * b.f[i] - c.f[i]; }, true, true },
+    { "fnms",   &SPUInterpreter::fnms,  [](GPR& d, const GPR& a, const GPR& b, const GPR& c) { for (int i = 0; i < 4; i++)  d.f[i] = c.f[i] - a.f[i] * b.f[i]; }, true, true },
+    { "shufb",  &SPUInterpreter::shufb, [](GPR& d, const GPR& a, const GPR& b, const GPR& c) {
+        u8 src[32];
+        for (int i = 0; i < 16; i++) src[i +  0] = b.b[i];
+        for (int i = 0; i < 16; i++) src[i + 16] = a.b[i];
+        for (int i = 0; i < 16; i++) {
+            const u8 ctrl = c.b[i];
+            if ((ctrl >> 6) == 0b10)       d.b[i] = 0;
+            else if ((ctrl >> 5) == 0b110) d.b[i] = 0xff;
+            else if ((ctrl >> 5) == 0b111) d.b[i] = 0x80;
+            else d.b[i] = src[31 - (ctrl & 0x1f)];
+        }
+    }, true },
+};
+
+static void randomize(GPR& reg, std::mt19937_64& rng, int mode) {
+    switch (mode) {
+    case 0:     // Raw bits (includes NaNs, infinities and denormals)
+        reg.dw[0] = rng();
+        reg.dw[1] = rng();
+        break;
+    case 1:     // Ordinary floats
+        for (int i = 0; i < 4; i++) reg.f[i] = (float)((s64)(rng() % 2000000) - 1000000) / 1000.0f;
+        break;
+    case 2:     // Small values, so that lanes often compare equal
+        for (int i = 0; i < 16; i++) reg.b[i] = rng() & 3;
+        break;
+    }
+}
+
+static bool matches(const GPR& expected, const GPR& result, bool fp) {
+    if (!fp) return std::memcmp(&expected, &result, sizeof(GPR)) == 0;
+    for (int i = 0; i < 4; i++) {
+        if (std::isnan(expected.f[i]) && std::isnan(result.f[i])) continue;
+        if (expected.w[i] != result.w[i]) return false;
+    }
+    return true;
+}
+
+int main() {
+    SPUInterpreter spu(nullptr);
+    std::mt19937_64 rng(0x5350550a);
+    constexpr int ITERATIONS = 100000;
+    int failed = 0;
+
+    for (auto& test : tests) {
+        SPUInstruction instr;
+        instr.raw = 0;
+        instr.ra = RA;
+        instr.rb = RB;
+        if (test.rrr) {
+            instr.rt = RT;
+            instr.rc = RC;
+        }
+        else instr.rt0 = RT;
+
+        for (int i = 0; i < ITERATIONS; i++) {
+            const int mode = i % 3;
+            randomize(spu.state.gprs[RA], rng, mode);
+            randomize(spu.state.gprs[RB], rng, mode);
+            randomize(spu.state.gprs[RC], rng, 0);
+            if (i % 7 == 0) spu.state.gprs[RB] = spu.state.gprs[RA];
+
+            const GPR a = spu.state.gprs[RA];
+            const GPR b = spu.state.gprs[RB];
+            const GPR c = spu.state.gprs[RC];
+            GPR expected = {};
+            test.reference(expected, a, b, test.rrr ? c : GPR{});
+            (spu.*test.handler)(instr);
+
+            if (!matches(expected, spu.state.gprs[RT], test.fp)) {
+                const GPR& res = spu.state.gprs[RT];
+                std::printf("%s: mismatch\n", test.name);
+                std::printf("  ra       %016llx%016llx\n", (unsigned long long)a.dw[1], (unsigned long long)a.dw[0]);
+                std::printf("  rb       %016llx%016llx\n", (unsigned long long)b.dw[1], (unsigned long long)b.dw[0]);
+                std::printf("  rc       %016llx%016llx\n", (unsigned long long)c.dw[1], (unsigned long long)c.dw[0]);
+                std::printf("  expected %016llx%016llx\n", (unsigned long long)expected.dw[1], (unsigned long long)expected.dw[0]);
+                std::printf("  got      %016llx%016llx\n", (unsigned long long)res.dw[1], (unsigned long long)res.dw[0]);
+                failed++;
+                break;
+            }
+        }
+    }
+
+    std::printf("%d/%d instructions passed\n", (int)std::size(tests) - failed, (int)std::size(tests));
+    return failed ? 1 : 0;
+}
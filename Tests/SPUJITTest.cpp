@@ -0,0 +1,231 @@
+#include <SPU/Backends/SPUJIT.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+
+// Differential test of the SPU JIT against the interpreter.
+// Random straight-line programs with forward conditional branches are run on both backends from the same state,
+// the registers and pc have to match afterwards.
+// The native float ops can pick a different NaN than the compiled interpreter when both operands are NaNs (the compiler is
+// free to swap the operands of mulps/addps). The SPU has no NaNs, so neither is "right": integer programs don't use fa/fs/fm,
+// and float programs only do float arithmetic on finite values, where the only NaN that can come up is the default one. Programs are then partially rewritten in place, like an overlay
+// being DMA'd in, and run again on the same JIT instance to check that stale blocks are never executed.
+// Writes to the JIT's LS are tracked like those of an SPU thread, so blocks are only hashed again after their pages were written.
+// Pass a seed on the command line to replay a single failing program.
+
+#ifdef CHONKYSTATION3_SPU_JIT
+
+using namespace SPUTypes;
+using Handler = void (SPUInterpreter::*)(const SPUInstruction&);
+
+static constexpr u32 PROGRAM_SIZE = 300;    // More than SPUJIT::MAX_BLOCK_SIZE, so that long blocks get split
+static constexpr u32 DATA_START = 64_KB;    // Data read by the load instructions, programs never get here
+static constexpr int OVERLAYS = 4;
+
+// Instructions that touch PPU-side state, branch backwards, halt or store to LS can't be generated
+static bool isExcluded(Handler handler) {
+    static const Handler excluded[] = {
+        &SPUInterpreter::unimpl, &SPUInterpreter::stop, &SPUInterpreter::stopd, &SPUInterpreter::rdch, &SPUInterpreter::rchcnt, &SPUInterpreter::wrch,
+        &SPUInterpreter::mfspr, &SPUInterpreter::mtspr, &SPUInterpreter::stqx, &SPUInterpreter::stqa, &SPUInterpreter::stqd, &SPUInterpreter::stqr,
+        &SPUInterpreter::br, &SPUInterpreter::bra, &SPUInterpreter::brsl, &SPUInterpreter::brasl, &SPUInterpreter::brz, &SPUInterpreter::brnz,
+        &SPUInterpreter::brhz, &SPUInterpreter::brhnz, &SPUInterpreter::bi, &SPUInterpreter::bisl, &SPUInterpreter::biz, &SPUInterpreter::binz,
+        &SPUInterpreter::bihz, &SPUInterpreter::bihnz, &SPUInterpreter::iret, &SPUInterpreter::bisled, &SPUInterpreter::heq, &SPUInterpreter::heqi,
+        &SPUInterpreter::hgt, &SPUInterpreter::hgti, &SPUInterpreter::hlgt, &SPUInterpreter::hlgti,
+    };
+    for (auto h : excluded)
+        if (h == handler) return true;
+    return false;
+}
+
+class ProgramGenerator {
+public:
+    ProgramGenerator(SPUInterpreter& scratch) : scratch(scratch) {}
+
+    // Generates instructions [start, PROGRAM_SIZE) of a program. The last instruction is a branch to itself
+    void generate(std::vector<u32>& program, u32 start, std::mt19937& rng, bool floats) {
+        program.resize(PROGRAM_SIZE);
+        for (u32 i = start; i < PROGRAM_SIZE - 1; i++) {
+            if (floats) {
+                program[i] = randomFloatInstruction(rng);
+                continue;
+            }
+            // Forward conditional branches (brz, brnz, brhz, brhnz) that stay inside the program
+            if (rng() % 16 == 0) {
+                static constexpr u32 branches[] = { 0x40, 0x42, 0x44, 0x46 };
+                const u32 offs = std::min<u32>(1 + rng() % 4, PROGRAM_SIZE - 1 - i);
+                program[i] = (branches[rng() % 4] << 23) | (offs << 7) | (rng() % 16);
+                continue;
+            }
+            program[i] = randomInstruction(rng);
+        }
+        program[PROGRAM_SIZE - 1] = 0x64 << 23;     // br 0
+    }
+
+private:
+    SPUInterpreter& scratch;
+    std::unordered_map<u32, bool> usable;   // By opcode
+
+    u32 randomInstruction(std::mt19937& rng) {
+        while (true) {
+            u32 raw = rng();
+            // Use the first 16 registers so that instructions depend on each other
+            raw = (raw & ~0x7fu) | (raw & 0xf);                                 // rt (RR) / rc (RRR)
+            raw = (raw & ~(0x7fu << 7)) | (raw & (0xfu << 7));                  // ra
+            if (isRRR(raw)) raw = (raw & ~(0x7fu << 21)) | (raw & (0xfu << 21));    // rt (RRR)
+            if (isUsable(raw) && !isFloatArithmetic(raw)) return raw;
+        }
+    }
+
+    // fa, fs, fm (RR) or fma, fms, fnms (RRR) on r0-r15
+    u32 randomFloatInstruction(std::mt19937& rng) {
+        static constexpr u32 rr[] = { 0x2c4, 0x2c5, 0x2c6 };
+        static constexpr u32 rrr[] = { 0xe, 0xf, 0xd };
+        const u32 regs = (rng() % 16) | ((rng() % 16) << 7) | ((rng() % 16) << 14);
+        if (rng() & 1) return (rr[rng() % 3] << 21) | regs;
+        return (rrr[rng() % 3] << 28) | ((rng() % 16) << 21) | regs;
+    }
+
+    bool isFloatArithmetic(u32 raw) {
+        const Handler handler = scratch.instr_table[(raw >> (32 - INSTR_BITS)) & INSTR_MASK];
+        return handler == &SPUInterpreter::fa || handler == &SPUInterpreter::fs || handler == &SPUInterpreter::fm;
+    }
+
+    bool isRRR(u32 raw) {
+        const Handler handler = scratch.instr_table[(raw >> (32 - INSTR_BITS)) & INSTR_MASK];
+        return     handler == &SPUInterpreter::selb || handler == &SPUInterpreter::shufb || handler == &SPUInterpreter::mpya
+                || handler == &SPUInterpreter::fnms || handler == &SPUInterpreter::fma   || handler == &SPUInterpreter::fms;
+    }
+
+    // Unimplemented instructions panic, find out by running them once
+    bool isUsable(u32 raw) {
+        const u32 opc = (raw >> (32 - INSTR_BITS)) & INSTR_MASK;
+        const Handler handler = scratch.instr_table[opc];
+        if (isExcluded(handler)) return false;
+
+        auto it = usable.find(opc);
+        if (it != usable.end()) return it->second;
+        bool ok = true;
+        try {
+            SPUInstruction instr = { .raw = raw };
+            (scratch.*handler)(instr);
+        }
+        catch (std::runtime_error&) {
+            ok = false;
+        }
+        usable[opc] = ok;
+        return ok;
+    }
+};
+
+static void loadProgram(SPU& spu, const std::vector<u32>& program) {
+    for (u32 i = 0; i < program.size(); i++)
+        spu.write<u32>(i * 4, program[i]);
+}
+
+static void randomizeState(State& state, u8* ls, std::mt19937& rng, bool floats) {
+    for (auto& gpr : state.gprs) {
+        for (int i = 0; i < 4; i++) {
+            if (floats) gpr.f[i] = (float)((s32)(rng() % 2000000) - 1000000) / 1000.0f;
+            else gpr.w[i] = rng();
+        }
+    }
+    // Some registers hold small values, so that shifts, rotates and branches see interesting counts
+    for (int i = 0; i < 4 && !floats; i++)
+        for (auto& w : state.gprs[rng() % 16].w) w = rng() % 64;
+    for (u32 i = DATA_START; i < 256_KB; i++) ls[i] = rng();
+    state.pc = 0;
+}
+
+static bool compareStates(const SPU& interpreter, const SPU& jit, u32 seed, int overlay) {
+    bool ok = true;
+    for (int i = 0; i < 128; i++) {
+        const auto& expected = interpreter.state.gprs[i];
+        const auto& got = jit.state.gprs[i];
+        if (std::memcmp(&expected, &got, sizeof(GPR))) {
+            std::printf("seed %u, overlay %d: r%d mismatch (jit: { 0x%08x, 0x%08x, 0x%08x, 0x%08x }, interpreter: { 0x%08x, 0x%08x, 0x%08x, 0x%08x })\n", seed, overlay, i,
+                got.w[3], got.w[2], got.w[1], got.w[0], expected.w[3], expected.w[2], expected.w[1], expected.w[0]);
+            ok = false;
+        }
+    }
+    if (interpreter.state.pc != jit.state.pc) {
+        std::printf("seed %u, overlay %d: pc mismatch (jit: 0x%05x, interpreter: 0x%05x)\n", seed, overlay, jit.state.pc, interpreter.state.pc);
+        ok = false;
+    }
+    return ok;
+}
+
+static bool runProgram(u32 seed, SPUInterpreter& interpreter, SPUJIT& jit, ProgramGenerator& generator) {
+    std::mt19937 rng(seed);
+    const bool floats = seed % 4 == 0;
+    std::vector<u32> program;
+    generator.generate(program, 0, rng, floats);
+
+    for (int overlay = 0; overlay < OVERLAYS; overlay++) {
+        // Rewrite the tail of the program, the JIT still has blocks for the old contents at the same addresses
+        if (overlay) generator.generate(program, rng() % PROGRAM_SIZE, rng, floats);
+
+        randomizeState(interpreter.state, interpreter.ls, rng, floats);
+        jit.state = interpreter.state;
+        std::memcpy(&jit.ls[DATA_START], &interpreter.ls[DATA_START], 256_KB - DATA_START);
+        markLSWritten(jit.ls_dirty, DATA_START, 256_KB - DATA_START);
+        loadProgram(interpreter, program);
+        loadProgram(jit, program);
+
+        // Both backends run until they are spinning on the final branch
+        interpreter.step();
+        jit.step();
+        if (!compareStates(interpreter, jit, seed, overlay)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    auto interpreter_ls = std::make_unique<u8[]>(256_KB);
+    auto jit_ls = std::make_unique<u8[]>(256_KB);
+    auto scratch_ls = std::make_unique<u8[]>(256_KB);
+
+    SPUInterpreter interpreter(nullptr);
+    SPUJIT jit(nullptr);
+    SPUInterpreter scratch(nullptr);
+    for (SPU* spu : { (SPU*)&interpreter, (SPU*)&jit }) {
+        spu->enabled = true;
+        spu->on_host_thread = true;     // Keeps step() from asking the PPU thread manager for a time slice
+    }
+    interpreter.ls = interpreter_ls.get();
+    jit.ls = jit_ls.get();
+    std::atomic<u64> jit_ls_dirty = ~0ULL;
+    jit.ls_dirty = &jit_ls_dirty;
+    scratch.ls = scratch_ls.get();
+    ProgramGenerator generator(scratch);
+
+    if (argc > 1) {
+        const u32 seed = std::strtoul(argv[1], nullptr, 0);
+        return runProgram(seed, interpreter, jit, generator) ? 0 : 1;
+    }
+
+    constexpr u32 PROGRAMS = 500;
+    for (u32 seed = 1; seed <= PROGRAMS; seed++) {
+        if (!runProgram(seed, interpreter, jit, generator)) {
+            std::printf("Failed, replay with: SPUJITTest %u\n", seed);
+            return 1;
+        }
+    }
+    std::printf("%u programs matched (%zu block addresses compiled)\n", PROGRAMS, jit.blocks.size());
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("The SPU JIT is not available on this architecture, skipping\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include <RSX/FragmentShaderDecompiler.hpp>
+#include <RSX/VertexShaderDecompiler.hpp>
+
+#include <bit>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+// Decompiles small vertex and fragment programs without a GL context.
+// The shader disk cache stores the GLSL keyed by the hash of the microcode, so the output has to be the same every time the
+// same microcode is decompiled, no matter what the decompiler saw before or which copy of it runs the job.
+
+static int failed = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAILED: %s\n", what);
+        failed++;
+    }
+}
+
+static bool contains(const std::string& shader, const char* str) {
+    if (shader.contains(str)) return true;
+    std::printf("Missing \"%s\" in:\n%s\n", str, shader.c_str());
+    return false;
+}
+
+// Fragment microcode has the halves of each word swapped
+static u32 swapHalves(u32 v) { return (v >> 16) | (v << 16); }
+
+static constexpr u32 IDENTITY_SWIZZLE = (0 << 9) | (1 << 11) | (2 << 13) | (3 << 15);
+static constexpr u32 COND_ALWAYS = (7 << 18) | (0 << 21) | (1 << 23) | (2 << 25) | (3 << 27);   // lt | eq | gt on cc0.xyzw
+
+static void writeFragmentInstr(Memory& mem, u32& addr, u32 opc, u32 input, u32 src0_type, u32 src1_type, bool end) {
+    FragmentInstruction instr;
+    instr.dst.raw = (opc << 24) | (input << 13) | (0xf << 9) | (end ? 1 : 0);   // r0, xyzw
+    instr.src0.raw = COND_ALWAYS | IDENTITY_SWIZZLE | src0_type;
+    instr.src1.raw = IDENTITY_SWIZZLE | src1_type;
+    instr.src2.raw = IDENTITY_SWIZZLE;
+    for (u32 word : { instr.dst.raw, instr.src0.raw, instr.src1.raw, instr.src2.raw }) {
+        mem.write<u32>(addr, swapHalves(word));
+        addr += 4;
+    }
+}
+
+static void writeFragmentConstant(Memory& mem, u32& addr, float x, float y, float z, float w) {
+    for (float f : { x, y, z, w }) {
+        mem.write<u32>(addr, swapHalves(std::bit_cast<u32>(f)));
+        addr += 4;
+    }
+}
+
+static std::string decompileFragment(FragmentShaderDecompiler& decompiler, Memory& mem, u32 addr) {
+    FragmentShader shader(addr, 0x40);  // 32-bit exports
+    shader.getData(mem);
+    return decompiler.decompile(shader);
+}
+
+static void testFragment(Memory& mem, u32 base) {
+    using enum FragmentShaderDecompiler::FRAGMENT_SOURCE_TYPE;
+    FragmentShaderDecompiler decompiler(nullptr);
+
+    // r0 = fs_col0 * { 0.5, 0.25, 1, 2 }; r0 = r0 + fs_col0
+    const u32 prog_a = base;
+    u32 addr = prog_a;
+    writeFragmentInstr(mem, addr, RSXFragment::MUL, 1, INPUT, CONST, false);
+    writeFragmentConstant(mem, addr, 0.5f, 0.25f, 1.0f, 2.0f);
+    writeFragmentInstr(mem, addr, RSXFragment::ADD, 1, TEMP, INPUT, true);
+
+    // r0 = fs_tex0
+    const u32 prog_b = base + 0x100;
+    addr = prog_b;
+    writeFragmentInstr(mem, addr, RSXFragment::MOV, 4, INPUT, TEMP, true);
+
+    const std::string a = decompileFragment(decompiler, mem, prog_a);
+    check(contains(a, "const vec4 const0 = vec4(0.500000f, 0.250000f, 1.000000f, 2.000000f);"), "fragment constant");
+    check(contains(a, "r0 = (fs_col0 * const0);"), "fragment MUL");
+    check(contains(a, "r0 = (r0 + fs_col0);"), "fragment ADD");
+    check(contains(a, "layout (location = 1) in vec4 fs_col0;"), "fragment input");
+    check(contains(a, "out_col0 = r0;"), "fragment export");
+
+    const std::string b = decompileFragment(decompiler, mem, prog_b);
+    check(contains(b, "r0 = fs_tex0;"), "fragment MOV");
+    check(!b.contains("const0") && !b.contains("fs_col0"), "fragment state leaked into the next shader");
+
+    check(decompileFragment(decompiler, mem, prog_a) == a, "fragment output changed when decompiling the same program again");
+    FragmentShaderDecompiler copy = decompiler;
+    check(decompileFragment(copy, mem, prog_a) == a, "fragment output changed on a copy of the decompiler");
+
+    // r0 = fs_col0 + { 3, 4, 5, 6 }, the constant comes after the last instruction
+    const u32 prog_c = base + 0x200;
+    addr = prog_c;
+    writeFragmentInstr(mem, addr, RSXFragment::ADD, 1, INPUT, CONST, true);
+    writeFragmentConstant(mem, addr, 3.0f, 4.0f, 5.0f, 6.0f);
+
+    FragmentShader shader(prog_c, 0x40);
+    shader.getData(mem);
+    check(shader.getCopiedData().size() == 2 * sizeof(FragmentInstruction), "the trailing constant isn't part of the copied program");
+    // The decompiler only looks at the copy, like the shader workers do while the guest keeps writing
+    addr = prog_c + sizeof(FragmentInstruction);
+    writeFragmentConstant(mem, addr, 7.0f, 7.0f, 7.0f, 7.0f);
+    const std::string c = decompiler.decompile(shader);
+    check(contains(c, "const vec4 const0 = vec4(3.000000f, 4.000000f, 5.000000f, 6.000000f);"), "fragment trailing constant");
+    check(contains(c, "r0 = (fs_col0 + const0);"), "fragment ADD with a constant");
+}
+
+static void writeVertexInstr(std::vector<u32>& data, u32 idx, u32 opc, u32 src0_type, u32 input, u32 const_idx, u32 out, bool end) {
+    VertexShaderDecompiler::VertexInstruction instr = {};
+    VertexShaderDecompiler::VertexSource src = { .raw = 0 };
+    src.type = src0_type;
+    src.x = 0; src.y = 1; src.z = 2; src.w = 3;
+    instr.w0.is_output = 1;
+    instr.w1.vector_opc = opc;
+    instr.w1.input_src_idx = input;
+    instr.w1.const_src_idx = const_idx;
+    instr.w1.src0_hi = src.raw >> 9;
+    instr.w2.src0_lo = src.raw & 0x1ff;
+    instr.w3.dst = out;
+    instr.w3.x = 1; instr.w3.y = 1; instr.w3.z = 1; instr.w3.w = 1;
+    instr.w3.end = end;
+    data[idx * 4 + 0] = instr.w0.raw;
+    data[idx * 4 + 1] = instr.w1.raw;
+    data[idx * 4 + 2] = instr.w2.raw;
+    data[idx * 4 + 3] = instr.w3.raw;
+}
+
+static void testVertex() {
+    VertexShaderDecompiler decompiler;
+
+    // fs_pos = vs_pos; fs_col0 = c[5]
+    std::vector<u32> prog_a(512 * 4, 0);
+    writeVertexInstr(prog_a, 0, RSXVertex::VECTOR::MOV, VertexShaderDecompiler::INPUT, 0, 0, 0, false);
+    writeVertexInstr(prog_a, 1, RSXVertex::VECTOR::MOV, VertexShaderDecompiler::CONST, 0, 5, 1, true);
+
+    // Starts at instruction 8: fs_pos = vs_normal
+    std::vector<u32> prog_b(512 * 4, 0);
+    writeVertexInstr(prog_b, 8, RSXVertex::VECTOR::MOV, VertexShaderDecompiler::INPUT, 2, 0, 0, true);
+
+    const std::string a = decompiler.decompile(prog_a.data(), 0);
+    check(contains(a, "fs_pos = vs_pos;"), "vertex MOV from input");
+    check(contains(a, "fs_col0 = c[5];"), "vertex MOV from constant");
+    check(contains(a, "layout (location = 0) in vec4 vs_pos;"), "vertex input");
+    check(contains(a, "layout (location = 1) out vec4 fs_col0;"), "vertex output");
+
+    const std::string b = decompiler.decompile(prog_b.data(), 8);
+    check(contains(b, "fs_pos = vs_normal;"), "vertex start index");
+    check(!b.contains("vs_pos;") && !b.contains("fs_col0"), "vertex state leaked into the next shader");
+
+    check(decompiler.decompile(prog_a.data(), 0) == a, "vertex output changed when decompiling the same program again");
+}
+
+int main() {
+    Memory mem;
+    const auto entry = mem.alloc(64_KB);
+    testFragment(mem, entry->vaddr);
+    testVertex();
+
+    if (failed) {
+        std::printf("%d checks failed\n", failed);
+        return 1;
+    }
+    std::printf("All shaders decompiled as expected\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <RSX/TextureSwizzler.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+// Checks TextureSwizzler against the per-texel implementation it replaced, for every power-of-two size up to 512x512.
+// Run with --benchmark to also time both on 1024x1024 textures.
+
+// The old RSX::swizzleTexture
+static void referenceUnswizzle(const u8* src, u8* dst, u32 width, u32 height, u32 pixel_size) {
+    auto swizzle = [pixel_size](u32 x, u32 y, u32 z, u32 log2_width, u32 log2_height, u32 log2_depth) {
+        u32 offs = 0;
+
+        u32 shift_count = 0;
+        while (log2_width | log2_height | log2_depth) {
+            if (log2_width) {
+                offs |= (x & 0x01) << shift_count;
+                x >>= 1;
+                shift_count++;
+                log2_width--;
+            }
+            if (log2_height) {
+                offs |= (y & 0x01) << shift_count;
+                y >>= 1;
+                shift_count++;
+                log2_height--;
+            }
+            if (log2_depth) {
+                offs |= (z & 0x01) << shift_count;
+                z >>= 1;
+                shift_count++;
+                log2_depth--;
+            }
+        }
+
+        return offs * pixel_size;
+    };
+
+    const u32 log2_width = std::log2(width);
+    const u32 log2_height = std::log2(height);
+
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            const u32 offs = swizzle(x, y, 0, log2_width, log2_height, 0);
+            std::memcpy(&dst[y * width * pixel_size + x * pixel_size], &src[offs], pixel_size);
+        }
+    }
+}
+
+static constexpr u32 pixel_sizes[] = { 1, 2, 4, 8, 16, 3 };
+
+static bool test(TextureSwizzler& swizzler, std::mt19937& rng) {
+    bool ok = true;
+    for (u32 pixel_size : pixel_sizes) {
+        for (u32 width = 1; width <= 512; width *= 2) {
+            for (u32 height = 1; height <= 512; height *= 2) {
+                const size_t size = width * height * pixel_size;
+                std::vector<u8> src(size);
+                for (auto& b : src) b = rng();
+                std::vector<u8> expected(size);
+                std::vector<u8> result(size, 0xcd);
+
+                referenceUnswizzle(src.data(), expected.data(), width, height, pixel_size);
+                swizzler.unswizzle(src.data(), result.data(), width, height, pixel_size);
+                if (expected != result) {
+                    std::printf("%ux%u, %u bytes per texel: mismatch\n", width, height, pixel_size);
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+static void benchmark(TextureSwizzler& swizzler) {
+    constexpr u32 SIZE = 1024;
+    constexpr int RUNS = 20;
+    for (u32 pixel_size : { 1, 2, 4, 8, 16 }) {
+        std::vector<u8> src(SIZE * SIZE * pixel_size, 0x5a);
+        std::vector<u8> dst(src.size());
+
+        auto time = [&](auto&& unswizzle) {
+            double best = 1e9;
+            for (int i = 0; i < RUNS; i++) {
+                const auto start = std::chrono::steady_clock::now();
+                unswizzle(src.data(), dst.data(), SIZE, SIZE, pixel_size);
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        };
+        const double old_ms = time(referenceUnswizzle);
+        const double new_ms = time([&](const u8* s, u8* d, u32 w, u32 h, u32 p) { swizzler.unswizzle(s, d, w, h, p); });
+        std::printf("%ux%u, %2u bytes per texel: old %7.3f ms, new %7.3f ms (%.1fx)\n", SIZE, SIZE, pixel_size, old_ms, new_ms, old_ms / new_ms);
+    }
+}
+
+int main(int argc, char** argv) {
+    TextureSwizzler swizzler;
+    std::mt19937 rng(0x535a);
+
+    if (!test(swizzler, rng)) return 1;
+    std::printf("All sizes matched\n");
+
+    if (argc > 1 && !std::strcmp(argv[1], "--benchmark"))
+        benchmark(swizzler);
+    return 0;
+}